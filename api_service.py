@@ -17,8 +17,8 @@ def query_datasets(q=None):
         SELECT * FROM {table}
         WHERE (title IS NOT NULL AND lower(title) LIKE lower(?))
            OR (description IS NOT NULL AND lower(description) LIKE lower(?))
-           OR (tags IS NOT NULL AND lower(tags) LIKE lower(?))
-           OR (enriched_keywords IS NOT NULL AND lower(enriched_keywords) LIKE lower(?))
+           OR (tags IS NOT NULL AND lower(CAST(tags AS VARCHAR)) LIKE lower(?))
+           OR (enriched_keywords IS NOT NULL AND lower(CAST(enriched_keywords AS VARCHAR)) LIKE lower(?))
            OR (metrics IS NOT NULL AND lower(metrics) LIKE lower(?))
         LIMIT 50
         """
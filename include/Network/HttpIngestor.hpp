@@ -2,8 +2,13 @@
 
 #include <string>
 #include <memory>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <chrono>
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
+#include "core/Payload.hpp"
 #include "core/RingBuffer.hpp"
 
 namespace civic {
@@ -12,23 +17,91 @@ namespace civic {
     namespace net = boost::asio;
     using tcp = net::ip::tcp;
 
+    // Beast body that reads the response straight into a pooled Payload,
+    // which then travels through the RingBuffer as a handle.
+    struct PayloadBody {
+        using value_type = Payload;
+
+        static std::uint64_t size(const value_type& body) { return body.size(); }
+
+        class reader {
+        public:
+            template<bool isRequest, class Fields>
+            reader(http::header<isRequest, Fields>&, value_type& body) : body_(body) {}
+
+            void init(const boost::optional<std::uint64_t>& contentLength, beast::error_code& ec) {
+                if (contentLength) {
+                    body_.reserve(static_cast<size_t>(*contentLength));
+                }
+                ec = {};
+            }
+
+            template<class ConstBufferSequence>
+            std::size_t put(const ConstBufferSequence& buffers, beast::error_code& ec) {
+                std::size_t total = 0;
+                for (auto it = net::buffer_sequence_begin(buffers); it != net::buffer_sequence_end(buffers); ++it) {
+                    net::const_buffer chunk = *it;
+                    body_.append(static_cast<const char*>(chunk.data()), chunk.size());
+                    total += chunk.size();
+                }
+                ec = {};
+                return total;
+            }
+
+            void finish(beast::error_code& ec) { ec = {}; }
+
+        private:
+            value_type& body_;
+        };
+    };
+
+    struct HttpIngestorOptions {
+        size_t pipelineDepth = 4;                       // requests written ahead of responses
+        std::chrono::seconds timeout{30};
+        std::chrono::milliseconds retryDelay{1000};
+        int maxAttempts = 3;                            // per one-shot request
+        size_t maxBodyBytes = 64 * 1024 * 1024;         // larger responses are dropped
+    };
+
+    // Keeps one keep-alive connection per host:port. Requests to the same
+    // endpoint are pipelined on it; the resolved endpoints are cached, and a
+    // dropped connection is reopened and its unanswered requests resent.
     class HttpIngestor {
     public:
-        explicit HttpIngestor(RingBuffer<std::string>& buffer, net::io_context& ioc);
+        explicit HttpIngestor(RingBuffer<Payload>& buffer, net::io_context& ioc,
+                              HttpIngestorOptions options = {});
+        ~HttpIngestor();
 
+        HttpIngestor(const HttpIngestor&) = delete;
+        HttpIngestor& operator=(const HttpIngestor&) = delete;
+
+        // One GET; the response body is pushed into the buffer.
         void fetch(const std::string& host, const std::string& port, const std::string& target);
 
+        // Re-issues the GET on the same connection `interval` after each
+        // response, until stop().
+        void poll(const std::string& host, const std::string& port, const std::string& target,
+                  std::chrono::milliseconds interval = std::chrono::milliseconds(0));
+
+        void stop();
+
+        // Totals since construction, stopped sessions included.
+        size_t responses() const;
+        size_t dropped() const;
+        size_t connectionsOpened() const;
+
     private:
-        void onResolve(beast::error_code ec, tcp::resolver::results_type results);
-        void onConnect(beast::error_code ec, tcp::resolver::results_type::endpoint_type);
-        void onWrite(beast::error_code ec, std::size_t bytes_transferred);
-        void onRead(beast::error_code ec, std::size_t bytes_transferred);
-
-        RingBuffer<std::string>& buffer_;
-        tcp::resolver resolver_;
-        beast::tcp_stream stream_;
-        beast::flat_buffer responseBuffer_;
-        http::request<http::empty_body> req_;
-        http::response<http::string_body> res_;
+        class Session;
+
+        std::shared_ptr<Session> sessionFor(const std::string& host, const std::string& port);
+        template<typename Counter>
+        size_t total(Counter counter) const;
+
+        RingBuffer<Payload>& buffer_;
+        net::io_context& ioc_;
+        HttpIngestorOptions options_;
+        mutable std::mutex mutex_;
+        std::map<std::string, std::shared_ptr<Session>> sessions_;
+        std::vector<std::shared_ptr<Session>> stopped_;  // kept for their counters
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace civic {
+
+    // Read-only private mapping of a whole file, followed by `padding`
+    // readable zero bytes so parsers that over-read (simdjson) can work on
+    // it in place. The slack comes from an anonymous reservation that the
+    // file is mapped over, so it is valid even when the file ends exactly
+    // on a page boundary.
+    class MappedFile {
+    public:
+        static std::optional<MappedFile> open(const std::string& path, size_t padding = 64) {
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) return std::nullopt;
+
+            struct stat st {};
+            if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+                ::close(fd);
+                return std::nullopt;
+            }
+
+            MappedFile file;
+            file.size_ = static_cast<size_t>(st.st_size);
+            file.mtime_ = st.st_mtim;
+            file.mappedLength_ = file.size_ + padding;
+
+            void* base = ::mmap(nullptr, file.mappedLength_, PROT_READ,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (base == MAP_FAILED) {
+                ::close(fd);
+                return std::nullopt;
+            }
+            file.data_ = static_cast<const char*>(base);
+
+            if (file.size_ > 0) {
+                void* mapped = ::mmap(base, file.size_, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+                if (mapped == MAP_FAILED) {
+                    ::close(fd);
+                    return std::nullopt;
+                }
+                ::madvise(base, file.size_, MADV_WILLNEED);
+            }
+            ::close(fd);
+            return file;
+        }
+
+        MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+
+        MappedFile& operator=(MappedFile&& other) noexcept {
+            if (this != &other) {
+                release();
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+                mappedLength_ = std::exchange(other.mappedLength_, 0);
+                mtime_ = other.mtime_;
+            }
+            return *this;
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile() { release(); }
+
+        const char* data() const { return data_; }
+        size_t size() const { return size_; }
+        size_t padding() const { return mappedLength_ - size_; }
+        std::string_view view() const { return {data_, size_}; }
+        const timespec& mtime() const { return mtime_; }
+
+    private:
+        MappedFile() = default;
+
+        void release() {
+            if (data_) {
+                ::munmap(const_cast<char*>(data_), mappedLength_);
+                data_ = nullptr;
+            }
+        }
+
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+        size_t mappedLength_ = 0;
+        timespec mtime_{};
+    };
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace civic {
+
+    // Readable slack kept after every payload so parsers that over-read
+    // (simdjson needs SIMDJSON_PADDING) can work on the bytes in place.
+    constexpr size_t kPayloadPadding = 64;
+
+    namespace detail {
+        struct PayloadPoolState;
+
+        struct alignas(64) PayloadBlock {
+            std::atomic<uint32_t> refs{1};
+            int sizeClass = -1;
+            size_t capacity = 0;
+            size_t size = 0;
+            std::shared_ptr<PayloadPoolState> pool;
+
+            // Bytes live right after the header in the same allocation
+            char* bytes() { return std::launder(reinterpret_cast<char*>(this)) + sizeof(PayloadBlock); }
+        };
+
+        struct PayloadPoolState {
+            static constexpr size_t kMinClassBytes = 256;
+            static constexpr int kNumClasses = 20; // 256 B .. 128 MiB
+
+            std::mutex mutex;
+            std::vector<PayloadBlock*> freeLists[kNumClasses];
+            size_t maxCachedPerClass = 64;
+            bool closed = false;
+            std::atomic<size_t> allocations{0};
+            std::atomic<size_t> reuses{0};
+        };
+
+        inline int sizeClassFor(size_t capacity) {
+            size_t classBytes = PayloadPoolState::kMinClassBytes;
+            for (int k = 0; k < PayloadPoolState::kNumClasses; ++k, classBytes <<= 1) {
+                if (classBytes >= capacity) return k;
+            }
+            return -1;
+        }
+
+        inline PayloadBlock* newBlock(const std::shared_ptr<PayloadPoolState>& pool, int sizeClass, size_t capacity) {
+            void* mem = ::operator new(sizeof(PayloadBlock) + capacity + kPayloadPadding,
+                                       std::align_val_t{alignof(PayloadBlock)});
+            auto* block = new (mem) PayloadBlock();
+            block->sizeClass = sizeClass;
+            block->capacity = capacity;
+            block->pool = pool;
+            std::memset(block->bytes() + capacity, 0, kPayloadPadding);
+            return block;
+        }
+
+        inline void destroyBlock(PayloadBlock* block) {
+            block->~PayloadBlock();
+            ::operator delete(block, std::align_val_t{alignof(PayloadBlock)});
+        }
+
+        inline PayloadBlock* acquireBlock(const std::shared_ptr<PayloadPoolState>& pool, size_t capacity) {
+            int sizeClass = sizeClassFor(capacity);
+            if (!pool || sizeClass < 0) {
+                if (pool) pool->allocations.fetch_add(1, std::memory_order_relaxed);
+                return newBlock(nullptr, -1, capacity);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(pool->mutex);
+                auto& freeList = pool->freeLists[sizeClass];
+                if (!freeList.empty()) {
+                    PayloadBlock* block = freeList.back();
+                    freeList.pop_back();
+                    pool->reuses.fetch_add(1, std::memory_order_relaxed);
+                    return block;
+                }
+            }
+
+            pool->allocations.fetch_add(1, std::memory_order_relaxed);
+            return newBlock(pool, sizeClass, PayloadPoolState::kMinClassBytes << sizeClass);
+        }
+
+        inline void releaseBlock(PayloadBlock* block) {
+            if (block->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                return;
+            }
+
+            if (block->pool && block->sizeClass >= 0) {
+                auto& pool = *block->pool;
+                std::lock_guard<std::mutex> lock(pool.mutex);
+                auto& freeList = pool.freeLists[block->sizeClass];
+                if (!pool.closed && freeList.size() < pool.maxCachedPerClass) {
+                    block->size = 0;
+                    block->refs.store(1, std::memory_order_relaxed);
+                    freeList.push_back(block);
+                    return;
+                }
+            }
+            destroyBlock(block);
+        }
+    }
+
+    // Refcounted handle on a padded byte slab. Copying a Payload shares the
+    // bytes; only a handle holding the sole reference may write into them.
+    class Payload {
+    public:
+        Payload() = default;
+
+        Payload(const Payload& other) noexcept : block_(other.block_) {
+            if (block_) block_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Payload(Payload&& other) noexcept : block_(std::exchange(other.block_, nullptr)) {}
+
+        Payload& operator=(Payload other) noexcept {
+            std::swap(block_, other.block_);
+            return *this;
+        }
+
+        ~Payload() {
+            if (block_) detail::releaseBlock(block_);
+        }
+
+        const char* data() const { return block_ ? block_->bytes() : ""; }
+        char* data() { return block_ ? block_->bytes() : nullptr; }
+        size_t size() const { return block_ ? block_->size : 0; }
+        size_t capacity() const { return block_ ? block_->capacity : 0; }
+        bool empty() const { return size() == 0; }
+        std::string_view view() const { return {data(), size()}; }
+        uint32_t useCount() const { return block_ ? block_->refs.load(std::memory_order_relaxed) : 0; }
+
+        // Grows the slab (from the same pool) keeping the current bytes.
+        void reserve(size_t capacity) {
+            if (capacity <= this->capacity()) return;
+            assert(useCount() <= 1);
+
+            auto pool = block_ ? block_->pool : nullptr;
+            size_t target = std::max(capacity, this->capacity() * 2);
+            detail::PayloadBlock* grown = detail::acquireBlock(pool, target);
+            if (block_) {
+                std::memcpy(grown->bytes(), block_->bytes(), block_->size);
+                grown->size = block_->size;
+                detail::releaseBlock(block_);
+            }
+            block_ = grown;
+        }
+
+        void resize(size_t size) {
+            reserve(size);
+            if (block_) block_->size = size;
+        }
+
+        void append(const char* bytes, size_t count) {
+            if (count == 0) return;
+            size_t offset = size();
+            resize(offset + count);
+            std::memcpy(block_->bytes() + offset, bytes, count);
+        }
+
+    private:
+        friend class PayloadPool;
+        explicit Payload(detail::PayloadBlock* block) : block_(block) {}
+
+        detail::PayloadBlock* block_ = nullptr;
+    };
+
+    // Per-producer arena of power-of-two slabs. Payloads may be released on
+    // any thread and return to the pool's free lists for reuse.
+    class PayloadPool {
+    public:
+        explicit PayloadPool(size_t maxCachedPerClass = 64)
+            : state_(std::make_shared<detail::PayloadPoolState>())
+        {
+            state_->maxCachedPerClass = maxCachedPerClass;
+        }
+
+        ~PayloadPool() {
+            std::vector<detail::PayloadBlock*> cached;
+            {
+                std::lock_guard<std::mutex> lock(state_->mutex);
+                state_->closed = true;
+                for (auto& freeList : state_->freeLists) {
+                    cached.insert(cached.end(), freeList.begin(), freeList.end());
+                    freeList.clear();
+                }
+            }
+            for (auto* block : cached) {
+                detail::destroyBlock(block);
+            }
+        }
+
+        PayloadPool(const PayloadPool&) = delete;
+        PayloadPool& operator=(const PayloadPool&) = delete;
+
+        Payload acquire(size_t capacity) {
+            return Payload(detail::acquireBlock(state_, capacity));
+        }
+
+        Payload copyOf(std::string_view bytes) {
+            Payload payload = acquire(bytes.size());
+            payload.append(bytes.data(), bytes.size());
+            return payload;
+        }
+
+        size_t allocations() const { return state_->allocations.load(std::memory_order_relaxed); }
+        size_t reuses() const { return state_->reuses.load(std::memory_order_relaxed); }
+
+    private:
+        std::shared_ptr<detail::PayloadPoolState> state_;
+    };
+}
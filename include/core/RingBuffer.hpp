@@ -1,84 +1,372 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <vector>
 #include <memory>
 #include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include "core/WaitStrategy.hpp"
 
 namespace civic {
 
-    template<typename T>
-    class RingBuffer {
+    // Topology tags: a Single side is driven by one thread at a time and
+    // advances its cursor with plain stores instead of a CAS loop.
+    struct ProducerPolicy {
+        struct Single {};
+        struct Multi {};
+    };
+
+    struct ConsumerPolicy {
+        struct Single {};
+        struct Multi {};
+    };
+
+    namespace detail {
+        template<typename T, typename... Args>
+        void assignSlot(T& slot, Args&&... args) {
+            if constexpr (sizeof...(Args) == 1 &&
+                          (std::is_same_v<std::decay_t<Args>, T> && ...)) {
+                slot = (std::forward<Args>(args), ...);
+            } else {
+                slot = T(std::forward<Args>(args)...);
+            }
+        }
+
+        // Blocking operations shared by every RingBuffer variant. Consumers
+        // wait on notEmpty_, producers on notFull_; the try_* paths of the
+        // derived class signal the opposite side after each success.
+        template<typename Derived, typename T, typename Wait>
+        class BlockingRing {
+        public:
+            // Blocks until there is room. Returns false if the ring is closed.
+            bool push_wait(T&& data) {
+                bool pushed = false;
+                notFull_.wait([&] {
+                    if (closed()) return true;
+                    pushed = self().push(std::move(data));
+                    return pushed;
+                });
+                return pushed;
+            }
+
+            bool push_wait(const T& data) {
+                T copy(data);
+                return push_wait(std::move(copy));
+            }
+
+            // Blocks until an element is available. Returns false once the
+            // ring is closed and drained.
+            bool pop_wait(T& data) {
+                bool popped = false;
+                notEmpty_.wait([&] {
+                    popped = self().pop(data);
+                    if (!popped && closed()) {
+                        // Re-check after seeing the close so the last pushes are not lost
+                        popped = self().pop(data);
+                        return true;
+                    }
+                    return popped;
+                });
+                return popped;
+            }
+
+            // Waits up to `timeout` for at least one element, then pops up to
+            // `max`. Returns 0 on timeout or when closed and drained.
+            template<typename OutputIt, typename Rep, typename Period>
+            size_t pop_bulk_wait(OutputIt out, size_t max, std::chrono::duration<Rep, Period> timeout) {
+                size_t count = 0;
+                notEmpty_.wait([&] {
+                    count = self().try_pop_bulk(out, max);
+                    if (count == 0 && closed()) {
+                        count = self().try_pop_bulk(out, max);
+                        return true;
+                    }
+                    return count > 0;
+                }, std::chrono::steady_clock::now() + timeout);
+                return count;
+            }
+
+            // Wakes every blocked producer and consumer; pushes fail from
+            // now on while pops keep draining what is left.
+            void close() {
+                closed_.store(true, std::memory_order_seq_cst);
+                notEmpty_.notifyAll();
+                notFull_.notifyAll();
+            }
+
+            bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+        protected:
+            void signalPushed(size_t count) {
+                if (count == 1) notEmpty_.notifyOne();
+                else if (count > 1) notEmpty_.notifyAll();
+            }
+
+            void signalPopped(size_t count) {
+                if (count == 1) notFull_.notifyOne();
+                else if (count > 1) notFull_.notifyAll();
+            }
+
+        private:
+            Derived& self() { return static_cast<Derived&>(*this); }
+
+            [[no_unique_address]] Wait notEmpty_;
+            [[no_unique_address]] Wait notFull_;
+            std::atomic<bool> closed_{false};
+        };
+    }
+
+    template<typename T,
+             typename Producer = ProducerPolicy::Multi,
+             typename Consumer = ConsumerPolicy::Multi,
+             typename Wait = YieldingWait>
+    class RingBuffer : public detail::BlockingRing<RingBuffer<T, Producer, Consumer, Wait>, T, Wait> {
+        static constexpr bool kSingleProducer = std::is_same_v<Producer, ProducerPolicy::Single>;
+        static constexpr bool kSingleConsumer = std::is_same_v<Consumer, ConsumerPolicy::Single>;
+
     public:
-        explicit RingBuffer(size_t bufferSize) 
+        explicit RingBuffer(size_t bufferSize)
             : buffer_(bufferSize), bufferMask_(bufferSize - 1),
               sequence_(new std::atomic<size_t>[bufferSize])
         {
             assert((bufferSize != 0) && ((bufferSize & (bufferSize - 1)) == 0));
-            
+
             for (size_t i = 0; i < bufferSize; ++i) {
                 sequence_[i].store(i, std::memory_order_relaxed);
             }
-            
+
             enqueuePos_.store(0, std::memory_order_relaxed);
             dequeuePos_.store(0, std::memory_order_relaxed);
         }
 
+        size_t capacity() const { return bufferMask_ + 1; }
+
         bool push(const T& data) {
-            size_t pos;
-            while (true) {
-                pos = enqueuePos_.load(std::memory_order_relaxed);
-                size_t seq = sequence_[pos & bufferMask_].load(std::memory_order_acquire);
-                intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            return emplace(data);
+        }
 
-                if (diff == 0) {
-                    if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
-                        break;
-                    }
-                } else if (diff < 0) {
-                    return false;
-                } else {
-                }
+        bool push(T&& data) {
+            return emplace(std::move(data));
+        }
+
+        template<typename... Args>
+        bool emplace(Args&&... args) {
+            size_t pos;
+            if (claim<kSingleProducer>(enqueuePos_, 1, 0, pos) == 0) {
+                return false;
             }
 
-            buffer_[pos & bufferMask_] = data;
+            detail::assignSlot(buffer_[pos & bufferMask_], std::forward<Args>(args)...);
             sequence_[pos & bufferMask_].store(pos + 1, std::memory_order_release);
+            this->signalPushed(1);
             return true;
         }
 
         bool pop(T& data) {
             size_t pos;
+            if (claim<kSingleConsumer>(dequeuePos_, 1, 1, pos) == 0) {
+                return false;
+            }
+
+            data = std::move(buffer_[pos & bufferMask_]);
+            sequence_[pos & bufferMask_].store(pos + bufferMask_ + 1, std::memory_order_release);
+            this->signalPopped(1);
+            return true;
+        }
+
+        // Pushes as many elements of [first, last) as there are free slots,
+        // claiming the whole range with a single CAS. Returns the count pushed.
+        // Pass move iterators to move the elements in.
+        template<typename ForwardIt>
+        size_t try_push_bulk(ForwardIt first, ForwardIt last) {
+            size_t wanted = static_cast<size_t>(std::distance(first, last));
+            size_t pos;
+            size_t count = claim<kSingleProducer>(enqueuePos_, wanted, 0, pos);
+
+            for (size_t i = 0; i < count; ++i, ++first) {
+                buffer_[(pos + i) & bufferMask_] = *first;
+                sequence_[(pos + i) & bufferMask_].store(pos + i + 1, std::memory_order_release);
+            }
+            this->signalPushed(count);
+            return count;
+        }
+
+        // Pops up to `max` elements into `out` with a single CAS.
+        // Returns the count popped.
+        template<typename OutputIt>
+        size_t try_pop_bulk(OutputIt out, size_t max) {
+            size_t pos;
+            size_t count = claim<kSingleConsumer>(dequeuePos_, max, 1, pos);
+
+            for (size_t i = 0; i < count; ++i) {
+                *out++ = std::move(buffer_[(pos + i) & bufferMask_]);
+                sequence_[(pos + i) & bufferMask_].store(pos + i + bufferMask_ + 1, std::memory_order_release);
+            }
+            this->signalPopped(count);
+            return count;
+        }
+
+    private:
+        // Claims up to `wanted` consecutive positions from `cursor`. A slot at
+        // position p is ready when its sequence equals p + `lag` (0 for
+        // producers, 1 for consumers). Returns the number claimed, first in `pos`.
+        template<bool Exclusive>
+        size_t claim(std::atomic<size_t>& cursor, size_t wanted, size_t lag, size_t& pos) {
+            if (wanted > bufferMask_ + 1) {
+                wanted = bufferMask_ + 1;
+            }
+            if (wanted == 0) {
+                return 0;
+            }
+
             while (true) {
-                pos = dequeuePos_.load(std::memory_order_relaxed);
+                pos = cursor.load(std::memory_order_relaxed);
                 size_t seq = sequence_[pos & bufferMask_].load(std::memory_order_acquire);
-                intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+                intptr_t diff = (intptr_t)seq - (intptr_t)(pos + lag);
 
                 if (diff == 0) {
-                    if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
-                        break;
+                    size_t count = 1;
+                    while (count < wanted &&
+                           sequence_[(pos + count) & bufferMask_].load(std::memory_order_acquire) == pos + count + lag) {
+                        ++count;
                     }
-                } else if (diff < 0) {
-                    return false;
-                } else {
+                    if constexpr (Exclusive) {
+                        cursor.store(pos + count, std::memory_order_relaxed);
+                        return count;
+                    } else if (cursor.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+                        return count;
+                    }
+                } else if (diff < 0 || Exclusive) {
+                    return 0;
                 }
             }
+        }
 
-            data = buffer_[pos & bufferMask_];
-            sequence_[pos & bufferMask_].store(pos + bufferMask_ + 1, std::memory_order_release);
+        std::vector<T> buffer_;
+        size_t bufferMask_;
+        std::unique_ptr<std::atomic<size_t>[]> sequence_;
+
+        alignas(64) std::atomic<size_t> enqueuePos_;
+        alignas(64) std::atomic<size_t> dequeuePos_;
+    };
+
+    // Single producer, single consumer: Lamport queue. Each side owns its
+    // index and keeps a cached copy of the other one, so the shared line is
+    // only read again when the cached value says full (or empty).
+    template<typename T, typename Wait>
+    class RingBuffer<T, ProducerPolicy::Single, ConsumerPolicy::Single, Wait>
+        : public detail::BlockingRing<RingBuffer<T, ProducerPolicy::Single, ConsumerPolicy::Single, Wait>, T, Wait> {
+    public:
+        explicit RingBuffer(size_t bufferSize)
+            : buffer_(bufferSize), bufferMask_(bufferSize - 1)
+        {
+            assert((bufferSize != 0) && ((bufferSize & (bufferSize - 1)) == 0));
+        }
+
+        size_t capacity() const { return bufferMask_ + 1; }
+
+        bool push(const T& data) {
+            return emplace(data);
+        }
+
+        bool push(T&& data) {
+            return emplace(std::move(data));
+        }
+
+        template<typename... Args>
+        bool emplace(Args&&... args) {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            if (freeSlots(tail, 1) == 0) {
+                return false;
+            }
+
+            detail::assignSlot(buffer_[tail & bufferMask_], std::forward<Args>(args)...);
+            tail_.store(tail + 1, std::memory_order_release);
+            this->signalPushed(1);
             return true;
         }
 
+        bool pop(T& data) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            if (readySlots(head, 1) == 0) {
+                return false;
+            }
+
+            data = std::move(buffer_[head & bufferMask_]);
+            head_.store(head + 1, std::memory_order_release);
+            this->signalPopped(1);
+            return true;
+        }
+
+        template<typename ForwardIt>
+        size_t try_push_bulk(ForwardIt first, ForwardIt last) {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            size_t count = freeSlots(tail, static_cast<size_t>(std::distance(first, last)));
+
+            for (size_t i = 0; i < count; ++i, ++first) {
+                buffer_[(tail + i) & bufferMask_] = *first;
+            }
+            if (count > 0) {
+                tail_.store(tail + count, std::memory_order_release);
+            }
+            this->signalPushed(count);
+            return count;
+        }
+
+        template<typename OutputIt>
+        size_t try_pop_bulk(OutputIt out, size_t max) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            size_t count = readySlots(head, max);
+
+            for (size_t i = 0; i < count; ++i) {
+                *out++ = std::move(buffer_[(head + i) & bufferMask_]);
+            }
+            if (count > 0) {
+                head_.store(head + count, std::memory_order_release);
+            }
+            this->signalPopped(count);
+            return count;
+        }
+
     private:
-        struct Node {
-            std::atomic<size_t> sequence;
-        };
+        size_t freeSlots(size_t tail, size_t wanted) {
+            size_t free = capacity() - (tail - cachedHead_);
+            if (free < wanted) {
+                cachedHead_ = head_.load(std::memory_order_acquire);
+                free = capacity() - (tail - cachedHead_);
+            }
+            return free < wanted ? free : wanted;
+        }
+
+        size_t readySlots(size_t head, size_t wanted) {
+            size_t ready = cachedTail_ - head;
+            if (ready < wanted) {
+                cachedTail_ = tail_.load(std::memory_order_acquire);
+                ready = cachedTail_ - head;
+            }
+            return ready < wanted ? ready : wanted;
+        }
 
         std::vector<T> buffer_;
         size_t bufferMask_;
-        std::unique_ptr<std::atomic<size_t>[]> sequence_;
-        
-        alignas(64) std::atomic<size_t> enqueuePos_;
-        alignas(64) std::atomic<size_t> dequeuePos_;
+
+        alignas(64) std::atomic<size_t> tail_{0};
+        size_t cachedHead_ = 0;
+
+        alignas(64) std::atomic<size_t> head_{0};
+        size_t cachedTail_ = 0;
     };
-} 
 
+    template<typename T, typename Wait = YieldingWait>
+    using SpscRingBuffer = RingBuffer<T, ProducerPolicy::Single, ConsumerPolicy::Single, Wait>;
+
+    template<typename T, typename Wait = YieldingWait>
+    using SpmcRingBuffer = RingBuffer<T, ProducerPolicy::Single, ConsumerPolicy::Multi, Wait>;
+
+    template<typename T, typename Wait = YieldingWait>
+    using MpscRingBuffer = RingBuffer<T, ProducerPolicy::Multi, ConsumerPolicy::Single, Wait>;
+}
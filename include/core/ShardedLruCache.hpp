@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace civic {
+
+    // LRU cache split into independently locked shards, so concurrent
+    // lookups on different keys rarely contend. Capacity is expressed in
+    // weight units (1 per entry by default) and enforced per shard.
+    template<typename Key, typename Value, typename Hash = std::hash<Key>>
+    class ShardedLruCache {
+    public:
+        explicit ShardedLruCache(size_t capacity, size_t shards = 16)
+            : capacity_(capacity)
+        {
+            size_t count = 1;
+            while (count < shards) count <<= 1;
+            mask_ = count - 1;
+
+            size_t perShard = std::max<size_t>(1, (capacity + count - 1) / count);
+            shards_.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                shards_.push_back(std::make_unique<Shard>());
+                shards_.back()->capacity = perShard;
+            }
+        }
+
+        ShardedLruCache(const ShardedLruCache&) = delete;
+        ShardedLruCache& operator=(const ShardedLruCache&) = delete;
+
+        // Returns a copy and marks the entry as most recently used.
+        std::optional<Value> get(const Key& key) {
+            auto& shard = shardFor(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(key);
+            if (it == shard.index.end()) {
+                misses_.fetch_add(1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return it->second->value;
+        }
+
+        void put(const Key& key, Value value, size_t weight = 1) {
+            auto& shard = shardFor(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(key);
+            if (it != shard.index.end()) {
+                shard.weight -= it->second->weight;
+                it->second->value = std::move(value);
+                it->second->weight = weight;
+                shard.weight += weight;
+                shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            } else {
+                shard.lru.push_front(Node{key, std::move(value), weight});
+                shard.index.emplace(key, shard.lru.begin());
+                shard.weight += weight;
+            }
+
+            // Always keep the entry just inserted, even if it alone exceeds the shard
+            while (shard.weight > shard.capacity && shard.lru.size() > 1) {
+                auto& victim = shard.lru.back();
+                shard.weight -= victim.weight;
+                shard.index.erase(victim.key);
+                shard.lru.pop_back();
+                evictions_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        bool erase(const Key& key) {
+            auto& shard = shardFor(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(key);
+            if (it == shard.index.end()) return false;
+            shard.weight -= it->second->weight;
+            shard.lru.erase(it->second);
+            shard.index.erase(it);
+            return true;
+        }
+
+        void clear() {
+            for (auto& shard : shards_) {
+                std::lock_guard<std::mutex> lock(shard->mutex);
+                shard->lru.clear();
+                shard->index.clear();
+                shard->weight = 0;
+            }
+        }
+
+        // Visits every entry, one shard locked at a time, most recent first.
+        template<typename F>
+        void forEach(F&& visit) const {
+            for (const auto& shard : shards_) {
+                std::lock_guard<std::mutex> lock(shard->mutex);
+                for (const auto& node : shard->lru) {
+                    visit(node.key, node.value);
+                }
+            }
+        }
+
+        size_t size() const {
+            size_t total = 0;
+            for (const auto& shard : shards_) {
+                std::lock_guard<std::mutex> lock(shard->mutex);
+                total += shard->lru.size();
+            }
+            return total;
+        }
+
+        size_t weight() const {
+            size_t total = 0;
+            for (const auto& shard : shards_) {
+                std::lock_guard<std::mutex> lock(shard->mutex);
+                total += shard->weight;
+            }
+            return total;
+        }
+
+        size_t capacity() const { return capacity_; }
+        size_t shardCount() const { return shards_.size(); }
+        size_t hits() const { return hits_.load(std::memory_order_relaxed); }
+        size_t misses() const { return misses_.load(std::memory_order_relaxed); }
+        size_t evictions() const { return evictions_.load(std::memory_order_relaxed); }
+
+    private:
+        struct Node {
+            Key key;
+            Value value;
+            size_t weight;
+        };
+
+        struct alignas(64) Shard {
+            mutable std::mutex mutex;
+            std::list<Node> lru;
+            std::unordered_map<Key, typename std::list<Node>::iterator, Hash> index;
+            size_t weight = 0;
+            size_t capacity = 0;
+        };
+
+        Shard& shardFor(const Key& key) {
+            // The map inside the shard uses the low bits: pick the shard
+            // from the high bits of a mixed hash so both stay spread out
+            uint64_t h = static_cast<uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ull;
+            return *shards_[(h >> 32) & mask_];
+        }
+
+        std::vector<std::unique_ptr<Shard>> shards_;
+        size_t mask_ = 0;
+        size_t capacity_;
+        std::atomic<size_t> hits_{0};
+        std::atomic<size_t> misses_{0};
+        std::atomic<size_t> evictions_{0};
+    };
+}
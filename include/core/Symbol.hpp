@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace civic {
+
+    // Interned, immutable string. Equal contents share a single copy in a
+    // process-wide table, so a Symbol is one pointer: copying, hashing and
+    // comparing two symbols never touch the characters. Interned strings
+    // are never freed; use it for low-cardinality values (organisations,
+    // mime types, licences), not for user-entered or free text.
+    class Symbol {
+    public:
+        Symbol() : value_(&emptyString()) {}
+        Symbol(std::string_view text) : value_(intern(text)) {}
+        Symbol(const std::string& text) : Symbol(std::string_view(text)) {}
+        Symbol(const char* text) : Symbol(std::string_view(text)) {}
+
+        const std::string& str() const { return *value_; }
+        std::string_view view() const { return *value_; }
+        operator const std::string&() const { return *value_; }
+
+        bool empty() const { return value_->empty(); }
+        size_t size() const { return value_->size(); }
+        const char* data() const { return value_->data(); }
+        const char* c_str() const { return value_->c_str(); }
+        size_t find(std::string_view needle, size_t pos = 0) const { return value_->find(needle, pos); }
+
+        friend bool operator==(const Symbol& a, const Symbol& b) { return a.value_ == b.value_; }
+        friend bool operator==(const Symbol& a, const std::string& b) { return *a.value_ == b; }
+        friend bool operator==(const Symbol& a, std::string_view b) { return *a.value_ == b; }
+        friend bool operator==(const Symbol& a, const char* b) { return *a.value_ == b; }
+        friend bool operator<(const Symbol& a, const Symbol& b) { return *a.value_ < *b.value_; }
+
+        friend std::ostream& operator<<(std::ostream& out, const Symbol& symbol) { return out << *symbol.value_; }
+
+        // Number of distinct strings interned so far.
+        static size_t tableSize() {
+            size_t total = 0;
+            for (auto& shard : table().shards) {
+                std::shared_lock lock(shard.mutex);
+                total += shard.strings.size();
+            }
+            return total;
+        }
+
+    private:
+        struct Hash {
+            using is_transparent = void;
+            size_t operator()(std::string_view text) const { return std::hash<std::string_view>{}(text); }
+        };
+
+        struct Equal {
+            using is_transparent = void;
+            bool operator()(std::string_view a, std::string_view b) const { return a == b; }
+        };
+
+        // Node-based set: element addresses stay valid across rehashes
+        struct Shard {
+            std::shared_mutex mutex;
+            std::unordered_set<std::string, Hash, Equal> strings;
+        };
+
+        struct Table {
+            static constexpr size_t shardCount = 16;
+            Shard shards[shardCount];
+        };
+
+        static Table& table() {
+            static Table instance;
+            return instance;
+        }
+
+        static const std::string& emptyString() {
+            static const std::string empty;
+            return empty;
+        }
+
+        static const std::string* intern(std::string_view text) {
+            if (text.empty()) return &emptyString();
+
+            auto& shard = table().shards[Hash{}(text) % Table::shardCount];
+            {
+                std::shared_lock lock(shard.mutex);
+                auto it = shard.strings.find(text);
+                if (it != shard.strings.end()) return &*it;
+            }
+            std::unique_lock lock(shard.mutex);
+            return &*shard.strings.emplace(text).first;
+        }
+
+        const std::string* value_;
+    };
+}
+
+template<>
+struct std::hash<civic::Symbol> {
+    size_t operator()(const civic::Symbol& symbol) const noexcept {
+        return std::hash<const void*>{}(symbol.data());
+    }
+};
@@ -6,19 +6,334 @@
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
-#include <queue>
+#include <stop_token>
+#include <deque>
+#include <future>
+#include <memory>
+#include <new>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace civic {
 
+    // Pins the calling thread to one CPU. Returns false where unsupported
+    // or when the CPU does not exist.
+    inline bool pinCurrentThread(unsigned cpu) {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpu;
+        return false;
+#endif
+    }
+
+    // Physical package (socket) of a CPU as reported by sysfs, -1 if unknown.
+    inline int cpuSocket(unsigned cpu) {
+        std::ifstream in("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/physical_package_id");
+        int socket = -1;
+        return (in >> socket) ? socket : -1;
+    }
+
+    // CPUs this process may run on, in id order. Read from the affinity
+    // mask, so offline CPUs and those outside the cgroup cpuset are left
+    // out; ids need not be contiguous.
+    inline std::vector<unsigned> allowedCpus() {
+        std::vector<unsigned> cpus;
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+            }
+        }
+#endif
+        if (cpus.empty()) {
+            cpus.resize(std::max(1u, std::thread::hardware_concurrency()));
+            for (unsigned cpu = 0; cpu < cpus.size(); ++cpu) cpus[cpu] = cpu;
+        }
+        return cpus;
+    }
+
+    // allowedCpus(), those sharing the first one's socket first, then the
+    // other sockets in order. CPU ids are often interleaved across sockets,
+    // so contiguous ids say nothing about locality. Unknown topology keeps
+    // id order.
+    inline std::vector<unsigned> cpusBySocket() {
+        auto cpus = allowedCpus();
+        int homeSocket = cpuSocket(cpus.front());
+
+        std::vector<std::pair<int, unsigned>> keyed;
+        keyed.reserve(cpus.size());
+        for (unsigned cpu : cpus) {
+            int socket = cpuSocket(cpu);
+            keyed.emplace_back(socket == homeSocket ? -1 : socket, cpu);
+        }
+        std::stable_sort(keyed.begin(), keyed.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        for (size_t i = 0; i < keyed.size(); ++i) cpus[i] = keyed[i].second;
+        return cpus;
+    }
+
+    struct ServiceOptions {
+        int cpu = -1; // pin the service thread to this CPU, -1 to leave it floating
+    };
+
+    namespace detail {
+
+        // Type-erased task. Callables up to kInlineBytes live inside the node,
+        // larger ones fall back to the heap. Nodes are recycled, see TaskNodeCache.
+        struct TaskNode {
+            static constexpr size_t kInlineBytes = 48;
+
+            void (*invoke)(TaskNode*) = nullptr;  // runs, then destroys the callable
+            void (*destroy)(TaskNode*) = nullptr; // destroys without running
+            alignas(std::max_align_t) unsigned char storage[kInlineBytes];
+
+            template<typename F>
+            void set(F&& f) {
+                using Fn = std::decay_t<F>;
+                if constexpr (sizeof(Fn) <= kInlineBytes && alignof(Fn) <= alignof(std::max_align_t)) {
+                    new (storage) Fn(std::forward<F>(f));
+                    invoke = [](TaskNode* node) {
+                        Fn* fn = std::launder(reinterpret_cast<Fn*>(node->storage));
+                        struct Guard { Fn* fn; ~Guard() { fn->~Fn(); } } guard{fn};
+                        (*fn)();
+                    };
+                    destroy = [](TaskNode* node) {
+                        std::launder(reinterpret_cast<Fn*>(node->storage))->~Fn();
+                    };
+                } else {
+                    new (storage) Fn*(new Fn(std::forward<F>(f)));
+                    invoke = [](TaskNode* node) {
+                        std::unique_ptr<Fn> fn(*std::launder(reinterpret_cast<Fn**>(node->storage)));
+                        (*fn)();
+                    };
+                    destroy = [](TaskNode* node) {
+                        delete *std::launder(reinterpret_cast<Fn**>(node->storage));
+                    };
+                }
+            }
+        };
+
+        // Nodes are allocated by the submitting thread and recycled by the
+        // worker that ran them. Each thread keeps a small local cache and
+        // trades batches with a shared freelist, so nodes freed on workers
+        // flow back to external submitters instead of piling up.
+        struct SharedTaskNodes {
+            static constexpr size_t kMaxCached = 4096;
+            std::mutex mutex;
+            std::vector<TaskNode*> nodes;
+
+            ~SharedTaskNodes() {
+                for (auto* node : nodes) delete node;
+            }
+        };
+
+        inline SharedTaskNodes& sharedTaskNodes() {
+            static SharedTaskNodes shared;
+            return shared;
+        }
+
+        struct TaskNodeCache {
+            static constexpr size_t kMaxCached = 128;
+            static constexpr size_t kBatch = 64;
+            std::vector<TaskNode*> nodes;
+
+            ~TaskNodeCache() {
+                for (auto* node : nodes) delete node;
+            }
+        };
+
+        inline TaskNodeCache& taskNodeCache() {
+            thread_local TaskNodeCache cache;
+            return cache;
+        }
+
+        template<typename F>
+        TaskNode* makeTaskNode(F&& f) {
+            auto& cache = taskNodeCache();
+            if (cache.nodes.empty()) {
+                auto& shared = sharedTaskNodes();
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                size_t take = std::min(shared.nodes.size(), TaskNodeCache::kBatch);
+                cache.nodes.insert(cache.nodes.end(), shared.nodes.end() - take, shared.nodes.end());
+                shared.nodes.resize(shared.nodes.size() - take);
+            }
+
+            TaskNode* node;
+            if (!cache.nodes.empty()) {
+                node = cache.nodes.back();
+                cache.nodes.pop_back();
+            } else {
+                node = new TaskNode();
+            }
+            try {
+                node->set(std::forward<F>(f));
+            } catch (...) {
+                delete node;
+                throw;
+            }
+            return node;
+        }
+
+        inline void recycleTaskNode(TaskNode* node) {
+            auto& cache = taskNodeCache();
+            cache.nodes.push_back(node);
+            if (cache.nodes.size() < TaskNodeCache::kMaxCached) {
+                return;
+            }
+
+            auto spill = cache.nodes.end() - TaskNodeCache::kBatch;
+            {
+                auto& shared = sharedTaskNodes();
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                size_t room = SharedTaskNodes::kMaxCached - std::min(shared.nodes.size(), SharedTaskNodes::kMaxCached);
+                auto kept = spill + std::min<size_t>(room, TaskNodeCache::kBatch);
+                shared.nodes.insert(shared.nodes.end(), spill, kept);
+                spill = kept;
+            }
+            for (auto it = spill; it != cache.nodes.end(); ++it) delete *it;
+            cache.nodes.resize(cache.nodes.size() - TaskNodeCache::kBatch);
+        }
+
+        // Chase-Lev work-stealing deque (Lê et al., "Correct and Efficient
+        // Work-Stealing for Weak Memory Models"). The owner pushes and pops at
+        // the bottom, thieves steal from the top. Outgrown arrays are kept
+        // until destruction since a thief may still be reading one.
+        template<typename T>
+        class WorkStealingDeque {
+            static_assert(std::is_pointer_v<T>, "WorkStealingDeque stores pointers");
+
+            struct Array {
+                explicit Array(int64_t capacity)
+                    : capacity(capacity), mask(capacity - 1), slots(new std::atomic<T>[capacity]) {}
+
+                T get(int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+                void put(int64_t i, T value) { slots[i & mask].store(value, std::memory_order_relaxed); }
+
+                int64_t capacity;
+                int64_t mask;
+                std::unique_ptr<std::atomic<T>[]> slots;
+            };
+
+        public:
+            explicit WorkStealingDeque(int64_t capacity = 256) {
+                arrays_.push_back(std::make_unique<Array>(capacity));
+                array_.store(arrays_.back().get(), std::memory_order_relaxed);
+            }
+
+            WorkStealingDeque(const WorkStealingDeque&) = delete;
+            WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+            void push(T value) {
+                int64_t b = bottom_.load(std::memory_order_relaxed);
+                int64_t t = top_.load(std::memory_order_acquire);
+                Array* a = array_.load(std::memory_order_relaxed);
+                if (b - t > a->capacity - 1) {
+                    a = grow(a, t, b);
+                }
+                a->put(b, value);
+                std::atomic_thread_fence(std::memory_order_release);
+                bottom_.store(b + 1, std::memory_order_relaxed);
+            }
+
+            T pop() {
+                int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+                Array* a = array_.load(std::memory_order_relaxed);
+                bottom_.store(b, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t t = top_.load(std::memory_order_relaxed);
+
+                if (t > b) {
+                    bottom_.store(b + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                T value = a->get(b);
+                if (t == b) {
+                    // Last element: race the thieves for it
+                    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                        value = nullptr;
+                    }
+                    bottom_.store(b + 1, std::memory_order_relaxed);
+                }
+                return value;
+            }
+
+            T steal() {
+                int64_t t = top_.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t b = bottom_.load(std::memory_order_acquire);
+
+                if (t >= b) {
+                    return nullptr;
+                }
+
+                Array* a = array_.load(std::memory_order_acquire);
+                T value = a->get(t);
+                if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    return nullptr;
+                }
+                return value;
+            }
+
+            bool empty() const {
+                return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+            }
+
+        private:
+            Array* grow(Array* old, int64_t t, int64_t b) {
+                auto grown = std::make_unique<Array>(old->capacity * 2);
+                for (int64_t i = t; i < b; ++i) {
+                    grown->put(i, old->get(i));
+                }
+                arrays_.push_back(std::move(grown));
+                array_.store(arrays_.back().get(), std::memory_order_release);
+                return arrays_.back().get();
+            }
+
+            alignas(64) std::atomic<int64_t> top_{0};
+            alignas(64) std::atomic<int64_t> bottom_{0};
+            std::atomic<Array*> array_;
+            std::vector<std::unique_ptr<Array>> arrays_;
+        };
+    }
+
+    // Work-stealing pool: each worker owns a Chase-Lev deque, tasks submitted
+    // from a worker go to its own deque, the others go through a shared
+    // injection queue. Idle workers steal, then sleep. Long-running loops
+    // (queue consumers) run as services on their own threads next to it.
     class ThreadPool {
     public:
-        explicit ThreadPool(size_t numThreads = std::thread::hardware_concurrency()) 
-            : stop_(false) 
+        explicit ThreadPool(size_t numThreads = std::thread::hardware_concurrency())
+            : stop_(false)
         {
+            numThreads = std::max<size_t>(1, numThreads);
+            queues_.reserve(numThreads);
+            for (size_t i = 0; i < numThreads; ++i) {
+                queues_.push_back(std::make_unique<detail::WorkStealingDeque<detail::TaskNode*>>());
+            }
+
             workers_.reserve(numThreads);
             for (size_t i = 0; i < numThreads; ++i) {
-                workers_.emplace_back([this] {
-                    this->workerLoop();
+                workers_.emplace_back([this, i] {
+                    this->workerLoop(i);
                 });
             }
         }
@@ -27,7 +342,16 @@ namespace civic {
             stop();
         }
 
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        size_t size() const { return queues_.size(); }
+
+        // Services are asked to stop and joined first, then workers exit
+        // after their current task; tasks still queued are dropped (their
+        // futures report broken_promise).
         void stop() {
+            stopServices();
             {
                 std::lock_guard<std::mutex> lock(mutex_);
                 stop_ = true;
@@ -38,55 +362,262 @@ namespace civic {
                     worker.join();
                 }
             }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& queue : queues_) {
+                while (detail::TaskNode* node = queue->pop()) discard(node);
+            }
+            for (auto* node : injected_) discard(node);
+            injected_.clear();
+        }
+
+        template<typename F>
+        void enqueue(F&& task) {
+            schedule(detail::makeTaskNode(std::forward<F>(task)));
+        }
+
+        template<typename F, typename... Args>
+        auto submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
+            using R = std::invoke_result_t<F, Args...>;
+            std::packaged_task<R()> task(
+                [f = std::forward<F>(f), ...args = std::forward<Args>(args)]() mutable {
+                    return std::invoke(std::move(f), std::move(args)...);
+                });
+            auto future = task.get_future();
+            enqueue(std::move(task));
+            return future;
+        }
+
+        // Calls body(i) for every i in [first, last). The calling thread
+        // takes part in the loop; exceptions are rethrown here.
+        template<typename F>
+        void parallel_for(size_t first, size_t last, F&& body, size_t grain = 0) {
+            if (first >= last) return;
+            size_t n = last - first;
+            grain = grainFor(n, grain);
+
+            runChunks((n + grain - 1) / grain, [&](size_t chunk) {
+                size_t begin = first + chunk * grain;
+                size_t end = std::min(last, begin + grain);
+                for (size_t i = begin; i < end; ++i) {
+                    body(i);
+                }
+            });
+        }
+
+        // Folds map(i) over [first, last) with reduce. Partial results are
+        // combined in index order, so reduce only needs to be associative.
+        template<typename T, typename Map, typename Reduce>
+        T parallel_reduce(size_t first, size_t last, T identity, Map&& map, Reduce&& reduce, size_t grain = 0) {
+            if (first >= last) return identity;
+            size_t n = last - first;
+            grain = grainFor(n, grain);
+            size_t chunks = (n + grain - 1) / grain;
+
+            std::vector<T> partials(chunks, identity);
+            runChunks(chunks, [&](size_t chunk) {
+                size_t begin = first + chunk * grain;
+                size_t end = std::min(last, begin + grain);
+                T acc = identity;
+                for (size_t i = begin; i < end; ++i) {
+                    acc = reduce(std::move(acc), map(i));
+                }
+                partials[chunk] = std::move(acc);
+            });
+
+            T result = std::move(identity);
+            for (auto& partial : partials) {
+                result = reduce(std::move(result), std::move(partial));
+            }
+            return result;
+        }
+
+        // Runs body on a dedicated thread until it returns. The token is
+        // triggered by stopServices()/stop(); the body is expected to poll it
+        // (or register a std::stop_callback that unblocks it).
+        void startService(std::function<void(std::stop_token)> body, ServiceOptions options = {}) {
+            std::lock_guard<std::mutex> lock(servicesMutex_);
+            services_.emplace_back([body = std::move(body), cpu = options.cpu](std::stop_token token) {
+                if (cpu >= 0) {
+                    pinCurrentThread(static_cast<unsigned>(cpu));
+                }
+                body(token);
+            });
         }
 
-        void enqueue(std::function<void()> task) {
+        void stopServices() {
+            std::vector<std::jthread> services;
             {
-                std::lock_guard<std::mutex> lock(mutex_);
-                tasks_.push(std::move(task));
+                std::lock_guard<std::mutex> lock(servicesMutex_);
+                services.swap(services_);
+            }
+            for (auto& service : services) {
+                service.request_stop();
+            }
+            for (auto& service : services) {
+                if (service.joinable()) {
+                    service.join();
+                }
             }
-            cv_.notify_one();
         }
 
-        // Set a repeating task for all workers to execute continuously
-        void setTask(std::function<void()> task) {
-            task_ = std::move(task);
-            cv_.notify_all();
+        size_t serviceCount() const {
+            std::lock_guard<std::mutex> lock(servicesMutex_);
+            return services_.size();
         }
 
     private:
-        void workerLoop() {
-            while (true) {
-                std::function<void()> task;
-                {
-                    std::unique_lock<std::mutex> lock(mutex_);
-                    cv_.wait(lock, [this] {
-                        return stop_ || !tasks_.empty() || task_;
-                    });
-                    
-                    // Exit if stopped
-                    if (stop_) {
-                        return;
+        struct WorkerSlot {
+            ThreadPool* pool = nullptr;
+            size_t index = 0;
+        };
+
+        static WorkerSlot& currentWorker() {
+            thread_local WorkerSlot slot;
+            return slot;
+        }
+
+        static void discard(detail::TaskNode* node) {
+            node->destroy(node);
+            delete node;
+        }
+
+        static void run(detail::TaskNode* node) {
+            node->invoke(node);
+            detail::recycleTaskNode(node);
+        }
+
+        size_t grainFor(size_t n, size_t grain) const {
+            if (grain > 0) return grain;
+            return std::max<size_t>(1, n / (size() * 4));
+        }
+
+        void schedule(detail::TaskNode* node) {
+            auto& worker = currentWorker();
+            if (worker.pool == this) {
+                queues_[worker.index]->push(node);
+            } else {
+                std::lock_guard<std::mutex> lock(mutex_);
+                injected_.push_back(node);
+                injectedEmpty_.store(false, std::memory_order_release);
+            }
+
+            queued_.fetch_add(1, std::memory_order_seq_cst);
+            if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+                { std::lock_guard<std::mutex> lock(mutex_); }
+                cv_.notify_one();
+            }
+        }
+
+        detail::TaskNode* findTask(size_t index) {
+            detail::TaskNode* node = queues_[index]->pop();
+
+            if (!node && !injectedEmpty_.load(std::memory_order_acquire)) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!injected_.empty()) {
+                    node = injected_.front();
+                    injected_.pop_front();
+                }
+                injectedEmpty_.store(injected_.empty(), std::memory_order_release);
+            }
+
+            for (size_t i = 1; !node && i < queues_.size(); ++i) {
+                node = queues_[(index + i) % queues_.size()]->steal();
+            }
+
+            if (node) {
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+            }
+            return node;
+        }
+
+        template<typename Fn>
+        void runChunks(size_t chunks, Fn&& fn) {
+            struct State {
+                std::atomic<size_t> next{0};
+                std::atomic<size_t> done{0};
+                size_t chunks = 0;
+                std::remove_reference_t<Fn>* fn = nullptr;
+                std::mutex errorMutex;
+                std::exception_ptr error;
+            };
+
+            auto state = std::make_shared<State>();
+            state->chunks = chunks;
+            state->fn = &fn;
+
+            auto work = [state]() {
+                size_t chunk;
+                while ((chunk = state->next.fetch_add(1, std::memory_order_relaxed)) < state->chunks) {
+                    try {
+                        (*state->fn)(chunk);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(state->errorMutex);
+                        if (!state->error) state->error = std::current_exception();
                     }
-                    
-                    if (!tasks_.empty()) {
-                        task = std::move(tasks_.front());
-                        tasks_.pop();
-                    } else if (task_) {
-                        task = task_;
+                    if (state->done.fetch_add(1, std::memory_order_acq_rel) + 1 == state->chunks) {
+                        state->done.notify_all();
                     }
                 }
-                if (task) {
-                    task();
+            };
+
+            size_t helpers = std::min(size(), chunks) - 1;
+            for (size_t i = 0; i < helpers; ++i) {
+                enqueue(work);
+            }
+            work();
+
+            size_t done;
+            while ((done = state->done.load(std::memory_order_acquire)) < chunks) {
+                state->done.wait(done, std::memory_order_acquire);
+            }
+            if (state->error) {
+                std::rethrow_exception(state->error);
+            }
+        }
+
+        void workerLoop(size_t index) {
+            currentWorker() = WorkerSlot{this, index};
+            constexpr int kIdleRounds = 64;
+
+            int idle = 0;
+            while (true) {
+                if (stop_.load(std::memory_order_acquire)) {
+                    return;
+                }
+
+                if (detail::TaskNode* node = findTask(index)) {
+                    run(node);
+                    idle = 0;
+                    continue;
                 }
+
+                if (++idle < kIdleRounds) {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(mutex_);
+                sleepers_.fetch_add(1, std::memory_order_seq_cst);
+                cv_.wait(lock, [this] {
+                    return stop_.load(std::memory_order_relaxed) ||
+                           queued_.load(std::memory_order_seq_cst) > 0;
+                });
+                sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                idle = 0;
             }
         }
 
+        std::vector<std::unique_ptr<detail::WorkStealingDeque<detail::TaskNode*>>> queues_;
         std::vector<std::thread> workers_;
-        std::queue<std::function<void()>> tasks_;
-        std::function<void()> task_; 
+        std::deque<detail::TaskNode*> injected_;
+        std::atomic<bool> injectedEmpty_{true};
+        std::atomic<int64_t> queued_{0};
+        std::atomic<size_t> sleepers_{0};
         std::mutex mutex_;
         std::condition_variable cv_;
-        bool stop_;
+        std::atomic<bool> stop_;
+        std::vector<std::jthread> services_;
+        mutable std::mutex servicesMutex_;
     };
-}
\ No newline at end of file
+}
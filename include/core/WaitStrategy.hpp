@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace civic {
+
+    // A wait strategy blocks until `ready()` returns true or `deadline`
+    // passes (wait returns false then). notifyOne/notifyAll are called by the
+    // other side of the queue after it publishes or frees slots.
+    using WaitDeadline = std::chrono::steady_clock::time_point;
+
+    inline void cpuRelax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    namespace detail {
+        inline bool expired(WaitDeadline deadline, uint32_t spins) {
+            // Reading the clock costs more than a pause; only check every 64 spins
+            return deadline != WaitDeadline::max() && (spins & 63) == 0 &&
+                   std::chrono::steady_clock::now() >= deadline;
+        }
+    }
+
+    // Lowest latency, burns a full core while waiting.
+    struct BusySpinWait {
+        template<typename Ready>
+        bool wait(Ready&& ready, WaitDeadline deadline = WaitDeadline::max()) {
+            for (uint32_t spins = 1; !ready(); ++spins) {
+                if (detail::expired(deadline, spins)) return ready();
+                cpuRelax();
+            }
+            return true;
+        }
+
+        void notifyOne() {}
+        void notifyAll() {}
+    };
+
+    // Spins briefly, then yields the core between checks.
+    struct YieldingWait {
+        static constexpr uint32_t kSpins = 128;
+
+        template<typename Ready>
+        bool wait(Ready&& ready, WaitDeadline deadline = WaitDeadline::max()) {
+            for (uint32_t spins = 1; !ready(); ++spins) {
+                if (detail::expired(deadline, spins)) return ready();
+                if (spins < kSpins) {
+                    cpuRelax();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            return true;
+        }
+
+        void notifyOne() {}
+        void notifyAll() {}
+    };
+
+    // Spins, yields, then parks on a condition variable (a futex on Linux).
+    // Eventcount: a waiter registers and reads the epoch, checks ready()
+    // without holding the lock, and only sleeps if the epoch has not moved
+    // since. ready() may push or pop and so notify the opposite wait object;
+    // running it outside mutex_ keeps the two locks from ever nesting. The
+    // notifying side only takes the lock when someone is registered, so the
+    // hot path costs a fence and a load when nobody sleeps.
+    class ParkingWait {
+    public:
+        static constexpr uint32_t kSpins = 128;
+        static constexpr uint32_t kYields = 16;
+
+        template<typename Ready>
+        bool wait(Ready&& ready, WaitDeadline deadline = WaitDeadline::max()) {
+            for (uint32_t spins = 1; spins < kSpins + kYields; ++spins) {
+                if (ready()) return true;
+                if (detail::expired(deadline, spins)) return ready();
+                if (spins < kSpins) {
+                    cpuRelax();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+
+            waiters_.fetch_add(1, std::memory_order_seq_cst);
+            bool satisfied = true;
+            for (;;) {
+                // prepare_wait: the epoch read before the check is the one we sleep on
+                uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+                if (ready()) break;
+
+                // commit_wait: a notify after the check has moved the epoch
+                std::unique_lock<std::mutex> lock(mutex_);
+                auto moved = [&] { return epoch_.load(std::memory_order_relaxed) != epoch; };
+                if (deadline == WaitDeadline::max()) {
+                    cv_.wait(lock, moved);
+                } else if (!cv_.wait_until(lock, deadline, moved)) {
+                    lock.unlock();
+                    satisfied = ready();
+                    break;
+                }
+            }
+
+            waiters_.fetch_sub(1, std::memory_order_relaxed);
+            return satisfied;
+        }
+
+        void notifyOne() { notify(false); }
+        void notifyAll() { notify(true); }
+
+        size_t parked() const { return waiters_.load(std::memory_order_relaxed); }
+
+    private:
+        void notify(bool all) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters_.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                epoch_.fetch_add(1, std::memory_order_seq_cst);
+            }
+            if (all) {
+                cv_.notify_all();
+            } else {
+                cv_.notify_one();
+            }
+        }
+
+        std::atomic<size_t> waiters_{0};
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::atomic<uint64_t> epoch_{0};
+    };
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "data/StorageEngine.hpp"
+
+namespace civic {
+
+    struct CatalogImportOptions {
+        std::string table = "datasets_enriched";
+        size_t chunkRows = 2048;    // rows per work item handed to a writer
+        size_t writers = 0;         // 0: one per pool thread
+        ThreadPool* pool = nullptr; // null: a pool for this import only
+        size_t maxStructFields = 64; // wider objects are kept as JSON text
+        // Columns loaded as real LIST / STRUCT values; other arrays and
+        // objects are stored as their JSON text in a VARCHAR column
+        std::vector<std::string> nestedColumns = {"tags", "resources", "enriched_keywords"};
+    };
+
+    struct CatalogImportResult {
+        bool ok = false;
+        size_t rows = 0;
+        size_t columns = 0;
+    };
+
+    // Loads a JSON array of datasets (data_enriched.json) into a typed DuckDB
+    // table. The column types are inferred from every row, and rows are
+    // appended in parallel chunks on a ThreadPool, each writer on its own
+    // connection and Appender, into a staging table that replaces the live
+    // one only if every writer succeeded. Row order is not preserved.
+    class CatalogImporter {
+    public:
+        // Column type inferred from the catalog.
+        struct ColumnType {
+            enum class Kind { Null, Boolean, BigInt, Double, Varchar, List, Struct };
+
+            Kind kind = Kind::Null;
+            std::vector<ColumnType> children;  // List: element type; Struct: one per field
+            std::vector<std::string> fields;   // Struct field names
+
+            std::string sql() const;
+        };
+
+        explicit CatalogImporter(StorageEngine& engine);
+
+        CatalogImportResult importFile(const std::string& path, const CatalogImportOptions& options = {});
+        CatalogImportResult importJson(std::string_view json, const CatalogImportOptions& options = {});
+
+        // CREATE TABLE statement of the last import.
+        const std::string& createStatement() const { return createStatement_; }
+
+    private:
+        CatalogImportResult importPadded(std::string_view json, const CatalogImportOptions& options);
+
+        StorageEngine& engine_;
+        std::string createStatement_;
+    };
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <duckdb.hpp>
+#include <simdjson.h>
+
+namespace civic {
+
+    // Typed column fed from a JSON pointer (RFC 6901, e.g. "/resource/size").
+    // Missing values, and values that do not fit the column, are stored as NULL.
+    struct ExtractedColumn {
+        enum class Kind { Varchar, BigInt, Double, Boolean, Timestamp, Enum };
+
+        std::string name;
+        std::string pointer;
+        Kind kind = Kind::Varchar;
+        std::vector<std::string> enumValues;  // Enum only
+
+        std::string sql() const;
+    };
+
+    // Projection of the payloads whose top-level "type" equals `type`: writers
+    // store them in `table` (ingest_ts, the columns, then raw_data if kept)
+    // instead of ingest_logs, so analytic queries read columns, not JSON.
+    struct ExtractionSpec {
+        std::string type;
+        std::string table;
+        std::vector<ExtractedColumn> columns;
+        bool keepRaw = false;
+
+        std::string createStatement() const;
+        void appendRow(duckdb::Appender& appender, duckdb::timestamp_t ts,
+                       simdjson::dom::element document, std::string_view raw) const;
+    };
+}
@@ -1,26 +1,178 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <duckdb.hpp>
 #include <simdjson.h>
+#include "core/Payload.hpp"
+#include "data/ExtractionSpec.hpp"
 
 namespace civic {
 
+    class StorageEngine;
+    class ThreadPool;
+
+    // Parser owned by exactly one thread. The simdjson tape and string buffers
+    // are allocated up front and only grow, so steady-state parsing reuses them.
+    class ParserContext {
+    public:
+        static constexpr size_t kInitialCapacity = 64 * 1024;
+
+        ParserContext();
+
+        // Extracted views point into the parser and stay valid until the next call.
+        bool extractFields(const std::string& rawJson, std::string_view& author, std::string_view& title);
+        // Payloads are pre-padded: simdjson parses them in place, without a copy.
+        bool extractFields(const Payload& payload, std::string_view& author, std::string_view& title);
+
+        // Splits newline-delimited JSON with parse_many and calls
+        // onDocument(raw, author, title) for each valid document, in order.
+        // `ndjson` must be followed by SIMDJSON_PADDING readable bytes. After an
+        // invalid document the rest of the input is parsed line by line, so
+        // one bad line costs only itself. Returns the number of documents.
+        template<typename OnDocument>
+        size_t extractMany(std::string_view ndjson, OnDocument&& onDocument);
+
+        size_t capacity() const { return parser_.capacity(); }
+        // Document of the last successful extraction, valid as the views above.
+        simdjson::dom::element document() const { return document_; }
+
+    private:
+        bool extractFrom(simdjson::simdjson_result<simdjson::dom::element> parsed,
+                         std::string_view& author, std::string_view& title);
+
+        simdjson::dom::parser parser_;
+        simdjson::dom::element document_;
+    };
+
+    // Writer owned by a single consumer thread: its own connection and its own
+    // Appender (row-group stream) on ingest_logs, plus one per extraction table
+    // it writes to. Rows become visible at commit().
+    class WriterContext {
+    public:
+        ~WriterContext();
+
+        WriterContext(const WriterContext&) = delete;
+        WriterContext& operator=(const WriterContext&) = delete;
+
+        // Invalid documents are skipped; returns the number of rows appended.
+        size_t append(std::span<const std::string> payloads);
+        size_t append(std::span<const Payload> payloads);
+        // NDJSON window, padded as for ParserContext::extractMany.
+        size_t appendNdjson(std::string_view ndjson);
+        void commit();
+
+        size_t pendingRows() const { return pending_; }
+        duckdb::Connection& connection() { return con_; }
+
+    private:
+        friend class StorageEngine;
+        explicit WriterContext(StorageEngine& engine);
+
+        template<typename T>
+        size_t appendRows(std::span<const T> payloads);
+        // Never throws: a document that fails is logged and not counted.
+        bool appendRow(duckdb::timestamp_t ts, std::string_view raw, std::string_view author, std::string_view title);
+
+        duckdb::Connection con_;
+        std::unique_ptr<duckdb::Appender> appender_;  // ingest_logs, recreated after a failed row
+        ParserContext parser_;
+        std::vector<std::shared_ptr<const ExtractionSpec>> extractions_;
+        std::vector<std::unique_ptr<duckdb::Appender>> extractionAppenders_;  // created on first row
+        size_t pending_ = 0;
+    };
+
+    struct NdjsonOptions {
+        size_t windowBytes = 16 * 1024 * 1024; // extended to the next newline
+        size_t writers = 0;                    // 0: one per pool thread
+        ThreadPool* pool = nullptr;            // null: a pool for this call only
+    };
+
     class StorageEngine {
     public:
         explicit StorageEngine(const std::string& dbPath = ":memory:");
         ~StorageEngine();
 
         std::unique_ptr<duckdb::Connection> createConnection();
+        std::unique_ptr<WriterContext> createWriter();
+
+        // Creates the spec's table and routes the payloads of its type there.
+        // Only writers created afterwards (createWriter, ingestNdjson) apply it;
+        // the connection-based ingest() and ingestBatch() keep ingest_logs.
+        bool addExtraction(ExtractionSpec spec);
 
         void ingest(duckdb::Connection& con, const std::string& rawJson);
 
+        // Appends a whole batch through a single duckdb::Appender.
+        // Invalid documents are skipped; returns the number of rows written.
+        size_t ingestBatch(duckdb::Connection& con, std::span<const std::string> payloads);
+
+        // Bulk load of newline-delimited JSON. The file is memory-mapped and
+        // cut into windows on line boundaries; parallel writers, run on a
+        // ThreadPool, each take windows, split them with parse_many and
+        // append through their own Appender. Invalid lines are skipped; returns the number of rows.
+        size_t ingestNdjson(const std::string& path, const NdjsonOptions& options = {});
+        // Same for NDJSON already in memory, copied once for simdjson's padding.
+        size_t ingestNdjsonBuffer(std::string_view ndjson, const NdjsonOptions& options = {});
+
         void query(duckdb::Connection& con, const std::string& sql);
 
     private:
+        friend class WriterContext;
+
+        size_t ingestNdjsonPadded(std::string_view ndjson, const NdjsonOptions& options);
+
         duckdb::DuckDB db_;
-        simdjson::dom::parser parser_;
+        std::mutex extractionsMutex_;
+        std::vector<std::shared_ptr<const ExtractionSpec>> extractions_;
     };
-}
\ No newline at end of file
+
+    template<typename OnDocument>
+    size_t ParserContext::extractMany(std::string_view ndjson, OnDocument&& onDocument) {
+        size_t documents = 0;
+        std::string_view author, title;
+
+        simdjson::dom::document_stream stream;
+        auto bytes = reinterpret_cast<const uint8_t*>(ndjson.data());
+        size_t batchSize = std::max(ndjson.size(), simdjson::dom::MINIMAL_BATCH_SIZE);
+        size_t resume = 0;
+        if (parser_.parse_many(bytes, ndjson.size(), batchSize).get(stream) == simdjson::SUCCESS) {
+            resume = std::string_view::npos;
+            for (auto it = stream.begin(); it != stream.end(); ++it) {
+                if (!extractFrom(*it, author, title)) {
+                    resume = it.current_index();
+                    break;
+                }
+                onDocument(it.source(), author, title);
+                ++documents;
+            }
+        }
+        if (resume == std::string_view::npos) { return documents; }
+
+        // The stream stops at the first error: go on line by line from the
+        // beginning of the offending line
+        size_t start = resume == 0 ? std::string_view::npos : ndjson.rfind('\n', resume - 1);
+        start = start == std::string_view::npos ? 0 : start + 1;
+        while (start < ndjson.size()) {
+            size_t end = ndjson.find('\n', start);
+            if (end == std::string_view::npos) { end = ndjson.size(); }
+            auto line = ndjson.substr(start, end - start);
+            start = end + 1;
+            if (line.find_first_not_of(" \t\r") == std::string_view::npos) { continue; }
+
+            auto lineBytes = reinterpret_cast<const uint8_t*>(line.data());
+            if (!extractFrom(parser_.parse(lineBytes, line.size(), false), author, title)) { continue; }
+            while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) {
+                line.remove_suffix(1);
+            }
+            onDocument(line, author, title);
+            ++documents;
+        }
+        return documents;
+    }
+}
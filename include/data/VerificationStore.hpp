@@ -0,0 +1,23 @@
+#pragma once
+
+#include <memory>
+#include <duckdb.hpp>
+#include "data/StorageEngine.hpp"
+#include "search/CacheVerification.hpp"
+
+namespace civic {
+
+    // Persists the resource verification cache in a DuckDB table, so a warm
+    // restart keeps its ETags and does not re-verify everything.
+    class VerificationStore {
+    public:
+        explicit VerificationStore(StorageEngine& engine);
+
+        // Returns the number of entries loaded into / written from the cache.
+        size_t load(CacheVerification& cache);
+        size_t save(const CacheVerification& cache);
+
+    private:
+        std::unique_ptr<duckdb::Connection> con_;
+    };
+}
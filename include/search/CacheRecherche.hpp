@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <optional>
+#include <chrono>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include "core/ShardedLruCache.hpp"
+#include "search/SearchService.hpp"
+
+namespace civic {
+
+    // Résultats de recherche par clé canonique, bornés en mémoire (poids
+    // estimé en octets) et expirés après le TTL. Les requêtes identiques
+    // concurrentes partagent un seul appel à l'API : le premier appelant
+    // (le meneur) lance la requête, les suivants attendent sa publication.
+    class CacheRecherche {
+    public:
+        using Attente = std::function<void(std::optional<ResultatRecherche>)>;
+        using IdAttente = uint64_t;
+
+        struct Acces {
+            std::optional<ResultatRecherche> resultat;
+            IdAttente attente = 0;
+            bool meneur = false;
+        };
+
+        explicit CacheRecherche(size_t capaciteOctets = 64 * 1024 * 1024,
+                                std::chrono::seconds ttl = std::chrono::minutes(5));
+
+        // Entrée fraîche : `resultat` est rempli et `attente` n'est pas
+        // conservée. Sinon `attente` sera appelée par publier() ; si
+        // `meneur` est vrai, c'est à l'appelant de lancer la requête.
+        Acces acquerir(const std::string& cle, Attente attente);
+        // Détache une attente pas encore servie et la rend à l'appelant,
+        // qui devient responsable de l'appeler
+        std::optional<Attente> retirer(const std::string& cle, IdAttente id);
+        // Conserve le résultat s'il y en a un, puis sert toutes les attentes
+        void publier(const std::string& cle, std::optional<ResultatRecherche> resultat);
+
+        void vider() { entrees_.clear(); }
+        void setTtl(std::chrono::seconds ttl) { ttlSecondes_.store(ttl.count(), std::memory_order_relaxed); }
+        std::chrono::seconds ttl() const { return std::chrono::seconds(ttlSecondes_.load(std::memory_order_relaxed)); }
+
+        size_t taille() const { return entrees_.size(); }
+        size_t poids() const { return entrees_.weight(); }
+        size_t trouvees() const { return trouvees_.load(std::memory_order_relaxed); }
+        size_t manquees() const { return manquees_.load(std::memory_order_relaxed); }
+        size_t partagees() const { return partagees_.load(std::memory_order_relaxed); }
+
+        static size_t estimerPoids(const ResultatRecherche& resultat);
+
+    private:
+        struct Entree {
+            ResultatRecherche resultat;
+            std::chrono::steady_clock::time_point stockeeLe;
+        };
+
+        std::optional<ResultatRecherche> fraiche(const std::string& cle);
+
+        ShardedLruCache<std::string, Entree> entrees_;
+        std::atomic<int64_t> ttlSecondes_;
+
+        std::mutex volsMutex_;
+        std::unordered_map<std::string, std::map<IdAttente, Attente>> vols_;
+        IdAttente prochaineAttente_ = 1;
+
+        std::atomic<size_t> trouvees_{0};
+        std::atomic<size_t> manquees_{0};
+        std::atomic<size_t> partagees_{0};
+    };
+
+}
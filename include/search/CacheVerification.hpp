@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <chrono>
+#include <atomic>
+#include <utility>
+#include "core/ShardedLruCache.hpp"
+#include "search/HttpsClient.hpp"
+#include "search/SearchService.hpp"
+
+namespace civic {
+
+    struct EntreeVerification {
+        VerificationRessource verification;
+        std::optional<std::string> etag;
+        std::optional<std::string> lastModified;
+        std::chrono::system_clock::time_point verifieeLe;
+    };
+
+    // Résultats de HEAD par URL. Une entrée plus jeune que le TTL est servie
+    // sans requête ; au-delà, elle est revalidée par une requête
+    // conditionnelle (If-None-Match / If-Modified-Since) et un 304 la prolonge.
+    class CacheVerification {
+    public:
+        explicit CacheVerification(size_t capacite = 50000,
+                                   std::chrono::seconds ttl = std::chrono::hours(1));
+
+        // Entrée fraîche : le résultat, sans requête. Sinon nullopt, et les
+        // en-têtes conditionnels sont ajoutés à `options` si possible.
+        std::optional<VerificationRessource> consulter(const std::string& url, OptionsRequete& options);
+        // Intègre la réponse au HEAD, 304 compris, et renvoie la vérification.
+        VerificationRessource integrer(const std::string& url, ReponseHttp reponse);
+
+        void enregistrer(const std::string& url, EntreeVerification entree);
+        std::optional<EntreeVerification> entree(const std::string& url);
+
+        std::vector<std::pair<std::string, EntreeVerification>> exporter() const;
+        void importer(std::vector<std::pair<std::string, EntreeVerification>> entrees);
+        void vider() { entrees_.clear(); }
+
+        void setTtl(std::chrono::seconds ttl) { ttlSecondes_.store(ttl.count(), std::memory_order_relaxed); }
+        std::chrono::seconds ttl() const { return std::chrono::seconds(ttlSecondes_.load(std::memory_order_relaxed)); }
+
+        size_t taille() const { return entrees_.size(); }
+        size_t servies() const { return servies_.load(std::memory_order_relaxed); }
+        size_t revalidees() const { return revalidees_.load(std::memory_order_relaxed); }
+        size_t requetes() const { return requetes_.load(std::memory_order_relaxed); }
+
+    private:
+        bool estFraiche(const EntreeVerification& entree) const;
+
+        ShardedLruCache<std::string, EntreeVerification> entrees_;
+        std::atomic<int64_t> ttlSecondes_;
+        std::atomic<size_t> servies_{0};
+        std::atomic<size_t> revalidees_{0};
+        std::atomic<size_t> requetes_{0};
+    };
+
+}
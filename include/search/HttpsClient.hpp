@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace boost::asio {
+    class io_context;
+}
+
+namespace civic {
+
+    enum class MethodeHttp {
+        GET,
+        HEAD
+    };
+
+    struct OptionsRequete {
+        bool verifierCertificat = false;
+        std::chrono::milliseconds timeout{30000};
+        std::vector<std::pair<std::string, std::string>> entetes;
+        // Au-delà, la lecture échoue au lieu de faire grossir la mémoire
+        uint64_t tailleMaxCorps = 128 * 1024 * 1024;
+    };
+
+    struct ReponseHttp {
+        int status = 0;
+        std::string corps;
+        std::optional<std::string> contentType;
+        std::optional<int64_t> contentLength;
+        std::optional<std::string> etag;
+        std::optional<std::string> lastModified;
+        std::string erreur;
+        std::chrono::milliseconds duree{0};
+        bool connexionReutilisee = false;
+        bool sessionReprise = false;
+
+        bool ok() const { return erreur.empty() && status != 0; }
+    };
+
+    struct HttpsClientOptions {
+        size_t maxConnexionsInactivesParHote = 8;
+        std::chrono::seconds dureeInactiviteMax{30};
+    };
+
+    // Client HTTPS longue durée : un seul ssl::context, un pool de connexions
+    // keep-alive par hôte et reprise de session TLS (tickets) à la reconnexion.
+    // Sans io_context fourni, le client a son propre thread réseau ; sinon
+    // les callbacks s'exécutent sur les threads qui font tourner celui fourni,
+    // qui doit survivre au client.
+    class HttpsClient {
+    public:
+        using Callback = std::function<void(ReponseHttp)>;
+        using IdRequete = uint64_t;
+
+        explicit HttpsClient(HttpsClientOptions options = {});
+        explicit HttpsClient(boost::asio::io_context& ioc, HttpsClientOptions options = {});
+        ~HttpsClient();
+
+        HttpsClient(const HttpsClient&) = delete;
+        HttpsClient& operator=(const HttpsClient&) = delete;
+
+        // Le callback est appelé exactement une fois, y compris après
+        // annulation ou timeout (ReponseHttp::erreur renseigné)
+        IdRequete envoyerAsync(MethodeHttp methode, const std::string& url,
+                               OptionsRequete options, Callback callback);
+        void annuler(IdRequete id);
+
+        // Façades synchrones, à ne pas appeler depuis un callback du client
+        ReponseHttp get(const std::string& url, OptionsRequete options = {});
+        ReponseHttp head(const std::string& url, OptionsRequete options = {});
+
+        size_t connexionsOuvertes() const;
+        size_t sessionsReprises() const;
+
+        // Racine de confiance supplémentaire (PEM), utile pour les tests
+        void ajouterCertificatRacine(const std::string& pem);
+
+    private:
+        struct Impl;
+        struct Runtime;
+        class Requete;
+        std::unique_ptr<Runtime> runtime_;
+        std::shared_ptr<Impl> impl_;
+    };
+
+}
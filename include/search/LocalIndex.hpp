@@ -0,0 +1,120 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include "search/SearchService.hpp"
+
+namespace simdjson {
+    class padded_string_view;
+    namespace dom {
+        class parser;
+    }
+}
+
+namespace civic {
+
+    // Index inversé du catalogue local, construit une fois. Les mots
+    // normalisés (titre, description, tags, enriched_keywords) pointent vers
+    // des listes triées de jeux, avec leur fréquence BM25F pondérée par
+    // champ ; les métadonnées des jeux sont rangées par colonne et ne sont
+    // matérialisées que pour la page demandée. Les chaînes pointent dans le
+    // document simdjson, gardé en vie par l'index.
+    class LocalIndex {
+    public:
+        using IdJeu = uint32_t;
+
+        struct Correspondance {
+            IdJeu jeu;
+            double score;
+        };
+
+        struct PageLocale {
+            std::vector<Correspondance> jeux;
+            size_t total = 0;
+        };
+
+        LocalIndex();
+        ~LocalIndex();
+        LocalIndex(LocalIndex&&) noexcept;
+        LocalIndex& operator=(LocalIndex&&) noexcept;
+
+        // Le fichier est projeté en mémoire et analysé sur place
+        bool charger(const std::string& chemin);
+        bool construire(const std::string& json);
+
+        // Chaque mot de la requête devient « lui OU ses synonymes », un
+        // synonyme comptant pour `poidsSynonyme` d'une occurrence directe.
+        // Les listes fusionnées sont précalculées ici et à chaque construction.
+        void setSynonymes(const std::unordered_map<std::string, std::vector<std::string>>& synonymes,
+                          float poidsSynonyme = 0.5f);
+
+        // Jeux contenant, pour chaque mot de la requête, un mot qui commence
+        // par lui ; en ordre du catalogue. `tagsThematique` non vide restreint
+        // aux jeux portant au moins l'un de ces tags.
+        std::vector<IdJeu> rechercher(const std::string& requete,
+                                      bool uniquementCertifiees,
+                                      const std::vector<std::string>& tagsThematique) const;
+
+        // Classe les jeux de rechercher() selon `tri` ("relevance" : BM25F,
+        // "created", "last_modified", "downloads") et ne rend que les rangs
+        // [debut, debut + nombre), sélectionnés par un tas borné
+        PageLocale classer(const std::string& requete,
+                           bool uniquementCertifiees,
+                           const std::vector<std::string>& tagsThematique,
+                           const std::string& tri,
+                           size_t debut, size_t nombre) const;
+
+        JeuDeDonnees jeu(IdJeu id, double score = 0.0) const;
+
+        size_t taille() const { return ids_.size(); }
+        size_t vocabulaire() const { return termes_.size(); }
+
+    private:
+        struct Occurrence {
+            IdJeu jeu;
+            float poids;
+        };
+
+        bool indexer(const simdjson::padded_string_view& json);
+        void compilerSynonymes();
+        std::vector<Occurrence> occurrencesExactes(const std::string& mot) const;
+        // Union des listes des termes commençant par `prefixe`, poids cumulés
+        std::vector<Occurrence> occurrencesPrefixe(std::string_view prefixe) const;
+        // nullopt si un mot de la requête n'apparaît nulle part
+        std::optional<std::vector<std::vector<Occurrence>>> occurrencesRequete(const std::string& requete) const;
+        std::vector<IdJeu> filtrer(const std::vector<std::vector<Occurrence>>& mots,
+                                   bool uniquementCertifiees,
+                                   const std::vector<std::string>& tagsThematique) const;
+
+        std::vector<std::string> termes_;
+        std::vector<std::vector<Occurrence>> postings_;
+        std::unordered_map<std::string_view, std::vector<IdJeu>> parTag_;
+
+        // mot -> synonymes, chacun découpé en mots (« piste-cyclable »)
+        std::unordered_map<std::string, std::vector<std::vector<std::string>>> synonymes_;
+        std::unordered_map<std::string, std::vector<Occurrence>> occurrencesSynonymes_;
+        float poidsSynonyme_ = 0.5f;
+
+        std::unique_ptr<simdjson::dom::parser> document_;
+        std::vector<std::string_view> ids_;
+        std::vector<std::string_view> titres_;
+        std::vector<std::string_view> descriptions_;
+        std::vector<Symbol> organisations_;
+        std::vector<char> certifiees_;
+        std::vector<std::string_view> creations_;
+        std::vector<std::string_view> modifications_;
+        std::vector<int64_t> vues_;
+        std::vector<int64_t> reutilisations_;
+
+        std::vector<uint32_t> debutRessources_;
+        std::vector<std::string_view> ressourceUrls_;
+        std::vector<std::string_view> ressourceTitres_;
+        std::vector<int8_t> ressourceFormats_;
+    };
+
+}
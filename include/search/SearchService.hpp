@@ -1,12 +1,20 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
+#include "core/Symbol.hpp"
+#include "search/HttpsClient.hpp"
 
 namespace civic {
 
@@ -60,7 +68,7 @@ namespace civic {
         std::string description;
         std::string url;
         FormatFichier format;
-        std::string mimeType;
+        Symbol mimeType;
         int64_t taille;
         std::chrono::system_clock::time_point derniereMaj;
         bool estPrincipale;
@@ -76,18 +84,18 @@ namespace civic {
         std::string slug;
         std::string titre;
         std::string description;
-        std::string organisation;
-        std::string organisationId;
+        Symbol organisation;
+        Symbol organisationId;
         bool organisationCertifiee;
         Thematique thematique;
         std::vector<std::string> tags;
-        std::string couvertureTerritoriale;
-        std::string granulariteTerritoriale;
+        Symbol couvertureTerritoriale;
+        Symbol granulariteTerritoriale;
         std::chrono::system_clock::time_point dateCreation;
         std::chrono::system_clock::time_point derniereMaj;
         int frequenceMaj;
         std::vector<Ressource> ressources;
-        std::string licence;
+        Symbol licence;
         int nombreTelechargements;
         int nombreReutilisations;
         double score;
@@ -137,36 +145,96 @@ namespace civic {
         std::chrono::milliseconds tempsReponse;
     };
 
+    class CacheVerification;
+    class CacheRecherche;
+    class LocalIndex;
+
+    // Vérification concurrente des ressources : au plus maxConcurrence HEAD
+    // en vol, maxParHote par hôte, et tout le lot borné par delaiGlobal
+    struct OptionsVerification {
+        size_t maxConcurrence = 16;
+        size_t maxParHote = 4;
+        std::chrono::milliseconds timeoutRequete{10000};
+        std::chrono::milliseconds delaiGlobal{15000};
+    };
+
     class SearchService {
     public:
         using SearchCallback = std::function<void(ResultatRecherche)>;
         using VerifyCallback = std::function<void(VerificationRessource)>;
+        using IdOperation = uint64_t;
 
         SearchService();
+        // Les opérations asynchrones tournent sur `ioc`, qui doit continuer
+        // de tourner jusqu'à la destruction du service
+        explicit SearchService(boost::asio::io_context& ioc);
         ~SearchService();
 
         ResultatRecherche rechercher(const CriteresRecherche& criteres);
         ResultatRecherche rechercherLocal(const CriteresRecherche& criteres);
-        void rechercherAsync(const CriteresRecherche& criteres, SearchCallback callback);
         VerificationRessource verifierRessource(const std::string& url);
-        void verifierRessourceAsync(const std::string& url, VerifyCallback callback);
+
+        // Non bloquants. Le callback est appelé une fois, sur le thread réseau,
+        // y compris après annuler() ou expiration (résultat vide), ou tout de
+        // suite si le résultat est déjà en cache. Un timeout nul reprend
+        // celui du service. Une recherche identique à une recherche en vol
+        // en attend le résultat, sous l'échéance de la première.
+        IdOperation rechercherAsync(const CriteresRecherche& criteres, SearchCallback callback,
+                                    std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+        IdOperation verifierRessourceAsync(const std::string& url, VerifyCallback callback,
+                                           std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+        void annuler(IdOperation id);
+        size_t operationsEnCours() const;
+
+        std::vector<VerificationRessource> verifierRessources(const std::vector<std::string>& urls) const;
+        void setOptionsVerification(const OptionsVerification& options) { optionsVerification_ = options; }
+        CacheVerification& cacheVerification() { return *cache_; }
+        CacheRecherche& cacheRecherche() { return *cacheRecherche_; }
+        // Catalogue de rechercherLocal, rechargé quand sa date de
+        // modification change (vérifiée au plus une fois par seconde)
+        static constexpr const char* cheminCatalogueParDefaut = "/data_enriched.json";
+        void setCheminCatalogue(const std::string& chemin);
+        std::string cheminCatalogue() const;
         std::optional<JeuDeDonnees> getDataset(const std::string& datasetId);
+        // Réponse JSON de /datasets/ en jeux filtrés selon `criteres`. Lue en
+        // un seul passage (simdjson On-Demand) ; l'ancien chemin DOM reste
+        // disponible pour comparer les deux.
+        ResultatRecherche parserReponse(const std::string& json,
+                                        const CriteresRecherche& criteres,
+                                        std::chrono::milliseconds tempsRecherche) const;
+        void setParserDom(bool dom) { parserDom_ = dom; }
         bool telechargerRessource(const Ressource& ressource, const std::string& cheminDestination);
 
         static std::string thematiqueVersTag(Thematique theme);
         static std::vector<std::string> getTagsThematique(Thematique theme);
+        // Synonymes normalisés, utilisés pour élargir la recherche locale
+        static const std::unordered_map<std::string, std::vector<std::string>>& getSynonymes();
         static std::string formatVersMimeType(FormatFichier format);
         static std::optional<FormatFichier> mimeTypeVersFormat(const std::string& mimeType);
+        // "type/sous-type" d'un Content-Type, en minuscules et sans ses
+        // paramètres ; nullopt si l'en-tête n'en est pas un
+        static std::optional<std::string> typeMedia(std::string_view contentType);
         static std::vector<std::string> getOrganisationsSPD();
         static std::vector<std::pair<Thematique, std::string>> getThematiques();
 
     private:
+        struct OperationAsync;
+
+        IdOperation ouvrirOperation(std::shared_ptr<OperationAsync> op);
+        void fermerOperation(IdOperation id);
+        std::shared_ptr<const LocalIndex> indexLocal();
+        void lancerRecherche(const std::string& cle, const std::string& url,
+                             const CriteresRecherche& criteres, std::chrono::milliseconds delai);
         std::string construireURLRecherche(const CriteresRecherche& criteres) const;
-        ResultatRecherche parserReponse(const std::string& json, 
-                                         const CriteresRecherche& criteres,
-                                         std::chrono::milliseconds tempsRecherche) const;
-        std::vector<Ressource> filtrerRessources(const std::vector<Ressource>& ressources,
-                                                  const CriteresRecherche& criteres) const;
+        std::string cleRecherche(const CriteresRecherche& criteres) const;
+        ResultatRecherche parserReponseDom(const std::string& json,
+                                           const CriteresRecherche& criteres,
+                                           std::chrono::milliseconds tempsRecherche) const;
+        ResultatRecherche parserReponseOnDemand(const std::string& json,
+                                                const CriteresRecherche& criteres,
+                                                std::chrono::milliseconds tempsRecherche) const;
+        bool retenirJeu(JeuDeDonnees& jeu, const CriteresRecherche& criteres) const;
+        void verifierDisponibilites(std::vector<JeuDeDonnees>& jeux) const;
         bool ressourceAcceptee(const Ressource& ressource, 
                                const CriteresRecherche& criteres) const;
         std::string httpGet(const std::string& url) const;
@@ -174,6 +242,23 @@ namespace civic {
 
         std::string baseUrl_ = "https://www.data.gouv.fr/api/1";
         int timeoutSeconds_ = 30;
+        OptionsVerification optionsVerification_;
+        bool parserDom_ = false;
+        std::unique_ptr<HttpsClient> client_;
+        std::unique_ptr<CacheVerification> cache_;
+        std::unique_ptr<CacheRecherche> cacheRecherche_;
+
+        mutable std::mutex indexLocalMutex_;
+        std::mutex chargementIndexMutex_;
+        std::shared_ptr<const LocalIndex> indexLocal_;
+        std::string cheminCatalogue_ = cheminCatalogueParDefaut;
+        std::filesystem::file_time_type dateCatalogue_{};
+        std::chrono::steady_clock::time_point prochaineVerificationCatalogue_{};
+
+        mutable std::mutex operationsMutex_;
+        std::condition_variable operationsTerminees_;
+        std::map<IdOperation, std::shared_ptr<OperationAsync>> operations_;
+        IdOperation prochainId_ = 1;
     };
 
     class CriteresBuilder {
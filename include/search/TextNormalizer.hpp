@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace civic {
+
+    // Minuscules, lettres latines accentuées ramenées à l'ASCII (U+00C0 à
+    // U+017F : « é » -> e, « œ » -> oe), seuls lettres, chiffres, espaces et
+    // tirets conservés, blancs de bord retirés. Un seul passage ; `sortie`
+    // doit pouvoir recevoir texte.size() octets, la sortie n'étant jamais
+    // plus longue que l'entrée. Renvoie la longueur écrite.
+    size_t normaliserTexte(std::string_view texte, char* sortie);
+    std::string normaliserTexte(const std::string& texte);
+
+    // Mots d'un texte déjà normalisé, coupés sur les espaces et les tirets
+    std::vector<std::string> decouperMots(const std::string& texteNormalise);
+
+}
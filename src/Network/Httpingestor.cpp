@@ -1,76 +1,388 @@
 #include "Network/HttpIngestor.hpp"
+#include <atomic>
+#include <deque>
 #include <iostream>
+#include <optional>
+#include <set>
 
 namespace civic {
 
-    HttpIngestor::HttpIngestor(RingBuffer<std::string>& buffer, net::io_context& ioc)
-        : buffer_(buffer), resolver_(ioc), stream_(ioc) 
+    // All handlers of a session run on its strand, so the state below is
+    // only touched from one thread at a time.
+    class HttpIngestor::Session : public std::enable_shared_from_this<Session> {
+    public:
+        Session(net::io_context& ioc, RingBuffer<Payload>& buffer,
+                std::string host, std::string port, const HttpIngestorOptions& options)
+            : strand_(net::make_strand(ioc)), buffer_(buffer),
+              host_(std::move(host)), port_(std::move(port)), options_(options),
+              resolver_(strand_), stream_(strand_), retryTimer_(strand_)
+        {
+        }
+
+        void enqueue(std::string target, bool repeat, std::chrono::milliseconds interval) {
+            net::post(strand_, [self = shared_from_this(), pending = Pending{std::move(target), repeat, interval}]() mutable {
+                if (self->stopped_) return;
+                self->queued_.push_back(std::move(pending));
+                self->kick();
+            });
+        }
+
+        void stop() {
+            stopped_ = true;
+            net::post(strand_, [self = shared_from_this()]() {
+                self->resolver_.cancel();
+                self->retryTimer_.cancel();
+                for (auto& timer : self->timers_) timer->cancel();
+                self->timers_.clear();
+                self->closeConnection();
+                self->queued_.clear();
+                self->inflight_.clear();
+            });
+        }
+
+        std::atomic<size_t> responses{0};
+        std::atomic<size_t> dropped{0};
+        std::atomic<size_t> connections{0};
+
+    private:
+        struct Pending {
+            std::string target;
+            bool repeat = false;
+            std::chrono::milliseconds interval{0};
+            int attempts = 0;
+        };
+
+        void kick() {
+            if (stopped_) return;
+            if (!connected_) {
+                // Wait for the aborted operations of the previous socket to
+                // complete before reusing the stream
+                if (!connecting_ && !writing_ && !reading_ && (!queued_.empty() || !inflight_.empty())) {
+                    connect();
+                }
+                return;
+            }
+            write();
+            read();
+        }
+
+        void connect() {
+            connecting_ = true;
+            if (!endpoints_.empty()) {
+                doConnect();
+                return;
+            }
+            resolver_.async_resolve(host_, port_,
+                beast::bind_front_handler(&Session::onResolve, shared_from_this()));
+        }
+
+        void onResolve(beast::error_code ec, tcp::resolver::results_type results) {
+            if (stopped_) return;
+            if (ec) {
+                std::cerr << "[NET] Resolve failed: " << ec.message() << std::endl;
+                connecting_ = false;
+                giveUpOrRetry();
+                return;
+            }
+
+            endpoints_ = results;
+            doConnect();
+        }
+
+        void doConnect() {
+            stream_.expires_after(options_.timeout);
+            stream_.async_connect(endpoints_,
+                beast::bind_front_handler(&Session::onConnect, shared_from_this()));
+        }
+
+        void onConnect(beast::error_code ec, tcp::resolver::results_type::endpoint_type) {
+            connecting_ = false;
+            if (stopped_) return;
+            if (ec) {
+                std::cerr << "[NET] Connect failed: " << ec.message() << std::endl;
+                endpoints_ = {}; // re-resolve next time, the address may have moved
+                stream_.close();
+                giveUpOrRetry();
+                return;
+            }
+
+            connected_ = true;
+            answeredOnConnection_ = 0;
+            responseBuffer_.clear();
+            connections.fetch_add(1, std::memory_order_relaxed);
+            kick();
+        }
+
+        void write() {
+            if (writing_ || queued_.empty() || inflight_.size() >= options_.pipelineDepth) {
+                return;
+            }
+
+            inflight_.push_back(std::move(queued_.front()));
+            queued_.pop_front();
+
+            req_ = {};
+            req_.version(11);
+            req_.method(http::verb::get);
+            req_.target(inflight_.back().target);
+            req_.set(http::field::host, host_);
+            req_.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
+            req_.keep_alive(true);
+
+            writing_ = true;
+            stream_.expires_after(options_.timeout);
+            http::async_write(stream_, req_,
+                beast::bind_front_handler(&Session::onWrite, shared_from_this(), generation_));
+        }
+
+        void onWrite(uint64_t generation, beast::error_code ec, std::size_t) {
+            writing_ = false;
+            if (stopped_) return;
+            if (generation != generation_) {
+                kick();
+                return;
+            }
+            if (ec) {
+                // Responses to earlier requests may already be here: the
+                // pending read drains them, and its own failure closes
+                if (reading_) return;
+                fail(ec, "Write");
+                return;
+            }
+
+            write();
+            read();
+        }
+
+        void read() {
+            if (reading_ || inflight_.empty()) {
+                return;
+            }
+
+            parser_.emplace();
+            parser_->body_limit(options_.maxBodyBytes);
+            parser_->get().body() = pool_.acquire(16 * 1024);
+            reading_ = true;
+            stream_.expires_after(options_.timeout);
+            http::async_read_header(stream_, responseBuffer_, *parser_,
+                beast::bind_front_handler(&Session::onHeader, shared_from_this(), generation_));
+        }
+
+        void onHeader(uint64_t generation, beast::error_code ec, std::size_t) {
+            if (stopped_ || generation != generation_ || ec) {
+                onRead(generation, ec, 0);
+                return;
+            }
+
+            // Checked before the body reader reserves the announced length;
+            // body_limit alone only stops bodies as they stream in
+            auto length = parser_->content_length();
+            if (length && *length > options_.maxBodyBytes) {
+                reading_ = false;
+                fail(http::error::body_limit, "Read");
+                return;
+            }
+
+            http::async_read(stream_, responseBuffer_, *parser_,
+                beast::bind_front_handler(&Session::onRead, shared_from_this(), generation_));
+        }
+
+        void onRead(uint64_t generation, beast::error_code ec, std::size_t) {
+            reading_ = false;
+            if (stopped_) return;
+            if (generation != generation_) {
+                kick();
+                return;
+            }
+            if (ec) {
+                fail(ec, "Read");
+                return;
+            }
+
+            Pending done = std::move(inflight_.front());
+            inflight_.pop_front();
+            ++answeredOnConnection_;
+            responses.fetch_add(1, std::memory_order_relaxed);
+
+            auto& res = parser_->get();
+            bool keepAlive = res.keep_alive();
+            size_t bytes = res.body().size();
+            if (!buffer_.push(std::move(res.body()))) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                std::cerr << "[NET] RingBuffer FULL! Dropping packet." << std::endl;
+            } else if (!done.repeat) {
+                std::cout << "[NET] Ingested " << bytes << " bytes." << std::endl;
+            }
+
+            if (done.repeat) {
+                reschedule(std::move(done));
+            }
+
+            if (!keepAlive) {
+                closeConnection();
+            }
+            kick();
+        }
+
+        void reschedule(Pending pending) {
+            if (pending.interval.count() == 0) {
+                queued_.push_back(std::move(pending));
+                return;
+            }
+
+            auto timer = std::make_shared<net::steady_timer>(strand_, pending.interval);
+            timers_.insert(timer);
+            timer->async_wait([self = shared_from_this(), timer, pending = std::move(pending)](beast::error_code ec) mutable {
+                self->timers_.erase(timer);
+                if (ec || self->stopped_) return;
+                self->queued_.push_back(std::move(pending));
+                self->kick();
+            });
+        }
+
+        // Drops the socket and puts the unanswered requests back at the
+        // front of the queue, in their original order.
+        void closeConnection() {
+            beast::error_code code;
+            stream_.socket().shutdown(tcp::socket::shutdown_both, code);
+            stream_.close();
+            ++generation_;
+            connected_ = false;
+
+            while (!inflight_.empty()) {
+                queued_.push_front(std::move(inflight_.back()));
+                inflight_.pop_back();
+            }
+        }
+
+        void fail(beast::error_code ec, const char* what) {
+            // Retrying would fetch the same oversized body again: the request
+            // is dropped, polled or not, and the half-read connection closed
+            if (ec == http::error::body_limit && !inflight_.empty()) {
+                std::cerr << "[NET] " << what << " failed: response over " << options_.maxBodyBytes
+                          << " bytes, dropping " << inflight_.front().target << std::endl;
+                inflight_.pop_front();
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                closeConnection();
+                kick();
+                return;
+            }
+
+            // A keep-alive connection the server closed while idle: just reopen
+            bool stale = answeredOnConnection_ > 0 &&
+                         (ec == http::error::end_of_stream || ec == net::error::eof ||
+                          ec == net::error::connection_reset);
+            if (!stale) {
+                std::cerr << "[NET] " << what << " failed: " << ec.message() << std::endl;
+            }
+
+            closeConnection();
+
+            if (stale) {
+                kick();
+            } else {
+                giveUpOrRetry();
+            }
+        }
+
+        void giveUpOrRetry() {
+            std::deque<Pending> kept;
+            for (auto& pending : queued_) {
+                if (pending.repeat || ++pending.attempts < options_.maxAttempts) {
+                    kept.push_back(std::move(pending));
+                }
+            }
+            queued_.swap(kept);
+            if (queued_.empty()) return;
+
+            retryTimer_.expires_after(options_.retryDelay);
+            retryTimer_.async_wait([self = shared_from_this()](beast::error_code ec) {
+                if (ec || self->stopped_) return;
+                self->kick();
+            });
+        }
+
+        net::strand<net::io_context::executor_type> strand_;
+        RingBuffer<Payload>& buffer_;
+        std::string host_;
+        std::string port_;
+        HttpIngestorOptions options_;
+        PayloadPool pool_;
+
+        tcp::resolver resolver_;
+        tcp::resolver::results_type endpoints_;
+        beast::tcp_stream stream_;
+        beast::flat_buffer responseBuffer_;
+        http::request<http::empty_body> req_;
+        std::optional<http::response_parser<PayloadBody>> parser_;
+        net::steady_timer retryTimer_;
+        std::set<std::shared_ptr<net::steady_timer>> timers_;
+
+        std::deque<Pending> queued_;   // not written yet
+        std::deque<Pending> inflight_; // written, response pending
+        uint64_t generation_ = 0;      // bumped on every close; stale handlers bail out
+        size_t answeredOnConnection_ = 0;
+        bool connecting_ = false;
+        bool connected_ = false;
+        bool writing_ = false;
+        bool reading_ = false;
+        std::atomic<bool> stopped_{false};
+    };
+
+    HttpIngestor::HttpIngestor(RingBuffer<Payload>& buffer, net::io_context& ioc, HttpIngestorOptions options)
+        : buffer_(buffer), ioc_(ioc), options_(options)
     {
     }
 
-    void HttpIngestor::fetch(const std::string& host, const std::string& port, const std::string& target) {
-        req_.version(11);
-        req_.method(http::verb::get);
-        req_.target(target);
-        req_.set(http::field::host, host);
-        req_.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
-
-        resolver_.async_resolve(
-            host, 
-            port,
-            beast::bind_front_handler(&HttpIngestor::onResolve, this)
-        );
+    HttpIngestor::~HttpIngestor() {
+        stop();
     }
 
-    void HttpIngestor::onResolve(beast::error_code ec, tcp::resolver::results_type results) {
-        if(ec) {
-            std::cerr << "[NET] Resolve failed: " << ec.message() << std::endl;
-            return;
+    std::shared_ptr<HttpIngestor::Session> HttpIngestor::sessionFor(const std::string& host, const std::string& port) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& session = sessions_[host + ":" + port];
+        if (!session) {
+            session = std::make_shared<Session>(ioc_, buffer_, host, port, options_);
         }
-
-        stream_.expires_after(std::chrono::seconds(30));
-        stream_.async_connect(
-            results,
-            beast::bind_front_handler(&HttpIngestor::onConnect, this)
-        );
+        return session;
     }
 
-    void HttpIngestor::onConnect(beast::error_code ec, tcp::resolver::results_type::endpoint_type) {
-        if(ec) {
-            std::cerr << "[NET] Connect failed: " << ec.message() << std::endl;
-            return;
-        }
+    void HttpIngestor::fetch(const std::string& host, const std::string& port, const std::string& target) {
+        sessionFor(host, port)->enqueue(target, false, std::chrono::milliseconds(0));
+    }
 
-        stream_.expires_after(std::chrono::seconds(30));
-        http::async_write(stream_, req_,
-            beast::bind_front_handler(&HttpIngestor::onWrite, this)
-        );
+    void HttpIngestor::poll(const std::string& host, const std::string& port, const std::string& target,
+                            std::chrono::milliseconds interval) {
+        sessionFor(host, port)->enqueue(target, true, interval);
     }
 
-    void HttpIngestor::onWrite(beast::error_code ec, std::size_t bytes_transferred) {
-        if(ec) {
-            std::cerr << "[NET] Write failed: " << ec.message() << std::endl;
-            return;
+    void HttpIngestor::stop() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [key, session] : sessions_) {
+            session->stop();
+            stopped_.push_back(std::move(session));
         }
+        sessions_.clear();
+    }
 
-        http::async_read(stream_, responseBuffer_, res_,
-            beast::bind_front_handler(&HttpIngestor::onRead, this)
-        );
+    template<typename Counter>
+    size_t HttpIngestor::total(Counter counter) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t sum = 0;
+        for (const auto& [key, session] : sessions_) sum += ((*session).*counter).load(std::memory_order_relaxed);
+        for (const auto& session : stopped_) sum += ((*session).*counter).load(std::memory_order_relaxed);
+        return sum;
     }
 
-    void HttpIngestor::onRead(beast::error_code ec, std::size_t bytes_transferred) {
-        if(ec) {
-            std::cerr << "[NET] Read failed: " << ec.message() << std::endl;
-            return;
-        }
+    size_t HttpIngestor::responses() const {
+        return total(&Session::responses);
+    }
 
-        if (!buffer_.push(res_.body())) {
-            std::cerr << "[NET] RingBuffer FULL! Dropping packet." << std::endl;
-        } else {
-            std::cout << "[NET] Ingested " << bytes_transferred << " bytes." << std::endl;
-        }
+    size_t HttpIngestor::dropped() const {
+        return total(&Session::dropped);
+    }
 
-        beast::error_code code;
-        stream_.socket().shutdown(tcp::socket::shutdown_both, code);
+    size_t HttpIngestor::connectionsOpened() const {
+        return total(&Session::connections);
     }
-}
\ No newline at end of file
+}
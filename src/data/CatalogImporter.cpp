@@ -0,0 +1,379 @@
+#include "data/CatalogImporter.hpp"
+#include "core/MappedFile.hpp"
+#include "core/ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace civic {
+
+    namespace {
+        using Kind = CatalogImporter::ColumnType::Kind;
+        using ColumnType = CatalogImporter::ColumnType;
+
+        std::string quoteIdentifier(std::string_view name) {
+            std::string quoted = "\"";
+            for (char c : name) {
+                if (c == '"') quoted += '"';
+                quoted += c;
+            }
+            return quoted + "\"";
+        }
+
+        Kind kindOf(simdjson::dom::element value, bool nested) {
+            switch (value.type()) {
+                case simdjson::dom::element_type::NULL_VALUE: return Kind::Null;
+                case simdjson::dom::element_type::BOOL: return Kind::Boolean;
+                case simdjson::dom::element_type::INT64: return Kind::BigInt;
+                case simdjson::dom::element_type::UINT64: return Kind::Double;
+                case simdjson::dom::element_type::DOUBLE: return Kind::Double;
+                case simdjson::dom::element_type::STRING: return Kind::Varchar;
+                case simdjson::dom::element_type::ARRAY: return nested ? Kind::List : Kind::Varchar;
+                case simdjson::dom::element_type::OBJECT: return nested ? Kind::Struct : Kind::Varchar;
+            }
+            return Kind::Varchar;
+        }
+
+        void widen(ColumnType& type, simdjson::dom::element value, bool nested, size_t maxFields) {
+            Kind kind = kindOf(value, nested);
+            if (kind == Kind::Null || type.kind == Kind::Varchar) return;
+
+            if (type.kind == Kind::Null) {
+                type.kind = kind;
+                if (kind == Kind::List) type.children.resize(1);
+            } else if (type.kind != kind) {
+                bool numeric = (type.kind == Kind::BigInt || type.kind == Kind::Double) &&
+                               (kind == Kind::BigInt || kind == Kind::Double);
+                type = ColumnType{};
+                type.kind = numeric ? Kind::Double : Kind::Varchar;
+                return;
+            }
+
+            simdjson::dom::array array;
+            simdjson::dom::object object;
+            if (kind == Kind::List && value.get(array) == simdjson::SUCCESS) {
+                for (auto child : array) {
+                    widen(type.children[0], child, true, maxFields);
+                }
+            } else if (kind == Kind::Struct && value.get(object) == simdjson::SUCCESS) {
+                for (auto field : object) {
+                    auto it = std::find(type.fields.begin(), type.fields.end(), field.key);
+                    if (it == type.fields.end()) {
+                        if (type.fields.size() == maxFields) {
+                            type = ColumnType{};
+                            type.kind = Kind::Varchar;
+                            return;
+                        }
+                        type.fields.emplace_back(field.key);
+                        type.children.emplace_back();
+                        it = type.fields.end() - 1;
+                    }
+                    widen(type.children[it - type.fields.begin()], field.value, true, maxFields);
+                }
+            }
+        }
+
+        // Types never seen with a value default to VARCHAR; DuckDB has no
+        // empty STRUCT, so objects seen only as {} stay JSON text
+        void settle(ColumnType& type) {
+            if (type.kind == Kind::Null || (type.kind == Kind::Struct && type.fields.empty())) {
+                type = ColumnType{};
+                type.kind = Kind::Varchar;
+            }
+            for (auto& child : type.children) settle(child);
+        }
+
+        duckdb::LogicalType logicalType(const ColumnType& type) {
+            switch (type.kind) {
+                case Kind::Boolean: return duckdb::LogicalType(duckdb::LogicalType::BOOLEAN);
+                case Kind::BigInt: return duckdb::LogicalType(duckdb::LogicalType::BIGINT);
+                case Kind::Double: return duckdb::LogicalType(duckdb::LogicalType::DOUBLE);
+                case Kind::List: return duckdb::LogicalType::LIST(logicalType(type.children[0]));
+                case Kind::Struct: {
+                    duckdb::child_list_t<duckdb::LogicalType> children;
+                    for (size_t i = 0; i < type.fields.size(); ++i) {
+                        children.emplace_back(type.fields[i], logicalType(type.children[i]));
+                    }
+                    return duckdb::LogicalType::STRUCT(std::move(children));
+                }
+                default: return duckdb::LogicalType(duckdb::LogicalType::VARCHAR);
+            }
+        }
+
+        std::string jsonText(simdjson::dom::element value) {
+            std::string_view sv;
+            if (value.get(sv) == simdjson::SUCCESS) return std::string(sv);
+            return simdjson::to_string(value);
+        }
+
+        // Inferred type with its DuckDB type, resolved once per import
+        struct Typed {
+            const ColumnType* type;
+            duckdb::LogicalType logical;
+            std::vector<Typed> children;
+
+            explicit Typed(const ColumnType& t) : type(&t), logical(logicalType(t)) {
+                for (const auto& child : t.children) children.emplace_back(child);
+            }
+        };
+
+        // Values that do not fit the column's type become NULL,
+        // except for VARCHAR, which takes any value as JSON text
+        duckdb::Value toValue(simdjson::dom::element value, const Typed& typed) {
+            const auto& logical = typed.logical;
+            if (value.is_null()) return duckdb::Value(logical);
+
+            switch (typed.type->kind) {
+                case Kind::Boolean: {
+                    bool b;
+                    return value.get(b) == simdjson::SUCCESS ? duckdb::Value::BOOLEAN(b) : duckdb::Value(logical);
+                }
+                case Kind::BigInt: {
+                    int64_t n;
+                    return value.get(n) == simdjson::SUCCESS ? duckdb::Value::BIGINT(n) : duckdb::Value(logical);
+                }
+                case Kind::Double: {
+                    double d;
+                    return value.get(d) == simdjson::SUCCESS ? duckdb::Value::DOUBLE(d) : duckdb::Value(logical);
+                }
+                case Kind::List: {
+                    simdjson::dom::array array;
+                    if (value.get(array) != simdjson::SUCCESS) return duckdb::Value(logical);
+                    std::vector<duckdb::Value> children;
+                    children.reserve(array.size());
+                    for (auto child : array) {
+                        children.push_back(toValue(child, typed.children[0]));
+                    }
+                    return duckdb::Value::LIST(typed.children[0].logical, std::move(children));
+                }
+                case Kind::Struct: {
+                    simdjson::dom::object object;
+                    if (value.get(object) != simdjson::SUCCESS) return duckdb::Value(logical);
+                    duckdb::child_list_t<duckdb::Value> children;
+                    const auto& fields = typed.type->fields;
+                    for (size_t i = 0; i < fields.size(); ++i) {
+                        simdjson::dom::element child;
+                        children.emplace_back(fields[i], object[fields[i]].get(child) == simdjson::SUCCESS
+                                                             ? toValue(child, typed.children[i])
+                                                             : duckdb::Value(typed.children[i].logical));
+                    }
+                    return duckdb::Value::STRUCT(std::move(children));
+                }
+                default:
+                    return duckdb::Value(jsonText(value));
+            }
+        }
+
+        struct Column {
+            std::string name;
+            ColumnType type;
+        };
+
+        void appendValue(duckdb::Appender& appender, simdjson::dom::element value, const Typed& typed) {
+            if (value.is_null()) {
+                appender.Append(nullptr);
+                return;
+            }
+            switch (typed.type->kind) {
+                case Kind::Varchar: {
+                    std::string_view sv;
+                    if (value.get(sv) == simdjson::SUCCESS) {
+                        appender.Append(sv.data(), static_cast<uint32_t>(sv.size()));
+                    } else {
+                        appender.Append(duckdb::Value(jsonText(value)));
+                    }
+                    return;
+                }
+                case Kind::BigInt: {
+                    int64_t n;
+                    if (value.get(n) == simdjson::SUCCESS) appender.Append(n); else appender.Append(nullptr);
+                    return;
+                }
+                case Kind::Double: {
+                    double d;
+                    if (value.get(d) == simdjson::SUCCESS) appender.Append(d); else appender.Append(nullptr);
+                    return;
+                }
+                case Kind::Boolean: {
+                    bool b;
+                    if (value.get(b) == simdjson::SUCCESS) appender.Append(b); else appender.Append(nullptr);
+                    return;
+                }
+                default:
+                    appender.Append(toValue(value, typed));
+            }
+        }
+    }
+
+    std::string CatalogImporter::ColumnType::sql() const {
+        switch (kind) {
+            case Kind::Boolean: return "BOOLEAN";
+            case Kind::BigInt: return "BIGINT";
+            case Kind::Double: return "DOUBLE";
+            case Kind::List: return children[0].sql() + "[]";
+            case Kind::Struct: {
+                std::string sql = "STRUCT(";
+                for (size_t i = 0; i < fields.size(); ++i) {
+                    if (i) sql += ", ";
+                    sql += quoteIdentifier(fields[i]) + " " + children[i].sql();
+                }
+                return sql + ")";
+            }
+            default: return "VARCHAR";
+        }
+    }
+
+    CatalogImporter::CatalogImporter(StorageEngine& engine)
+        : engine_(engine)
+    {
+    }
+
+    CatalogImportResult CatalogImporter::importFile(const std::string& path, const CatalogImportOptions& options) {
+        auto file = MappedFile::open(path, simdjson::SIMDJSON_PADDING);
+        if (!file) {
+            std::cerr << "[DB] Catalog Open Fail: " << path << std::endl;
+            return {};
+        }
+        return importPadded(file->view(), options);
+    }
+
+    CatalogImportResult CatalogImporter::importJson(std::string_view json, const CatalogImportOptions& options) {
+        simdjson::padded_string padded(json);
+        return importPadded(std::string_view(padded.data(), padded.size()), options);
+    }
+
+    CatalogImportResult CatalogImporter::importPadded(std::string_view json, const CatalogImportOptions& options) {
+        CatalogImportResult result;
+
+        simdjson::dom::parser parser;
+        simdjson::dom::array catalog;
+        auto error = parser.parse(reinterpret_cast<const uint8_t*>(json.data()), json.size(), false).get(catalog);
+        if (error) {
+            std::cerr << "[DB] Catalog Parse Fail: " << error << std::endl;
+            return result;
+        }
+
+        std::vector<simdjson::dom::object> rows;
+        rows.reserve(catalog.size());
+        for (auto element : catalog) {
+            simdjson::dom::object row;
+            if (element.get(row) == simdjson::SUCCESS) rows.push_back(row);
+        }
+
+        // Columns in order of first appearance; every row is scanned, so a
+        // key or a wider type met only near the end is not dropped
+        std::unordered_set<std::string_view> nested(options.nestedColumns.begin(), options.nestedColumns.end());
+        std::vector<Column> columns;
+        std::unordered_map<std::string_view, size_t> columnIndex;
+        for (const auto& row : rows) {
+            for (auto field : row) {
+                auto [it, inserted] = columnIndex.emplace(field.key, columns.size());
+                if (inserted) columns.push_back({std::string(field.key), {}});
+                widen(columns[it->second].type, field.value, nested.count(field.key) > 0, options.maxStructFields);
+            }
+        }
+        if (columns.empty()) {
+            std::cerr << "[DB] Catalog Import: no columns found" << std::endl;
+            return result;
+        }
+
+        std::string columnsSql;
+        std::vector<Typed> typed;
+        typed.reserve(columns.size());
+        for (size_t c = 0; c < columns.size(); ++c) {
+            settle(columns[c].type);
+            typed.emplace_back(columns[c].type);
+            if (c) columnsSql += ", ";
+            columnsSql += quoteIdentifier(columns[c].name) + " " + columns[c].type.sql();
+        }
+        createStatement_ = "CREATE TABLE " + quoteIdentifier(options.table) + " (" + columnsSql + ")";
+
+        // Appenders do not share a transaction: rows go to a staging table,
+        // which replaces the live one only once every writer has succeeded
+        std::string staging = quoteIdentifier(options.table + "__staging");
+        auto con = engine_.createConnection();
+        auto run = [&](const std::string& sql) {
+            auto done = con->Query(sql);
+            if (done->HasError()) {
+                std::cerr << "[DB] Catalog Schema Fail: " << done->GetError() << std::endl;
+                return false;
+            }
+            return true;
+        };
+        if (!run("DROP TABLE IF EXISTS " + staging) ||
+            !run("CREATE TABLE " + staging + " (" + columnsSql + ")")) {
+            return result;
+        }
+
+        std::optional<ThreadPool> ownPool;
+        ThreadPool* pool = options.pool;
+        if (!pool) {
+            ownPool.emplace(options.writers ? options.writers : std::max(1u, std::thread::hardware_concurrency()));
+            pool = &*ownPool;
+        }
+        size_t chunkRows = std::max<size_t>(options.chunkRows, 1);
+        size_t chunks = (rows.size() + chunkRows - 1) / chunkRows;
+        size_t writers = std::max<size_t>(1, std::min(options.writers ? options.writers : pool->size(), chunks));
+
+        std::atomic<size_t> nextChunk{0};
+        std::atomic<size_t> appended{0};
+        std::atomic<bool> failed{false};
+        pool->parallel_for(0, writers, [&](size_t) {
+            try {
+                auto writerCon = engine_.createConnection();
+                duckdb::Appender appender(*writerCon, options.table + "__staging");
+                std::vector<std::optional<simdjson::dom::element>> slots(columns.size());
+                size_t written = 0;
+
+                for (size_t chunk = nextChunk++; chunk < chunks && !failed; chunk = nextChunk++) {
+                    size_t end = std::min(rows.size(), (chunk + 1) * chunkRows);
+                    for (size_t r = chunk * chunkRows; r < end; ++r) {
+                        std::fill(slots.begin(), slots.end(), std::nullopt);
+                        for (auto field : rows[r]) {
+                            auto it = columnIndex.find(field.key);
+                            if (it != columnIndex.end()) slots[it->second] = field.value;
+                        }
+
+                        appender.BeginRow();
+                        for (size_t c = 0; c < columns.size(); ++c) {
+                            if (slots[c]) {
+                                appendValue(appender, *slots[c], typed[c]);
+                            } else {
+                                appender.Append(nullptr);
+                            }
+                        }
+                        appender.EndRow();
+                        ++written;
+                    }
+                }
+                appender.Close();
+                appended += written;
+            } catch (const std::exception& e) {
+                std::cerr << "[DB] Catalog Append Fail: " << e.what() << std::endl;
+                failed = true;
+            }
+        }, 1);
+
+        if (failed) {
+            run("DROP TABLE IF EXISTS " + staging);
+            return result;
+        }
+        if (!run("BEGIN TRANSACTION") ||
+            !run("DROP TABLE IF EXISTS " + quoteIdentifier(options.table)) ||
+            !run("ALTER TABLE " + staging + " RENAME TO " + quoteIdentifier(options.table)) ||
+            !run("COMMIT")) {
+            run("ROLLBACK");
+            run("DROP TABLE IF EXISTS " + staging);
+            return result;
+        }
+
+        result.ok = true;
+        result.rows = appended.load();
+        result.columns = columns.size();
+        return result;
+    }
+}
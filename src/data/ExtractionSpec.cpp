@@ -0,0 +1,136 @@
+#include "data/ExtractionSpec.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace civic {
+
+    namespace {
+        using Kind = ExtractedColumn::Kind;
+
+        std::string quoteIdentifier(std::string_view name) {
+            std::string quoted = "\"";
+            for (char c : name) {
+                if (c == '"') quoted += '"';
+                quoted += c;
+            }
+            return quoted + "\"";
+        }
+
+        std::string quoteLiteral(std::string_view text) {
+            std::string quoted = "'";
+            for (char c : text) {
+                if (c == '\'') quoted += '\'';
+                quoted += c;
+            }
+            return quoted + "'";
+        }
+
+        // Beyond this, seconds overflow DuckDB's microsecond timestamps
+        constexpr int64_t kMaxEpochSeconds = std::numeric_limits<int64_t>::max() / 1000000 - 1;
+
+        void appendText(duckdb::Appender& appender, std::string_view text) {
+            appender.Append(text.data(), static_cast<uint32_t>(text.size()));
+        }
+
+        // Appends exactly one value, NULL when the JSON value does not fit.
+        // Failing conversions are checked or caught before the Append, so a
+        // bad field never leaves the row half-built
+        void appendColumn(duckdb::Appender& appender, const ExtractedColumn& column, simdjson::dom::element value) {
+            std::string_view sv;
+            switch (column.kind) {
+                case Kind::Varchar:
+                    if (value.get(sv) == simdjson::SUCCESS) {
+                        appendText(appender, sv);
+                    } else {
+                        appendText(appender, simdjson::to_string(value));
+                    }
+                    return;
+                case Kind::BigInt: {
+                    int64_t n;
+                    if (value.get(n) == simdjson::SUCCESS) { appender.Append(n); return; }
+                    break;
+                }
+                case Kind::Double: {
+                    double d;
+                    if (value.get(d) == simdjson::SUCCESS) { appender.Append(d); return; }
+                    break;
+                }
+                case Kind::Boolean: {
+                    bool b;
+                    if (value.get(b) == simdjson::SUCCESS) { appender.Append(b); return; }
+                    break;
+                }
+                case Kind::Timestamp: {
+                    // ISO 8601 text, or seconds since the epoch
+                    int64_t seconds;
+                    duckdb::timestamp_t ts;
+                    try {
+                        if (value.get(seconds) == simdjson::SUCCESS) {
+                            if (seconds < -kMaxEpochSeconds || seconds > kMaxEpochSeconds) break;
+                            ts = duckdb::Timestamp::FromEpochSeconds(seconds);
+                        } else if (value.get(sv) == simdjson::SUCCESS) {
+                            ts = duckdb::Timestamp::FromString(std::string(sv));
+                        } else {
+                            break;
+                        }
+                    } catch (const std::exception&) {
+                        break;
+                    }
+                    appender.Append(ts);
+                    return;
+                }
+                case Kind::Enum:
+                    if (value.get(sv) == simdjson::SUCCESS &&
+                        std::find(column.enumValues.begin(), column.enumValues.end(), sv) != column.enumValues.end()) {
+                        appender.Append(duckdb::Value(std::string(sv)));
+                        return;
+                    }
+                    break;
+            }
+            appender.Append(nullptr);
+        }
+    }
+
+    std::string ExtractedColumn::sql() const {
+        switch (kind) {
+            case Kind::BigInt: return "BIGINT";
+            case Kind::Double: return "DOUBLE";
+            case Kind::Boolean: return "BOOLEAN";
+            case Kind::Timestamp: return "TIMESTAMP";
+            case Kind::Enum: {
+                std::string sql = "ENUM(";
+                for (size_t i = 0; i < enumValues.size(); ++i) {
+                    if (i) sql += ", ";
+                    sql += quoteLiteral(enumValues[i]);
+                }
+                return sql + ")";
+            }
+            default: return "VARCHAR";
+        }
+    }
+
+    std::string ExtractionSpec::createStatement() const {
+        std::string sql = "CREATE TABLE IF NOT EXISTS " + quoteIdentifier(table) + " (ingest_ts TIMESTAMP";
+        for (const auto& column : columns) {
+            sql += ", " + quoteIdentifier(column.name) + " " + column.sql();
+        }
+        if (keepRaw) sql += ", raw_data TEXT";
+        return sql + ")";
+    }
+
+    void ExtractionSpec::appendRow(duckdb::Appender& appender, duckdb::timestamp_t ts,
+                                   simdjson::dom::element document, std::string_view raw) const {
+        appender.BeginRow();
+        appender.Append(ts);
+        for (const auto& column : columns) {
+            simdjson::dom::element value;
+            if (document.at_pointer(column.pointer).get(value) == simdjson::SUCCESS && !value.is_null()) {
+                appendColumn(appender, column, value);
+            } else {
+                appender.Append(nullptr);
+            }
+        }
+        if (keepRaw) appendText(appender, raw);
+        appender.EndRow();
+    }
+}
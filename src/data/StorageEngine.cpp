@@ -1,13 +1,70 @@
 #include "data/StorageEngine.hpp"
+#include "core/MappedFile.hpp"
+#include "core/ThreadPool.hpp"
+#include <atomic>
+#include <functional>
+#include <optional>
 #include <iostream>
-#include <mutex>
+#include <thread>
 
 namespace civic {
 
-    static std::mutex g_writeMutex;
+    static_assert(kPayloadPadding >= simdjson::SIMDJSON_PADDING,
+                  "Payload padding must cover simdjson's over-read");
+
+    namespace {
+        duckdb::string_t toStringT(std::string_view sv) {
+            return duckdb::string_t(sv.data(), static_cast<uint32_t>(sv.size()));
+        }
+
+        std::string_view rawView(const std::string& raw) { return raw; }
+        std::string_view rawView(const Payload& raw) { return raw.view(); }
+
+        // Connection-based entry points have no writer to hang a parser on:
+        // each calling thread gets its own.
+        ParserContext& threadParser() {
+            thread_local ParserContext parser;
+            return parser;
+        }
+    }
+
+    ParserContext::ParserContext() {
+        if (parser_.allocate(kInitialCapacity) != simdjson::SUCCESS) {
+            std::cerr << "[DB] Parser preallocation failed" << std::endl;
+        }
+    }
+
+    bool ParserContext::extractFields(const std::string& rawJson, std::string_view& author, std::string_view& title) {
+        return extractFrom(parser_.parse(rawJson), author, title);
+    }
+
+    bool ParserContext::extractFields(const Payload& payload, std::string_view& author, std::string_view& title) {
+        if (payload.empty()) { return false; }
+        auto bytes = reinterpret_cast<const uint8_t*>(payload.data());
+        return extractFrom(parser_.parse(bytes, payload.size(), false), author, title);
+    }
+
+    bool ParserContext::extractFrom(simdjson::simdjson_result<simdjson::dom::element> parsed,
+                                    std::string_view& author, std::string_view& title) {
+        simdjson::dom::element doc;
+        auto err = std::move(parsed).get(doc);
+        if (err) { return false; }
+        document_ = doc;
+
+        author = "Unknown";
+        title = "Untitled";
+
+        simdjson::dom::element slideshow;
+        if (doc["slideshow"].get(slideshow) == simdjson::SUCCESS) {
+             std::string_view sv;
+             if (slideshow["author"].get(sv) == simdjson::SUCCESS) author = sv;
+             if (slideshow["title"].get(sv) == simdjson::SUCCESS) title = sv;
+        }
+        return true;
+    }
 
     StorageEngine::StorageEngine(const std::string& dbPath) 
-        : db_(dbPath == ":memory:" ? nullptr : dbPath.c_str()), parser_() 
+        : db_(dbPath == ":memory:" ? nullptr : dbPath.c_str()) 
     {
         duckdb::Connection con(db_);
 
@@ -40,34 +97,115 @@ namespace civic {
         return std::make_unique<duckdb::Connection>(db_);
     }
 
-    void StorageEngine::ingest(duckdb::Connection& con, const std::string& rawJson) {
-        std::lock_guard<std::mutex> lock(g_writeMutex);
-        
-        simdjson::padded_string padded = rawJson;
-        simdjson::dom::element doc;
-        auto err = parser_.parse(padded).get(doc);
-        if (err) { return; }
+    std::unique_ptr<WriterContext> StorageEngine::createWriter() {
+        return std::unique_ptr<WriterContext>(new WriterContext(*this));
+    }
 
-        std::string author = "Unknown", title = "Untitled";
-        
-        simdjson::dom::element slideshow;
-        if (doc["slideshow"].get(slideshow) == simdjson::SUCCESS) {
-             std::string_view sv;
-             if (slideshow["author"].get(sv) == simdjson::SUCCESS) author = std::string(sv);
-             if (slideshow["title"].get(sv) == simdjson::SUCCESS) title = std::string(sv);
+    bool StorageEngine::addExtraction(ExtractionSpec spec) {
+        duckdb::Connection con(db_);
+        auto result = con.Query(spec.createStatement());
+        if (result->HasError()) {
+            std::cerr << "[DB] Extraction Table Fail (" << spec.table << "): " << result->GetError() << std::endl;
+            return false;
         }
 
+        std::lock_guard lock(extractionsMutex_);
+        extractions_.push_back(std::make_shared<const ExtractionSpec>(std::move(spec)));
+        return true;
+    }
+
+    void StorageEngine::ingest(duckdb::Connection& con, const std::string& rawJson) {
+        std::string_view author, title;
+        if (!threadParser().extractFields(rawJson, author, title)) { return; }
+
         auto stmt = con.Prepare("INSERT INTO ingest_logs VALUES (now(), ?, ?, ?)");
         if(!stmt->success) {
             std::cerr << "[DB] Prepare Fail: " << stmt->error.Message() << std::endl;
             return;
         }
         
-        stmt->Execute(author, title, rawJson);
+        stmt->Execute(std::string(author), std::string(title), rawJson);
+    }
+
+    size_t StorageEngine::ingestBatch(duckdb::Connection& con, std::span<const std::string> payloads) {
+        if (payloads.empty()) { return 0; }
+
+        size_t rows = 0;
+        try {
+            duckdb::Appender appender(con, "ingest_logs");
+            auto ts = duckdb::Timestamp::GetCurrentTimestamp();
+            auto& parser = threadParser();
+
+            for (const auto& rawJson : payloads) {
+                std::string_view author, title;
+                if (!parser.extractFields(rawJson, author, title)) { continue; }
+
+                appender.BeginRow();
+                appender.Append(ts);
+                appender.Append(toStringT(author));
+                appender.Append(toStringT(title));
+                appender.Append(toStringT(rawJson));
+                appender.EndRow();
+                ++rows;
+            }
+            appender.Close();
+        } catch (const std::exception& e) {
+            std::cerr << "[DB] Batch Append Fail: " << e.what() << std::endl;
+            return 0;
+        }
+        return rows;
+    }
+
+    size_t StorageEngine::ingestNdjson(const std::string& path, const NdjsonOptions& options) {
+        auto file = MappedFile::open(path, simdjson::SIMDJSON_PADDING);
+        if (!file) {
+            std::cerr << "[DB] NDJSON Open Fail: " << path << std::endl;
+            return 0;
+        }
+        return ingestNdjsonPadded(file->view(), options);
+    }
+
+    size_t StorageEngine::ingestNdjsonBuffer(std::string_view ndjson, const NdjsonOptions& options) {
+        simdjson::padded_string padded(ndjson);
+        return ingestNdjsonPadded(std::string_view(padded.data(), padded.size()), options);
+    }
+
+    size_t StorageEngine::ingestNdjsonPadded(std::string_view ndjson, const NdjsonOptions& options) {
+        // Windows end just after a newline, so every document lies in exactly
+        // one of them; the bytes that follow a window (the next one, or the
+        // buffer's padding) cover simdjson's over-read
+        std::vector<std::string_view> windows;
+        size_t windowBytes = std::max<size_t>(options.windowBytes, 1);
+        for (size_t start = 0; start < ndjson.size(); ) {
+            size_t end = ndjson.find('\n', std::min(start + windowBytes, ndjson.size()) - 1);
+            end = (end == std::string_view::npos) ? ndjson.size() : end + 1;
+            windows.push_back(ndjson.substr(start, end - start));
+            start = end;
+        }
+        if (windows.empty()) { return 0; }
+
+        std::optional<ThreadPool> ownPool;
+        ThreadPool* pool = options.pool;
+        if (!pool) {
+            ownPool.emplace(options.writers ? options.writers : std::max(1u, std::thread::hardware_concurrency()));
+            pool = &*ownPool;
+        }
+        size_t writers = std::min(options.writers ? options.writers : pool->size(), windows.size());
+
+        // One writer (connection + appenders) per slot, not per window
+        std::atomic<size_t> next{0};
+        return pool->parallel_reduce(0, writers, size_t{0}, [&](size_t) {
+            auto writer = createWriter();
+            size_t written = 0;
+            for (size_t i = next++; i < windows.size(); i = next++) {
+                written += writer->appendNdjson(windows[i]);
+            }
+            writer->commit();
+            return written;
+        }, std::plus<>(), 1);
     }
 
     void StorageEngine::query(duckdb::Connection& con, const std::string& sql) {
-        std::lock_guard<std::mutex> lock(g_writeMutex);
         auto result = con.Query(sql);
         if (!result->HasError()) {
             result->Print();
@@ -75,4 +213,101 @@ namespace civic {
             std::cerr << "[DB] Query Error: " << result->GetError() << std::endl;
         }
     }
-}
\ No newline at end of file
+
+    WriterContext::WriterContext(StorageEngine& engine)
+        : con_(engine.db_), appender_(std::make_unique<duckdb::Appender>(con_, "ingest_logs"))
+    {
+        std::lock_guard lock(engine.extractionsMutex_);
+        extractions_ = engine.extractions_;
+        extractionAppenders_.resize(extractions_.size());
+    }
+
+    WriterContext::~WriterContext() {
+        try {
+            if (appender_) appender_->Close();
+            for (auto& appender : extractionAppenders_) {
+                if (appender) appender->Close();
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "[DB] Writer Close Fail: " << e.what() << std::endl;
+        }
+    }
+
+    template<typename T>
+    size_t WriterContext::appendRows(std::span<const T> payloads) {
+        size_t rows = 0;
+        auto ts = duckdb::Timestamp::GetCurrentTimestamp();
+        for (const auto& rawJson : payloads) {
+            std::string_view author, title;
+            if (!parser_.extractFields(rawJson, author, title)) { continue; }
+
+            if (appendRow(ts, rawView(rawJson), author, title)) { ++rows; }
+        }
+        pending_ += rows;
+        return rows;
+    }
+
+    bool WriterContext::appendRow(duckdb::timestamp_t ts, std::string_view raw,
+                                  std::string_view author, std::string_view title) {
+        std::unique_ptr<duckdb::Appender>* target = &appender_;
+        try {
+            std::string_view type;
+            if (!extractions_.empty() && parser_.document()["type"].get(type) == simdjson::SUCCESS) {
+                for (size_t i = 0; i < extractions_.size(); ++i) {
+                    if (extractions_[i]->type != type) { continue; }
+                    target = &extractionAppenders_[i];
+                    if (!*target) { *target = std::make_unique<duckdb::Appender>(con_, extractions_[i]->table); }
+                    extractions_[i]->appendRow(**target, ts, parser_.document(), raw);
+                    return true;
+                }
+            }
+
+            if (!appender_) { appender_ = std::make_unique<duckdb::Appender>(con_, "ingest_logs"); }
+            appender_->BeginRow();
+            appender_->Append(ts);
+            appender_->Append(toStringT(author));
+            appender_->Append(toStringT(title));
+            appender_->Append(toStringT(raw));
+            appender_->EndRow();
+            return true;
+        } catch (const std::exception& e) {
+            // A half-built row makes every later EndRow and Flush throw: the
+            // Appender is dropped, with its uncommitted rows, and recreated
+            // on the next document
+            std::cerr << "[DB] Writer Append Fail: " << e.what() << std::endl;
+            target->reset();
+            return false;
+        }
+    }
+
+    size_t WriterContext::append(std::span<const std::string> payloads) {
+        return appendRows(payloads);
+    }
+
+    size_t WriterContext::append(std::span<const Payload> payloads) {
+        return appendRows(payloads);
+    }
+
+    size_t WriterContext::appendNdjson(std::string_view ndjson) {
+        size_t rows = 0;
+        auto ts = duckdb::Timestamp::GetCurrentTimestamp();
+        parser_.extractMany(ndjson, [&](std::string_view raw, std::string_view author, std::string_view title) {
+            if (appendRow(ts, raw, author, title)) { ++rows; }
+        });
+        pending_ += rows;
+        return rows;
+    }
+
+    void WriterContext::commit() {
+        if (pending_ == 0) { return; }
+        try {
+            if (appender_) appender_->Flush();
+            for (auto& appender : extractionAppenders_) {
+                if (appender) appender->Flush();
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "[DB] Writer Commit Fail: " << e.what() << std::endl;
+        }
+        pending_ = 0;
+    }
+}
@@ -0,0 +1,115 @@
+#include "data/VerificationStore.hpp"
+#include <iostream>
+
+namespace civic {
+
+    namespace {
+        duckdb::Value optionalString(const std::optional<std::string>& value) {
+            return value ? duckdb::Value(*value) : duckdb::Value();
+        }
+
+        std::optional<std::string> readString(const duckdb::Value& value) {
+            if (value.IsNull()) return std::nullopt;
+            return value.ToString();
+        }
+    }
+
+    VerificationStore::VerificationStore(StorageEngine& engine)
+        : con_(engine.createConnection())
+    {
+        auto result = con_->Query(R"(
+            CREATE TABLE IF NOT EXISTS verification_cache (
+                url VARCHAR,
+                http_status INTEGER,
+                mime_type VARCHAR,
+                content_length BIGINT,
+                response_ms BIGINT,
+                etag VARCHAR,
+                last_modified VARCHAR,
+                verified_at_ms BIGINT
+            );
+        )");
+
+        if (result->HasError()) {
+            std::cerr << "[DB] Verification cache schema failed: " << result->GetError() << std::endl;
+        }
+    }
+
+    size_t VerificationStore::load(CacheVerification& cache) {
+        auto result = con_->Query(
+            "SELECT url, http_status, mime_type, content_length, response_ms, etag, last_modified, verified_at_ms "
+            "FROM verification_cache");
+        if (result->HasError()) {
+            std::cerr << "[DB] Verification cache load failed: " << result->GetError() << std::endl;
+            return 0;
+        }
+
+        std::vector<std::pair<std::string, EntreeVerification>> entries;
+        entries.reserve(result->RowCount());
+        for (duckdb::idx_t row = 0; row < result->RowCount(); ++row) {
+            EntreeVerification entry;
+            std::string url = result->GetValue(0, row).ToString();
+
+            auto& verification = entry.verification;
+            verification.resourceId = url;
+            verification.httpStatus = static_cast<int>(result->GetValue(1, row).GetValue<int32_t>());
+            verification.disponible = verification.httpStatus == 200;
+            verification.mimeTypeReel = readString(result->GetValue(2, row));
+            auto length = result->GetValue(3, row);
+            if (!length.IsNull()) verification.tailleReelle = length.GetValue<int64_t>();
+            verification.tempsReponse = std::chrono::milliseconds(result->GetValue(4, row).GetValue<int64_t>());
+
+            entry.etag = readString(result->GetValue(5, row));
+            entry.lastModified = readString(result->GetValue(6, row));
+            entry.verifieeLe = std::chrono::system_clock::time_point(
+                std::chrono::milliseconds(result->GetValue(7, row).GetValue<int64_t>()));
+
+            entries.emplace_back(std::move(url), std::move(entry));
+        }
+
+        size_t loaded = entries.size();
+        cache.importer(std::move(entries));
+        return loaded;
+    }
+
+    size_t VerificationStore::save(const CacheVerification& cache) {
+        auto entries = cache.exporter();
+
+        size_t rows = 0;
+        try {
+            con_->BeginTransaction();
+            auto cleared = con_->Query("DELETE FROM verification_cache");
+            if (cleared->HasError()) {
+                // Appending on top of the old rows would duplicate them at the next load
+                std::cerr << "[DB] Verification cache save failed: " << cleared->GetError() << std::endl;
+                if (con_->HasActiveTransaction()) con_->Rollback();
+                return 0;
+            }
+
+            duckdb::Appender appender(*con_, "verification_cache");
+            for (const auto& [url, entry] : entries) {
+                const auto& verification = entry.verification;
+                appender.BeginRow();
+                appender.Append(duckdb::Value(url));
+                appender.Append(static_cast<int32_t>(verification.httpStatus));
+                appender.Append(optionalString(verification.mimeTypeReel));
+                appender.Append(verification.tailleReelle ? duckdb::Value::BIGINT(*verification.tailleReelle)
+                                                          : duckdb::Value());
+                appender.Append(static_cast<int64_t>(verification.tempsReponse.count()));
+                appender.Append(optionalString(entry.etag));
+                appender.Append(optionalString(entry.lastModified));
+                appender.Append(static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    entry.verifieeLe.time_since_epoch()).count()));
+                appender.EndRow();
+                ++rows;
+            }
+            appender.Close();
+            con_->Commit();
+        } catch (const std::exception& e) {
+            std::cerr << "[DB] Verification cache save failed: " << e.what() << std::endl;
+            if (con_->HasActiveTransaction()) con_->Rollback();
+            return 0;
+        }
+        return rows;
+    }
+}
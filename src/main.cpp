@@ -5,30 +5,83 @@
 #include <iomanip>
 #include <vector>
 #include <sstream>
+#include <iterator>
+#include <algorithm>
+#include <csignal>
+#include <stop_token>
+#include <memory>
+#include "core/Payload.hpp"
 #include "core/RingBuffer.hpp"
 #include "core/ThreadPool.hpp"
 #include "data/StorageEngine.hpp"
+#include "data/CatalogImporter.hpp"
+#include "data/VerificationStore.hpp"
 #include "search/SearchService.hpp"
+#include "search/CacheVerification.hpp"
 
 std::atomic<bool> g_running{true};
 std::atomic<size_t> g_bytes_ingested{0};
 std::atomic<size_t> g_records_processed{0};
 
-void consumerWorker(civic::RingBuffer<std::string>& buffer, civic::StorageEngine& storage) {
-    auto con = storage.createConnection();
-    std::string payload;
-    while (g_running) {
-        if (buffer.pop(payload)) {
-            g_bytes_ingested += payload.size();
-            storage.ingest(*con, payload); 
-            g_records_processed++;
-        } else {
-            std::this_thread::yield();
+extern "C" void onSignal(int) {
+    g_running = false;
+}
+
+// Un seul thread pousse dans la file (mockProducer ou le thread principal
+// en mode recherche) : le côté producteur se passe de CAS. Les consommateurs
+// inactifs se garent au lieu de tourner à vide
+using IngestQueue = civic::SpmcRingBuffer<civic::Payload, civic::ParkingWait>;
+
+// Chaque consommateur a son propre writer (connexion + appender) et accumule
+// jusqu'à kBatchSize payloads ou kBatchWindow avant de committer
+constexpr size_t kBatchSize = 1024;
+constexpr auto kBatchWindow = std::chrono::milliseconds(20);
+
+void consumerWorker(std::stop_token stop, IngestQueue& buffer, civic::StorageEngine& storage) {
+    auto writer = storage.createWriter();
+    std::vector<civic::Payload> batch;
+    batch.reserve(kBatchSize);
+    auto batchStart = std::chrono::steady_clock::now();
+
+    auto flush = [&]() {
+        g_records_processed += writer->append(batch);
+        writer->commit();
+        batch.clear();
+    };
+
+    while (!stop.stop_requested()) {
+        // Attente bornée par la fenêtre du batch en cours, pour flusher à temps
+        auto timeout = kBatchWindow;
+        if (!batch.empty()) {
+            auto elapsed = std::chrono::steady_clock::now() - batchStart;
+            timeout = std::max(std::chrono::milliseconds(0),
+                               std::chrono::duration_cast<std::chrono::milliseconds>(kBatchWindow - elapsed));
+        }
+
+        size_t before = batch.size();
+        size_t popped = buffer.pop_bulk_wait(std::back_inserter(batch), kBatchSize - before, timeout);
+        if (popped > 0) {
+            if (before == 0) batchStart = std::chrono::steady_clock::now();
+            for (size_t i = before; i < batch.size(); ++i) {
+                g_bytes_ingested += batch[i].size();
+            }
         }
+
+        if (batch.size() >= kBatchSize ||
+            (!batch.empty() && std::chrono::steady_clock::now() - batchStart >= kBatchWindow)) {
+            flush();
+        }
+    }
+
+    // Arrêt : on vide ce qui reste dans la file avant le dernier commit
+    while (buffer.try_pop_bulk(std::back_inserter(batch), kBatchSize - batch.size()) > 0) {
+        if (batch.size() >= kBatchSize) flush();
     }
+    if (!batch.empty()) flush();
 }
 
-void mockProducer(civic::RingBuffer<std::string>& queue) {
+void mockProducer(IngestQueue& queue) {
+    civic::PayloadPool pool;
     std::string mock_json = R"({
         "slideshow": {
             "author": "HighFreq Bot", 
@@ -37,9 +90,13 @@ void mockProducer(civic::RingBuffer<std::string>& queue) {
         }
     })";
 
+    civic::Payload payload;
     while(g_running) {
-        if(!queue.push(mock_json)) {
-            std::this_thread::yield(); 
+        if (payload.empty()) {
+            payload = pool.copyOf(mock_json);
+        }
+        if (!queue.push_wait(std::move(payload))) {
+            break; // file fermée
         }
     }
 }
@@ -125,7 +182,7 @@ void afficherResultats(const civic::ResultatRecherche& resultats) {
 
 civic::ResultatRecherche lancerRecherche(
     civic::SearchService& searchService,
-    civic::RingBuffer<std::string>& queue,
+    IngestQueue& queue,
     const civic::CriteresRecherche& criteres,
     bool local
 ) {
@@ -137,12 +194,34 @@ civic::ResultatRecherche lancerRecherche(
     return resultats;
 }
 
+// Colonnes typées des payloads produits par ingererDataset
+civic::ExtractionSpec specRessourceDatagouv() {
+    using Kind = civic::ExtractedColumn::Kind;
+    civic::ExtractionSpec spec;
+    spec.type = "datagouv_resource";
+    spec.table = "datagouv_resources";
+    spec.columns = {
+        {"dataset_id", "/dataset_id", Kind::Varchar, {}},
+        {"resource_id", "/resource_id", Kind::Varchar, {}},
+        {"titre", "/titre", Kind::Varchar, {}},
+        {"url", "/url", Kind::Varchar, {}},
+        {"format", "/format", Kind::Enum, {}},
+        {"taille", "/taille", Kind::BigInt, {}},
+    };
+    for (auto format : {civic::FormatFichier::CSV, civic::FormatFichier::JSON, civic::FormatFichier::GEOJSON,
+                        civic::FormatFichier::PARQUET, civic::FormatFichier::XML}) {
+        spec.columns[4].enumValues.push_back(civic::SearchService::formatVersMimeType(format));
+    }
+    return spec;
+}
+
 void ingererDataset(
     civic::SearchService& searchService,
-    civic::RingBuffer<std::string>& queue,
+    IngestQueue& queue,
     const civic::JeuDeDonnees& dataset
 ) {
     std::cout << "\n[INGEST] Ingestion du dataset: " << dataset.titre << "\n";
+    static civic::PayloadPool pool;
     
     for (const auto& ressource : dataset.ressources) {
         // En mode local, on ne vérifie pas la ressource distante
@@ -161,14 +240,12 @@ void ingererDataset(
                  << "\"taille\":" << ressource.taille
                  << "}";
             
-            if (!queue.push(json.str())) {
-                std::cout << "  ! Buffer plein, attente...\n";
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                queue.push(json.str());
+            // Attend qu'un consommateur libère de la place ; échoue seulement
+            // si la file est fermée
+            if (!queue.push_wait(pool.copyOf(json.str()))) {
+                std::cerr << "  ✗ File d'ingestion fermée, ressources restantes ignorées\n";
+                return;
             }
-            
-            g_bytes_ingested += json.str().size();
-            g_records_processed++;
         // } else {
         //     std::cout << "  ✗ Ressource indisponible (HTTP " << verification.httpStatus << "): " 
         //               << ressource.titre << "\n";
@@ -178,7 +255,7 @@ void ingererDataset(
 
 void modeRechercheInteractif(
     civic::SearchService& searchService,
-    civic::RingBuffer<std::string>& queue,
+    IngestQueue& queue,
     bool local
 ) {
     std::cout << "\n";
@@ -325,6 +402,10 @@ int main(int argc, char* argv[]) {
     bool modeDemo = false;
     bool modeLocal = false;
     std::string requeteDirecte;
+    std::string cheminCache;
+    std::string cheminCatalogue;
+    std::string baseImport;
+    bool parserDom = false;
     
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
@@ -339,6 +420,20 @@ int main(int argc, char* argv[]) {
                 requeteDirecte = argv[++i];
                 modeRecherche = true;
             }
+        } else if (arg == "--catalog") {
+            if (i + 1 < argc) {
+                cheminCatalogue = argv[++i];
+            }
+        } else if (arg == "--cache-db") {
+            if (i + 1 < argc) {
+                cheminCache = argv[++i];
+            }
+        } else if (arg == "--import-catalog") {
+            if (i + 1 < argc) {
+                baseImport = argv[++i];
+            }
+        } else if (arg == "--dom-parser") {
+            parserDom = true;
         } else if (arg == "--help" || arg == "-h") {
             std::cout << "Usage: " << argv[0] << " [OPTIONS]\n\n";
             std::cout << "Options:\n";
@@ -346,6 +441,10 @@ int main(int argc, char* argv[]) {
             std::cout << "  -q, --query TEXT   Recherche directe avec le texte spécifié\n";
             std::cout << "  -d, --demo         Mode démo (recherche exemple)\n";
             std::cout << "  -l, --local        Mode recherche locale (utilise data_enriched.json)\n";
+            std::cout << "      --catalog F    Catalogue JSON de la recherche locale (défaut: /data_enriched.json)\n";
+            std::cout << "      --cache-db F   Conserve le cache des vérifications dans la base DuckDB F\n";
+            std::cout << "      --import-catalog F  Charge le catalogue dans la table datasets_enriched de la base DuckDB F\n";
+            std::cout << "      --dom-parser   Analyse les réponses de l'API avec l'ancien parseur DOM\n";
             std::cout << "  -h, --help         Affiche cette aide\n";
             std::cout << "\nExemples:\n";
             std::cout << "  " << argv[0] << " --search\n";
@@ -357,12 +456,50 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    if (!baseImport.empty()) {
+        if (cheminCatalogue.empty()) {
+            cheminCatalogue = civic::SearchService::cheminCatalogueParDefaut;
+        }
+        civic::StorageEngine base(baseImport);
+        civic::CatalogImporter importer(base);
+        auto debut = std::chrono::steady_clock::now();
+        auto resultat = importer.importFile(cheminCatalogue);
+        std::chrono::duration<double> duree = std::chrono::steady_clock::now() - debut;
+        if (!resultat.ok) {
+            std::cerr << "[IMPORT] Échec de l'import de " << cheminCatalogue << std::endl;
+            return 1;
+        }
+        std::cout << "[IMPORT] " << resultat.rows << " jeux, " << resultat.columns << " colonnes en "
+                  << std::fixed << std::setprecision(2) << duree.count() << " s -> " << baseImport << std::endl;
+        return 0;
+    }
+
     civic::StorageEngine storage(":memory:");
-    civic::RingBuffer<std::string> queue(8192);
+    storage.addExtraction(specRessourceDatagouv());
+    IngestQueue queue(8192);
     civic::SearchService searchService;
+    if (!cheminCatalogue.empty()) {
+        searchService.setCheminCatalogue(cheminCatalogue);
+    }
+    searchService.setParserDom(parserDom);
+
+    std::unique_ptr<civic::StorageEngine> cacheStorage;
+    std::unique_ptr<civic::VerificationStore> cacheStore;
+    if (!cheminCache.empty()) {
+        cacheStorage = std::make_unique<civic::StorageEngine>(cheminCache);
+        cacheStore = std::make_unique<civic::VerificationStore>(*cacheStorage);
+        std::cout << "[CACHE] " << cacheStore->load(searchService.cacheVerification())
+                  << " vérifications rechargées" << std::endl;
+    }
 
     if (modeRecherche || modeDemo) {
-        
+        // Un consommateur écrit les ressources ingérées : elles passent par
+        // un writer, donc par la table typée de specRessourceDatagouv
+        civic::ThreadPool consumerPool(1);
+        consumerPool.startService([&queue, &storage](std::stop_token stop) {
+            consumerWorker(stop, queue, storage);
+        });
+
         if (modeDemo) {
             std::cout << "\n[DEMO] Recherche: 'INSEE population' - sources certifiées uniquement\n";
             
@@ -404,15 +541,43 @@ int main(int argc, char* argv[]) {
         } else {
             modeRechercheInteractif(searchService, queue, modeLocal);
         }
-        
+
+        queue.close();
+        consumerPool.stop();
+        if (g_records_processed > 0) {
+            std::cout << "\n[INGEST] " << g_records_processed.load() << " ressources écrites :\n";
+            auto con = storage.createConnection();
+            storage.query(*con, "SELECT format, COUNT(*) AS ressources, SUM(taille) AS octets "
+                                "FROM datagouv_resources GROUP BY format ORDER BY ressources DESC");
+        }
+
+        if (cacheStore) {
+            std::cout << "[CACHE] " << cacheStore->save(searchService.cacheVerification())
+                      << " vérifications sauvegardées" << std::endl;
+        }
         return 0;
     }
 
-    unsigned int num_workers = std::max(1u, std::thread::hardware_concurrency() - 2);
-    civic::ThreadPool consumerPool(num_workers);
-    consumerPool.setTask([&queue, &storage](){ 
-        consumerWorker(queue, storage); 
-    });
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    // Seuls les cœurs autorisés (affinité du processus, cpuset) comptent.
+    // Les consommateurs sont épinglés d'abord sur le socket du premier
+    // (topologie lue dans sysfs), qui reste au producteur et au monitoring
+    auto cpus = civic::cpusBySocket();
+    unsigned int cores = static_cast<unsigned int>(cpus.size());
+    unsigned int num_workers = std::max(1u, cores > 2 ? cores - 2 : 1u);
+    if (cpus.size() > 1) cpus.erase(cpus.begin());
+    // Les consommateurs sont des services (un thread chacun) : le pool ne
+    // garde qu'un worker pour les tâches courtes
+    civic::ThreadPool consumerPool(1);
+    for (unsigned int i = 0; i < num_workers; ++i) {
+        civic::ServiceOptions options;
+        options.cpu = static_cast<int>(cpus[i % cpus.size()]);
+        consumerPool.startService([&queue, &storage](std::stop_token stop) {
+            consumerWorker(stop, queue, storage);
+        }, options);
+    }
     
     std::cout << "[INIT] Workers: " << num_workers << " | Storage: RAM (Zero-Latency)" << std::endl;
     std::cout << "[INFO] Utilisez --search pour le mode recherche ou --help pour l'aide" << std::endl;
@@ -421,6 +586,10 @@ int main(int argc, char* argv[]) {
 
     monitoringLoop();
 
+    std::cout << "\n[SHUTDOWN] Arrêt demandé, vidage de la file..." << std::endl;
+    queue.close();
     if (producerThread.joinable()) producerThread.join();
+    consumerPool.stop();
+    std::cout << "[SHUTDOWN] " << g_records_processed.load() << " enregistrements ingérés" << std::endl;
     return 0;
 }
@@ -0,0 +1,98 @@
+#include "search/CacheRecherche.hpp"
+
+namespace civic {
+
+    CacheRecherche::CacheRecherche(size_t capaciteOctets, std::chrono::seconds ttl)
+        : entrees_(capaciteOctets), ttlSecondes_(ttl.count())
+    {
+    }
+
+    size_t CacheRecherche::estimerPoids(const ResultatRecherche& resultat) {
+        size_t poids = sizeof(ResultatRecherche) + resultat.requeteAPI.size();
+        for (const auto& jeu : resultat.jeux) {
+            // Les symboles (organisation, licence, mime) sont partagés
+            // par tous les résultats : seul le pointeur compte
+            poids += sizeof(JeuDeDonnees)
+                   + jeu.id.size() + jeu.slug.size() + jeu.titre.size() + jeu.description.size();
+            for (const auto& tag : jeu.tags) {
+                poids += sizeof(std::string) + tag.size();
+            }
+            for (const auto& ressource : jeu.ressources) {
+                poids += sizeof(Ressource)
+                       + ressource.id.size() + ressource.titre.size() + ressource.description.size()
+                       + ressource.url.size()
+                       + (ressource.schema ? ressource.schema->size() : 0);
+            }
+        }
+        return poids;
+    }
+
+    std::optional<ResultatRecherche> CacheRecherche::fraiche(const std::string& cle) {
+        auto entree = entrees_.get(cle);
+        if (!entree || std::chrono::steady_clock::now() - entree->stockeeLe >= ttl()) {
+            return std::nullopt;
+        }
+        return std::move(entree->resultat);
+    }
+
+    CacheRecherche::Acces CacheRecherche::acquerir(const std::string& cle, Attente attente) {
+        Acces acces;
+        if ((acces.resultat = fraiche(cle))) {
+            trouvees_.fetch_add(1, std::memory_order_relaxed);
+            return acces;
+        }
+
+        std::lock_guard<std::mutex> lock(volsMutex_);
+        auto vol = vols_.find(cle);
+        if (vol == vols_.end()) {
+            // Publié entre la première lecture et la prise du verrou
+            if ((acces.resultat = fraiche(cle))) {
+                trouvees_.fetch_add(1, std::memory_order_relaxed);
+                return acces;
+            }
+            vol = vols_.emplace(cle, std::map<IdAttente, Attente>{}).first;
+            acces.meneur = true;
+            manquees_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            partagees_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        acces.attente = prochaineAttente_++;
+        vol->second.emplace(acces.attente, std::move(attente));
+        return acces;
+    }
+
+    std::optional<CacheRecherche::Attente> CacheRecherche::retirer(const std::string& cle, IdAttente id) {
+        std::lock_guard<std::mutex> lock(volsMutex_);
+        auto vol = vols_.find(cle);
+        if (vol == vols_.end()) return std::nullopt;
+        auto it = vol->second.find(id);
+        if (it == vol->second.end()) return std::nullopt;
+
+        auto attente = std::move(it->second);
+        vol->second.erase(it);
+        return attente;
+    }
+
+    void CacheRecherche::publier(const std::string& cle, std::optional<ResultatRecherche> resultat) {
+        if (resultat) {
+            size_t poids = estimerPoids(*resultat);
+            entrees_.put(cle, Entree{*resultat, std::chrono::steady_clock::now()}, poids);
+        }
+
+        std::map<IdAttente, Attente> attentes;
+        {
+            std::lock_guard<std::mutex> lock(volsMutex_);
+            auto vol = vols_.find(cle);
+            if (vol == vols_.end()) return;
+            attentes = std::move(vol->second);
+            vols_.erase(vol);
+        }
+
+        // Hors verrou : une attente peut relancer une recherche
+        for (auto& [id, attente] : attentes) {
+            attente(resultat);
+        }
+    }
+
+}
@@ -0,0 +1,107 @@
+#include "search/CacheVerification.hpp"
+
+namespace civic {
+
+    namespace {
+        VerificationRessource versVerification(const std::string& url, ReponseHttp& reponse) {
+            VerificationRessource result;
+            result.resourceId = url;
+            result.httpStatus = reponse.status;
+            result.disponible = reponse.status == 200;
+            result.mimeTypeReel = std::move(reponse.contentType);
+            result.tailleReelle = reponse.contentLength;
+            result.tempsReponse = reponse.duree;
+            return result;
+        }
+    }
+
+    CacheVerification::CacheVerification(size_t capacite, std::chrono::seconds ttl)
+        : entrees_(capacite), ttlSecondes_(ttl.count())
+    {
+    }
+
+    bool CacheVerification::estFraiche(const EntreeVerification& entree) const {
+        return std::chrono::system_clock::now() - entree.verifieeLe < ttl();
+    }
+
+    std::optional<VerificationRessource> CacheVerification::consulter(const std::string& url, OptionsRequete& options) {
+        auto trouvee = entrees_.get(url);
+        if (trouvee && estFraiche(*trouvee)) {
+            servies_.fetch_add(1, std::memory_order_relaxed);
+            trouvee->verification.resourceId = url;
+            return std::move(trouvee->verification);
+        }
+
+        requetes_.fetch_add(1, std::memory_order_relaxed);
+        if (trouvee) {
+            if (trouvee->etag) {
+                options.entetes.emplace_back("If-None-Match", *trouvee->etag);
+            }
+            if (trouvee->lastModified) {
+                options.entetes.emplace_back("If-Modified-Since", *trouvee->lastModified);
+            }
+        }
+        return std::nullopt;
+    }
+
+    VerificationRessource CacheVerification::integrer(const std::string& url, ReponseHttp reponse) {
+        auto maintenant = std::chrono::system_clock::now();
+
+        if (reponse.status == 304) {
+            auto precedente = entrees_.get(url);
+            if (!precedente) {
+                // Évincée entre-temps : la ressource existe, sans métadonnées
+                reponse.status = 200;
+                return versVerification(url, reponse);
+            }
+
+            revalidees_.fetch_add(1, std::memory_order_relaxed);
+            precedente->verifieeLe = maintenant;
+            if (reponse.etag) precedente->etag = reponse.etag;
+            if (reponse.lastModified) precedente->lastModified = reponse.lastModified;
+            precedente->verification.resourceId = url;
+            precedente->verification.tempsReponse = reponse.duree;
+
+            auto verification = precedente->verification;
+            entrees_.put(url, std::move(*precedente));
+            return verification;
+        }
+
+        EntreeVerification entree;
+        entree.etag = reponse.etag;
+        entree.lastModified = reponse.lastModified;
+        entree.verifieeLe = maintenant;
+        entree.verification = versVerification(url, reponse);
+
+        // Les échecs réseau et les erreurs serveur sont transitoires : on ne
+        // les garde pas, l'ancienne entrée sera revalidée au prochain passage
+        if (entree.verification.httpStatus != 0 && entree.verification.httpStatus < 500) {
+            entrees_.put(url, entree);
+        }
+        return entree.verification;
+    }
+
+    void CacheVerification::enregistrer(const std::string& url, EntreeVerification entree) {
+        entrees_.put(url, std::move(entree));
+    }
+
+    std::optional<EntreeVerification> CacheVerification::entree(const std::string& url) {
+        return entrees_.get(url);
+    }
+
+    std::vector<std::pair<std::string, EntreeVerification>> CacheVerification::exporter() const {
+        std::vector<std::pair<std::string, EntreeVerification>> resultat;
+        resultat.reserve(entrees_.size());
+        entrees_.forEach([&](const std::string& url, const EntreeVerification& entree) {
+            resultat.emplace_back(url, entree);
+        });
+        return resultat;
+    }
+
+    void CacheVerification::importer(std::vector<std::pair<std::string, EntreeVerification>> entrees) {
+        for (auto& [url, entree] : entrees) {
+            entrees_.put(url, std::move(entree));
+        }
+    }
+
+}
@@ -0,0 +1,524 @@
+#include "search/HttpsClient.hpp"
+#include <atomic>
+#include <future>
+#include <limits>
+#include <map>
+#include <regex>
+#include <thread>
+
+#include <boost/beast.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+
+namespace civic {
+
+    namespace beast = boost::beast;
+    namespace http = beast::http;
+    namespace net = boost::asio;
+    namespace ssl = net::ssl;
+    using tcp = net::ip::tcp;
+
+    namespace {
+        struct Cible {
+            std::string host;
+            std::string port;
+            std::string path;
+        };
+
+        std::optional<Cible> decouperUrl(const std::string& url) {
+            static const std::regex urlRegex(R"((https?)://([^/:]+)(?::(\d+))?(/.*)?)", std::regex::icase);
+            std::smatch match;
+            if (!std::regex_match(url, match, urlRegex)) {
+                return std::nullopt;
+            }
+
+            Cible cible{match[2].str(), match[3].str(), match[4].str()};
+            if (cible.port.empty()) {
+                cible.port = (match[1].str() == "https") ? "443" : "80";
+            }
+            if (cible.path.empty()) {
+                cible.path = "/";
+            }
+            return cible;
+        }
+
+        using SessionTls = std::shared_ptr<SSL_SESSION>;
+        using Strand = net::strand<net::io_context::executor_type>;
+
+        struct Connexion {
+            Connexion(Strand& strand, ssl::context& ctx) : stream(strand, ctx) {}
+
+            beast::ssl_stream<beast::tcp_stream> stream;
+            beast::flat_buffer buffer;
+            std::chrono::steady_clock::time_point dernierUsage;
+        };
+    }
+
+    struct HttpsClient::Runtime {
+        net::io_context ioc{1};
+        net::executor_work_guard<net::io_context::executor_type> travail = net::make_work_guard(ioc);
+        std::thread thread;
+    };
+
+    // Tout l'état partagé (pool, sessions, requêtes en cours) n'est touché
+    // que depuis le strand.
+    struct HttpsClient::Impl : std::enable_shared_from_this<HttpsClient::Impl> {
+        Impl(net::io_context& ioc, HttpsClientOptions opts)
+            : strand(net::make_strand(ioc)), ctx(ssl::context::tls_client), options(opts)
+        {
+            ctx.set_default_verify_paths();
+            ctx.set_verify_mode(ssl::verify_none); // réglé connexion par connexion
+            SSL_CTX_set_session_cache_mode(ctx.native_handle(),
+                                           SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        }
+
+        std::shared_ptr<Connexion> prendre(const std::string& cle) {
+            auto it = inactives.find(cle);
+            if (it == inactives.end()) return nullptr;
+
+            auto now = std::chrono::steady_clock::now();
+            auto& pile = it->second;
+            while (!pile.empty()) {
+                auto conn = std::move(pile.back());
+                pile.pop_back();
+                if (now - conn->dernierUsage < options.dureeInactiviteMax &&
+                    beast::get_lowest_layer(conn->stream).socket().is_open()) {
+                    return conn;
+                }
+                fermer(*conn);
+            }
+            return nullptr;
+        }
+
+        void rendre(const std::string& cle, std::shared_ptr<Connexion> conn) {
+            if (arrete) {
+                fermer(*conn);
+                return;
+            }
+            auto& pile = inactives[cle];
+            if (pile.size() >= options.maxConnexionsInactivesParHote) {
+                fermer(*pile.front());
+                pile.erase(pile.begin());
+            }
+            beast::get_lowest_layer(conn->stream).expires_never();
+            conn->dernierUsage = std::chrono::steady_clock::now();
+            pile.push_back(std::move(conn));
+        }
+
+        static void fermer(Connexion& conn) {
+            // Marque la connexion comme terminée proprement : sans cela
+            // OpenSSL invalide la session et elle ne peut plus être reprise
+            SSL_set_shutdown(conn.stream.native_handle(), SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+            beast::get_lowest_layer(conn.stream).close();
+        }
+
+        void memoriserSession(const std::string& cle, SSL* ssl) {
+            SSL_SESSION* session = SSL_get1_session(ssl);
+            if (!session) return;
+            if (!SSL_SESSION_is_resumable(session)) {
+                SSL_SESSION_free(session);
+                return;
+            }
+            sessions[cle] = SessionTls(session, SSL_SESSION_free);
+        }
+
+        void arreter();
+
+        Strand strand;
+        ssl::context ctx;
+        HttpsClientOptions options;
+
+        std::map<std::string, tcp::resolver::results_type> dns;
+        std::map<std::string, std::vector<std::shared_ptr<Connexion>>> inactives;
+        // Une session n'est reprise que dans le même mode de vérification :
+        // une session négociée sans vérifier le certificat ne doit pas en dispenser
+        std::map<std::string, SessionTls> sessions;
+        std::map<IdRequete, std::shared_ptr<Requete>> enCours;
+        bool arrete = false;
+
+        std::atomic<IdRequete> prochainId{1};
+
+        std::atomic<size_t> connexions{0};
+        std::atomic<size_t> reprises{0};
+    };
+
+    class HttpsClient::Requete : public std::enable_shared_from_this<HttpsClient::Requete> {
+    public:
+        Requete(std::shared_ptr<Impl> impl, IdRequete id, MethodeHttp methode, Cible cible,
+                OptionsRequete options, HttpsClient::Callback callback)
+            : impl_(std::move(impl)), id_(id), methode_(methode), cible_(std::move(cible)),
+              options_(std::move(options)), callback_(std::move(callback)),
+              cle_(cible_.host + ":" + cible_.port + (options_.verifierCertificat ? "|v" : "")),
+              resolver_(impl_->strand), minuterie_(impl_->strand),
+              debut_(std::chrono::steady_clock::now()),
+              echeance_(debut_ + options_.timeout)
+        {
+        }
+
+        void demarrer() {
+            // Couvre aussi la résolution DNS, que le tcp_stream ne borne pas
+            minuterie_.expires_at(echeance_);
+            minuterie_.async_wait([self = shared_from_this()](beast::error_code ec) {
+                if (ec || self->termine_) return;
+                self->expiree_ = true;
+                self->annuler();
+            });
+
+            conn_ = impl_->prendre(cle_);
+            if (conn_) {
+                reponse_.connexionReutilisee = true;
+                ecrire();
+                return;
+            }
+            connexionNeuve();
+        }
+
+        void annuler() {
+            annulee_ = true;
+            resolver_.cancel();
+            if (conn_) {
+                beast::get_lowest_layer(conn_->stream).cancel();
+            }
+        }
+
+    private:
+        // Une annulation peut tomber entre deux opérations, quand il n'y a
+        // rien à interrompre sur le socket : chaque étape la vérifie
+        beast::error_code interrompue(beast::error_code ec) const {
+            return (!ec && annulee_) ? beast::error_code(net::error::operation_aborted) : ec;
+        }
+
+        void connexionNeuve() {
+            reponse_.connexionReutilisee = false;
+            conn_ = std::make_shared<Connexion>(impl_->strand, impl_->ctx);
+
+            auto* ssl = conn_->stream.native_handle();
+            if (!SSL_set_tlsext_host_name(ssl, cible_.host.c_str())) {
+                echec(beast::error_code{static_cast<int>(::ERR_get_error()), net::error::get_ssl_category()}, "SNI");
+                return;
+            }
+            if (options_.verifierCertificat) {
+                conn_->stream.set_verify_mode(ssl::verify_peer);
+                conn_->stream.set_verify_callback(ssl::host_name_verification(cible_.host));
+            }
+            if (auto it = impl_->sessions.find(cle_); it != impl_->sessions.end()) {
+                SSL_set_session(ssl, it->second.get());
+            }
+
+            auto cleDns = cible_.host + ":" + cible_.port;
+            if (auto it = impl_->dns.find(cleDns); it != impl_->dns.end()) {
+                connecter(it->second);
+                return;
+            }
+            resolver_.async_resolve(cible_.host, cible_.port,
+                [self = shared_from_this(), cleDns](beast::error_code ec, tcp::resolver::results_type results) {
+                    ec = self->interrompue(ec);
+                    if (ec) {
+                        self->echec(ec, "Résolution");
+                        return;
+                    }
+                    self->impl_->dns[cleDns] = results;
+                    self->connecter(results);
+                });
+        }
+
+        void connecter(const tcp::resolver::results_type& endpoints) {
+            beast::get_lowest_layer(conn_->stream).expires_at(echeance_);
+            beast::get_lowest_layer(conn_->stream).async_connect(endpoints,
+                [self = shared_from_this()](beast::error_code ec, tcp::endpoint) {
+                    ec = self->interrompue(ec);
+                    if (ec) {
+                        self->impl_->dns.erase(self->cible_.host + ":" + self->cible_.port);
+                        self->echec(ec, "Connexion");
+                        return;
+                    }
+                    self->impl_->connexions.fetch_add(1, std::memory_order_relaxed);
+                    self->conn_->stream.async_handshake(ssl::stream_base::client,
+                        beast::bind_front_handler(&Requete::onHandshake, self));
+                });
+        }
+
+        void onHandshake(beast::error_code ec) {
+            ec = interrompue(ec);
+            if (ec) {
+                echec(ec, "Handshake");
+                return;
+            }
+            if (SSL_session_reused(conn_->stream.native_handle())) {
+                reponse_.sessionReprise = true;
+                impl_->reprises.fetch_add(1, std::memory_order_relaxed);
+            }
+            ecrire();
+        }
+
+        void ecrire() {
+            req_ = {};
+            req_.version(11);
+            req_.method(methode_ == MethodeHttp::HEAD ? http::verb::head : http::verb::get);
+            req_.target(cible_.path);
+            req_.set(http::field::host, cible_.host);
+            req_.set(http::field::user_agent, "CivicCore-HyperIngest/1.0");
+            for (const auto& [nom, valeur] : options_.entetes) {
+                req_.set(nom, valeur);
+            }
+            req_.keep_alive(true);
+
+            beast::get_lowest_layer(conn_->stream).expires_at(echeance_);
+            http::async_write(conn_->stream, req_,
+                [self = shared_from_this()](beast::error_code ec, std::size_t) {
+                    ec = self->interrompue(ec);
+                    if (ec) {
+                        self->echec(ec, "Écriture");
+                        return;
+                    }
+                    self->lire();
+                });
+        }
+
+        void lire() {
+            parser_.emplace();
+            parser_->body_limit(options_.tailleMaxCorps);
+            if (methode_ == MethodeHttp::HEAD) {
+                parser_->skip(true); // Content-Length annonce un corps qui ne viendra pas
+            }
+
+            http::async_read_header(conn_->stream, conn_->buffer, *parser_,
+                beast::bind_front_handler(&Requete::onHeader, shared_from_this()));
+        }
+
+        void onHeader(beast::error_code ec, std::size_t) {
+            ec = interrompue(ec);
+            if (ec) {
+                echec(ec, "Lecture");
+                return;
+            }
+
+            // body_limit ne s'applique qu'au corps lu au fil de l'eau avec
+            // certaines versions de Beast : le Content-Length annoncé est
+            // vérifié ici, avant de lire quoi que ce soit
+            auto longueur = parser_->content_length();
+            if (methode_ != MethodeHttp::HEAD && longueur && *longueur > options_.tailleMaxCorps) {
+                echec(http::error::body_limit, "Lecture");
+                return;
+            }
+
+            http::async_read(conn_->stream, conn_->buffer, *parser_,
+                beast::bind_front_handler(&Requete::onRead, shared_from_this()));
+        }
+
+        void onRead(beast::error_code ec, std::size_t) {
+            ec = interrompue(ec);
+            if (ec) {
+                echec(ec, "Lecture");
+                return;
+            }
+
+            auto& res = parser_->get();
+            reponse_.status = res.result_int();
+            reponse_.corps = std::move(res.body());
+            if (auto it = res.find(http::field::content_type); it != res.end()) {
+                reponse_.contentType = std::string(it->value());
+            }
+            if (auto it = res.find(http::field::content_length); it != res.end()) {
+                try {
+                    reponse_.contentLength = std::stoll(std::string(it->value()));
+                } catch (...) {}
+            }
+            if (auto it = res.find(http::field::etag); it != res.end()) {
+                reponse_.etag = std::string(it->value());
+            }
+            if (auto it = res.find(http::field::last_modified); it != res.end()) {
+                reponse_.lastModified = std::string(it->value());
+            }
+
+            // Avec TLS 1.3 les tickets arrivent après le handshake : la session
+            // n'est complète qu'une fois des données applicatives lues
+            impl_->memoriserSession(cle_, conn_->stream.native_handle());
+
+            if (res.keep_alive()) {
+                impl_->rendre(cle_, std::move(conn_));
+            } else {
+                HttpsClient::Impl::fermer(*conn_);
+                conn_.reset();
+            }
+            terminer();
+        }
+
+        void echec(beast::error_code ec, const char* etape) {
+            if (conn_) {
+                HttpsClient::Impl::fermer(*conn_);
+                conn_.reset();
+            }
+
+            // Une connexion du pool a pu être fermée par le serveur pendant
+            // qu'elle dormait : on retente une fois sur une connexion neuve
+            // (sauf corps trop gros, qui échouerait de nouveau)
+            if (reponse_.connexionReutilisee && !relancee_ && !annulee_ && !impl_->arrete &&
+                ec != http::error::body_limit &&
+                std::chrono::steady_clock::now() < echeance_) {
+                relancee_ = true;
+                connexionNeuve();
+                return;
+            }
+
+            reponse_.status = 0;
+            if (expiree_ || ec == beast::error::timeout) {
+                reponse_.erreur = std::string(etape) + ": timeout";
+            } else if (annulee_) {
+                reponse_.erreur = std::string(etape) + ": annulée";
+            } else {
+                reponse_.erreur = std::string(etape) + ": " + ec.message();
+            }
+            terminer();
+        }
+
+        void terminer() {
+            termine_ = true;
+            minuterie_.cancel();
+            reponse_.duree = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - debut_);
+            auto self = shared_from_this();
+            impl_->enCours.erase(id_);
+            if (callback_) {
+                callback_(std::move(reponse_));
+            }
+        }
+
+        std::shared_ptr<HttpsClient::Impl> impl_;
+        IdRequete id_;
+        MethodeHttp methode_;
+        Cible cible_;
+        OptionsRequete options_;
+        HttpsClient::Callback callback_;
+        std::string cle_;
+
+        tcp::resolver resolver_;
+        net::steady_timer minuterie_;
+        std::shared_ptr<Connexion> conn_;
+        http::request<http::empty_body> req_;
+        std::optional<http::response_parser<http::string_body>> parser_;
+        ReponseHttp reponse_;
+
+        std::chrono::steady_clock::time_point debut_;
+        std::chrono::steady_clock::time_point echeance_;
+        bool relancee_ = false;
+        bool annulee_ = false;
+        bool expiree_ = false;
+        bool termine_ = false;
+    };
+
+    void HttpsClient::Impl::arreter() {
+        arrete = true;
+        auto requetes = enCours;
+        for (const auto& [id, requete] : requetes) {
+            requete->annuler();
+        }
+        for (auto& [cle, pile] : inactives) {
+            for (auto& conn : pile) fermer(*conn);
+        }
+        inactives.clear();
+        sessions.clear();
+    }
+
+    HttpsClient::HttpsClient(HttpsClientOptions options)
+        : runtime_(std::make_unique<Runtime>())
+    {
+        impl_ = std::make_shared<Impl>(runtime_->ioc, options);
+        runtime_->thread = std::thread([runtime = runtime_.get()]() { runtime->ioc.run(); });
+    }
+
+    HttpsClient::HttpsClient(net::io_context& ioc, HttpsClientOptions options)
+        : impl_(std::make_shared<Impl>(ioc, options))
+    {
+    }
+
+    HttpsClient::~HttpsClient() {
+        if (!runtime_) {
+            // io_context fourni : les requêtes annulées se terminent sur ses threads
+            net::post(impl_->strand, [impl = impl_]() { impl->arreter(); });
+            return;
+        }
+
+        std::promise<void> arrete;
+        net::post(impl_->strand, [impl = impl_, &arrete]() {
+            impl->arreter();
+            arrete.set_value();
+        });
+        arrete.get_future().wait();
+
+        // Les requêtes annulées se terminent, puis run() rend la main
+        runtime_->travail.reset();
+        runtime_->thread.join();
+        impl_.reset();
+        runtime_.reset();
+    }
+
+    HttpsClient::IdRequete HttpsClient::envoyerAsync(MethodeHttp methode, const std::string& url,
+                                                     OptionsRequete options, Callback callback) {
+        IdRequete id = impl_->prochainId.fetch_add(1, std::memory_order_relaxed);
+        auto cible = decouperUrl(url);
+        if (!cible) {
+            ReponseHttp reponse;
+            reponse.erreur = "URL invalide: " + url;
+            if (callback) callback(std::move(reponse));
+            return id;
+        }
+
+        net::post(impl_->strand, [impl = impl_, id, methode, cible = std::move(*cible),
+                                  options = std::move(options), callback = std::move(callback)]() mutable {
+            if (impl->arrete) {
+                ReponseHttp reponse;
+                reponse.erreur = "Client arrêté";
+                if (callback) callback(std::move(reponse));
+                return;
+            }
+            auto requete = std::make_shared<Requete>(impl, id, methode, std::move(cible),
+                                                     std::move(options), std::move(callback));
+            impl->enCours.emplace(id, requete);
+            requete->demarrer();
+        });
+        return id;
+    }
+
+    void HttpsClient::annuler(IdRequete id) {
+        net::post(impl_->strand, [impl = impl_, id]() {
+            auto it = impl->enCours.find(id);
+            if (it != impl->enCours.end()) {
+                it->second->annuler();
+            }
+        });
+    }
+
+    namespace {
+        ReponseHttp attendre(HttpsClient& client, MethodeHttp methode, const std::string& url, OptionsRequete options) {
+            auto promesse = std::make_shared<std::promise<ReponseHttp>>();
+            auto future = promesse->get_future();
+            client.envoyerAsync(methode, url, std::move(options), [promesse](ReponseHttp reponse) {
+                promesse->set_value(std::move(reponse));
+            });
+            return future.get();
+        }
+    }
+
+    ReponseHttp HttpsClient::get(const std::string& url, OptionsRequete options) {
+        return attendre(*this, MethodeHttp::GET, url, std::move(options));
+    }
+
+    ReponseHttp HttpsClient::head(const std::string& url, OptionsRequete options) {
+        return attendre(*this, MethodeHttp::HEAD, url, std::move(options));
+    }
+
+    size_t HttpsClient::connexionsOuvertes() const {
+        return impl_->connexions.load(std::memory_order_relaxed);
+    }
+
+    size_t HttpsClient::sessionsReprises() const {
+        return impl_->reprises.load(std::memory_order_relaxed);
+    }
+
+    void HttpsClient::ajouterCertificatRacine(const std::string& pem) {
+        impl_->ctx.add_certificate_authority(net::buffer(pem));
+    }
+
+}
@@ -0,0 +1,473 @@
+#include "search/LocalIndex.hpp"
+#include "search/TextNormalizer.hpp"
+#include "core/MappedFile.hpp"
+#include <simdjson.h>
+#include <algorithm>
+#include <iostream>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <numeric>
+#include <queue>
+
+namespace civic {
+
+    namespace {
+        enum Champ { TITRE, TAGS, MOTS_CLES, DESCRIPTION, NB_CHAMPS };
+
+        // BM25F : un mot du titre compte trois fois un mot de la description
+        constexpr std::array<float, NB_CHAMPS> poidsChamp = {3.0f, 2.0f, 1.5f, 1.0f};
+        constexpr std::array<float, NB_CHAMPS> normalisationChamp = {0.75f, 0.5f, 0.5f, 0.75f};
+        constexpr double k1 = 1.2;
+
+        // normaliserTexte supprime l'apostrophe et collerait "l'eau" en
+        // "leau" : on la traite comme un séparateur avant de découper
+        std::vector<std::string> motsIndexables(std::string texte) {
+            for (size_t pos = 0; (pos = texte.find("\u2019", pos)) != std::string::npos; ) {
+                texte.replace(pos, 3, " ");
+            }
+            std::replace(texte.begin(), texte.end(), '\'', ' ');
+            return decouperMots(normaliserTexte(texte));
+        }
+
+        bool estCertifiee(simdjson::dom::element datasetEl) {
+            simdjson::dom::array badges;
+            if (datasetEl["organization"]["badges"].get(badges) != simdjson::SUCCESS) {
+                return false;
+            }
+            for (auto badge : badges) {
+                std::string_view kind;
+                if (badge["kind"].get(kind) == simdjson::SUCCESS &&
+                    (kind == "public-service" || kind == "certified" || kind == "spd")) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::vector<LocalIndex::IdJeu> intersecter(const std::vector<LocalIndex::IdJeu>& a,
+                                                   const std::vector<LocalIndex::IdJeu>& b) {
+            std::vector<LocalIndex::IdJeu> resultat;
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(resultat));
+            return resultat;
+        }
+
+        // Union de deux listes triées par jeu ; un jeu présent dans les deux
+        // garde le meilleur poids
+        template<typename Occurrence>
+        std::vector<Occurrence> fusionner(const std::vector<Occurrence>& a, const std::vector<Occurrence>& b) {
+            std::vector<Occurrence> resultat;
+            resultat.reserve(a.size() + b.size());
+            size_t i = 0, j = 0;
+            while (i < a.size() || j < b.size()) {
+                if (j == b.size() || (i < a.size() && a[i].jeu < b[j].jeu)) {
+                    resultat.push_back(a[i++]);
+                } else if (i == a.size() || b[j].jeu < a[i].jeu) {
+                    resultat.push_back(b[j++]);
+                } else {
+                    resultat.push_back({a[i].jeu, std::max(a[i].poids, b[j].poids)});
+                    ++i;
+                    ++j;
+                }
+            }
+            return resultat;
+        }
+
+        std::vector<LocalIndex::IdJeu> unir(std::vector<LocalIndex::IdJeu> ids) {
+            std::sort(ids.begin(), ids.end());
+            ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+            return ids;
+        }
+    }
+
+    LocalIndex::LocalIndex() = default;
+    LocalIndex::~LocalIndex() = default;
+    LocalIndex::LocalIndex(LocalIndex&&) noexcept = default;
+    LocalIndex& LocalIndex::operator=(LocalIndex&&) noexcept = default;
+
+    bool LocalIndex::charger(const std::string& chemin) {
+        auto fichier = MappedFile::open(chemin, simdjson::SIMDJSON_PADDING);
+        if (!fichier) {
+            std::cerr << "[SEARCH-LOCAL] Erreur: Impossible d'ouvrir " << chemin << std::endl;
+            return false;
+        }
+        return indexer(simdjson::padded_string_view(fichier->data(), fichier->size(),
+                                                    fichier->size() + fichier->padding()));
+    }
+
+    bool LocalIndex::construire(const std::string& json) {
+        simdjson::padded_string padded(json);
+        return indexer(padded);
+    }
+
+    // Le document analysé reste dans `document_` : les chaînes de l'index
+    // y pointent, le fichier source peut être libéré
+    bool LocalIndex::indexer(const simdjson::padded_string_view& json) {
+        auto parser = std::make_unique<simdjson::dom::parser>();
+        simdjson::dom::array doc;
+        auto error = parser->parse(json).get(doc);
+        if (error) {
+            std::cerr << "[SEARCH-LOCAL] Erreur de parsing JSON: " << error << std::endl;
+            return false;
+        }
+
+        auto synonymes = std::move(synonymes_);
+        float poidsSynonyme = poidsSynonyme_;
+        *this = LocalIndex{};
+        document_ = std::move(parser);
+        synonymes_ = std::move(synonymes);
+        poidsSynonyme_ = poidsSynonyme;
+
+        struct Frequences {
+            IdJeu jeu;
+            std::array<uint16_t, NB_CHAMPS> tf;
+        };
+        std::unordered_map<std::string, std::vector<Frequences>> postings;
+        std::vector<std::array<uint32_t, NB_CHAMPS>> longueurs;
+
+        auto ajouter = [&postings, &longueurs](const std::string& texte, IdJeu id, Champ champ) {
+            for (auto& mot : motsIndexables(texte)) {
+                auto& liste = postings[std::move(mot)];
+                if (liste.empty() || liste.back().jeu != id) {
+                    liste.push_back({id, {}});
+                }
+                if (liste.back().tf[champ] < UINT16_MAX) ++liste.back().tf[champ];
+                ++longueurs[id][champ];
+            }
+        };
+
+        debutRessources_.push_back(0);
+        for (simdjson::dom::element datasetEl : doc) {
+            IdJeu id = static_cast<IdJeu>(ids_.size());
+            longueurs.push_back({});
+            std::string_view sv;
+            auto texte = [&sv](simdjson::simdjson_result<simdjson::dom::element> champ) {
+                return champ.get(sv) == simdjson::SUCCESS ? sv : std::string_view{};
+            };
+
+            ids_.push_back(texte(datasetEl["id"]));
+            titres_.push_back(texte(datasetEl["title"]));
+            descriptions_.push_back(texte(datasetEl["description"]));
+            organisations_.emplace_back(texte(datasetEl["organization"]["name"]));
+            certifiees_.push_back(estCertifiee(datasetEl) ? 1 : 0);
+            creations_.push_back(texte(datasetEl["created_at"]));
+            modifications_.push_back(texte(datasetEl["last_modified"]));
+
+            int64_t compteur = 0;
+            vues_.push_back(datasetEl["metrics"]["views"].get(compteur) == simdjson::SUCCESS ? compteur : 0);
+            reutilisations_.push_back(datasetEl["metrics"]["reuses"].get(compteur) == simdjson::SUCCESS ? compteur : 0);
+
+            ajouter(std::string(titres_.back()), id, TITRE);
+            ajouter(std::string(descriptions_.back()), id, DESCRIPTION);
+
+            simdjson::dom::array tags;
+            if (datasetEl["tags"].get(tags) == simdjson::SUCCESS) {
+                for (auto tag : tags) {
+                    if (tag.get(sv) != simdjson::SUCCESS) continue;
+                    ajouter(std::string(sv), id, TAGS);
+                    auto& liste = parTag_[sv];
+                    if (liste.empty() || liste.back() != id) {
+                        liste.push_back(id);
+                    }
+                }
+            }
+
+            simdjson::dom::array keywords;
+            if (datasetEl["enriched_keywords"].get(keywords) == simdjson::SUCCESS) {
+                for (auto keyword : keywords) {
+                    if (keyword.get(sv) == simdjson::SUCCESS) ajouter(std::string(sv), id, MOTS_CLES);
+                }
+            }
+
+            simdjson::dom::array resources;
+            if (datasetEl["resources"].get(resources) == simdjson::SUCCESS) {
+                for (auto resEl : resources) {
+                    ressourceUrls_.push_back(texte(resEl["url"]));
+                    ressourceTitres_.push_back(texte(resEl["title"]));
+                    auto format = SearchService::mimeTypeVersFormat(std::string(texte(resEl["mime"])));
+                    ressourceFormats_.push_back(format ? static_cast<int8_t>(*format) : -1);
+                }
+            }
+            debutRessources_.push_back(static_cast<uint32_t>(ressourceUrls_.size()));
+        }
+
+        std::array<double, NB_CHAMPS> longueurMoyenne{};
+        for (const auto& l : longueurs) {
+            for (int c = 0; c < NB_CHAMPS; ++c) longueurMoyenne[c] += l[c];
+        }
+        for (auto& moyenne : longueurMoyenne) {
+            moyenne = longueurs.empty() || moyenne == 0 ? 1.0 : moyenne / longueurs.size();
+        }
+
+        // Vocabulaire trié : une recherche par préfixe est un intervalle.
+        // La fréquence pondérée ne dépend que du jeu : calculée une fois ici.
+        termes_.reserve(postings.size());
+        for (const auto& [terme, liste] : postings) {
+            termes_.push_back(terme);
+        }
+        std::sort(termes_.begin(), termes_.end());
+        postings_.reserve(termes_.size());
+        for (const auto& terme : termes_) {
+            std::vector<Occurrence> occurrences;
+            for (const auto& f : postings[terme]) {
+                double poids = 0;
+                for (int c = 0; c < NB_CHAMPS; ++c) {
+                    if (f.tf[c] == 0) continue;
+                    double b = normalisationChamp[c];
+                    poids += poidsChamp[c] * f.tf[c] / (1.0 - b + b * longueurs[f.jeu][c] / longueurMoyenne[c]);
+                }
+                occurrences.push_back({f.jeu, static_cast<float>(poids)});
+            }
+            postings_.push_back(std::move(occurrences));
+        }
+        compilerSynonymes();
+        return true;
+    }
+
+    void LocalIndex::setSynonymes(const std::unordered_map<std::string, std::vector<std::string>>& synonymes,
+                                  float poidsSynonyme) {
+        synonymes_.clear();
+        poidsSynonyme_ = poidsSynonyme;
+        for (const auto& [mot, alternatives] : synonymes) {
+            auto cle = motsIndexables(mot);
+            if (cle.size() != 1) continue;
+            auto& phrases = synonymes_[cle.front()];
+            for (const auto& alternative : alternatives) {
+                auto mots = motsIndexables(alternative);
+                if (!mots.empty()) phrases.push_back(std::move(mots));
+            }
+        }
+        compilerSynonymes();
+    }
+
+    // Le mot exact et ses pluriels en -s / -x : un préfixe serait trop
+    // large pour des synonymes courts comme « ter » ou « tri »
+    std::vector<LocalIndex::Occurrence> LocalIndex::occurrencesExactes(const std::string& mot) const {
+        std::vector<Occurrence> occurrences;
+        for (const auto& forme : {mot, mot + "s", mot + "x"}) {
+            auto it = std::lower_bound(termes_.begin(), termes_.end(), forme);
+            if (it != termes_.end() && *it == forme) {
+                occurrences = fusionner(occurrences, postings_[it - termes_.begin()]);
+            }
+        }
+        return occurrences;
+    }
+
+    // Un synonyme de plusieurs mots n'est retenu que si le jeu les contient
+    // tous ; son poids est la moyenne des leurs
+    void LocalIndex::compilerSynonymes() {
+        occurrencesSynonymes_.clear();
+        for (const auto& [mot, phrases] : synonymes_) {
+            std::vector<Occurrence> elargies;
+            for (const auto& phrase : phrases) {
+                std::vector<Occurrence> communes;
+                for (size_t i = 0; i < phrase.size(); ++i) {
+                    auto occurrences = occurrencesExactes(phrase[i]);
+                    if (i == 0) {
+                        communes = std::move(occurrences);
+                        continue;
+                    }
+                    std::vector<Occurrence> suivantes;
+                    size_t j = 0;
+                    for (const auto& o : communes) {
+                        while (j < occurrences.size() && occurrences[j].jeu < o.jeu) ++j;
+                        if (j < occurrences.size() && occurrences[j].jeu == o.jeu) {
+                            suivantes.push_back({o.jeu, o.poids + occurrences[j].poids});
+                        }
+                    }
+                    communes = std::move(suivantes);
+                }
+                for (auto& o : communes) {
+                    o.poids = o.poids / phrase.size() * poidsSynonyme_;
+                }
+                elargies = fusionner(elargies, communes);
+            }
+            if (!elargies.empty()) {
+                occurrencesSynonymes_.emplace(mot, std::move(elargies));
+            }
+        }
+    }
+
+    std::vector<LocalIndex::Occurrence> LocalIndex::occurrencesPrefixe(std::string_view prefixe) const {
+        auto debut = std::lower_bound(termes_.begin(), termes_.end(), prefixe);
+        auto fin = debut;
+        while (fin != termes_.end() && std::string_view(*fin).substr(0, prefixe.size()) == prefixe) {
+            ++fin;
+        }
+
+        if (fin - debut == 1) {
+            return postings_[debut - termes_.begin()];
+        }
+        std::vector<Occurrence> occurrences;
+        for (auto it = debut; it != fin; ++it) {
+            const auto& liste = postings_[it - termes_.begin()];
+            occurrences.insert(occurrences.end(), liste.begin(), liste.end());
+        }
+        std::sort(occurrences.begin(), occurrences.end(),
+                  [](const Occurrence& a, const Occurrence& b) { return a.jeu < b.jeu; });
+
+        // Un jeu qui contient plusieurs mots du préfixe cumule leurs poids
+        size_t n = 0;
+        for (size_t i = 0; i < occurrences.size(); ++i) {
+            if (n > 0 && occurrences[n - 1].jeu == occurrences[i].jeu) {
+                occurrences[n - 1].poids += occurrences[i].poids;
+            } else {
+                occurrences[n++] = occurrences[i];
+            }
+        }
+        occurrences.resize(n);
+        return occurrences;
+    }
+
+    std::optional<std::vector<std::vector<LocalIndex::Occurrence>>>
+    LocalIndex::occurrencesRequete(const std::string& requete) const {
+        std::vector<std::vector<Occurrence>> mots;
+        for (const auto& mot : motsIndexables(requete)) {
+            mots.push_back(occurrencesPrefixe(mot));
+            auto synonymes = occurrencesSynonymes_.find(mot);
+            if (synonymes != occurrencesSynonymes_.end()) {
+                mots.back() = fusionner(mots.back(), synonymes->second);
+            }
+            if (mots.back().empty()) return std::nullopt;
+        }
+        return mots;
+    }
+
+    std::vector<LocalIndex::IdJeu> LocalIndex::filtrer(const std::vector<std::vector<Occurrence>>& mots,
+                                                       bool uniquementCertifiees,
+                                                       const std::vector<std::string>& tagsThematique) const {
+        std::vector<std::vector<IdJeu>> listes;
+        for (const auto& occurrences : mots) {
+            std::vector<IdJeu> ids;
+            ids.reserve(occurrences.size());
+            for (const auto& o : occurrences) ids.push_back(o.jeu);
+            listes.push_back(std::move(ids));
+        }
+
+        if (!tagsThematique.empty()) {
+            std::vector<IdJeu> ids;
+            for (const auto& tag : tagsThematique) {
+                auto it = parTag_.find(tag);
+                if (it != parTag_.end()) ids.insert(ids.end(), it->second.begin(), it->second.end());
+            }
+            if (ids.empty()) return {};
+            listes.push_back(unir(std::move(ids)));
+        }
+
+        std::vector<IdJeu> resultat;
+        if (listes.empty()) {
+            resultat.resize(ids_.size());
+            std::iota(resultat.begin(), resultat.end(), 0);
+        } else {
+            // Les listes les plus courtes d'abord : l'intersection ne fait que rétrécir
+            std::sort(listes.begin(), listes.end(),
+                      [](const auto& a, const auto& b) { return a.size() < b.size(); });
+            resultat = std::move(listes.front());
+            for (size_t i = 1; i < listes.size() && !resultat.empty(); ++i) {
+                resultat = intersecter(resultat, listes[i]);
+            }
+        }
+
+        if (uniquementCertifiees) {
+            std::erase_if(resultat, [this](IdJeu id) { return !certifiees_[id]; });
+        }
+        return resultat;
+    }
+
+    std::vector<LocalIndex::IdJeu> LocalIndex::rechercher(const std::string& requete,
+                                                          bool uniquementCertifiees,
+                                                          const std::vector<std::string>& tagsThematique) const {
+        auto mots = occurrencesRequete(requete);
+        if (!mots) return {};
+        return filtrer(*mots, uniquementCertifiees, tagsThematique);
+    }
+
+    LocalIndex::PageLocale LocalIndex::classer(const std::string& requete,
+                                               bool uniquementCertifiees,
+                                               const std::vector<std::string>& tagsThematique,
+                                               const std::string& tri,
+                                               size_t debut, size_t nombre) const {
+        PageLocale page;
+        auto mots = occurrencesRequete(requete);
+        if (!mots) return page;
+
+        auto candidats = filtrer(*mots, uniquementCertifiees, tagsThematique);
+        page.total = candidats.size();
+        if (nombre == 0 || debut >= candidats.size()) return page;
+
+        std::vector<Correspondance> scores(candidats.size());
+        for (size_t i = 0; i < candidats.size(); ++i) {
+            scores[i] = {candidats[i], 0.0};
+        }
+        // Les deux suites sont triées par jeu : un seul parcours par mot
+        double n = static_cast<double>(ids_.size());
+        for (const auto& occurrences : *mots) {
+            double df = static_cast<double>(occurrences.size());
+            double idf = std::log(1.0 + (n - df + 0.5) / (df + 0.5));
+            size_t j = 0;
+            for (auto& candidat : scores) {
+                while (occurrences[j].jeu < candidat.jeu) ++j;
+                double tf = occurrences[j].poids;
+                candidat.score += idf * tf * (k1 + 1.0) / (tf + k1);
+            }
+        }
+
+        // Vrai si `a` passe avant `b` ; à égalité, l'ordre du catalogue
+        auto avant = [this, &tri](const Correspondance& a, const Correspondance& b) {
+            if (tri == "created" && creations_[a.jeu] != creations_[b.jeu]) {
+                return creations_[a.jeu] > creations_[b.jeu];
+            }
+            if (tri == "last_modified" && modifications_[a.jeu] != modifications_[b.jeu]) {
+                return modifications_[a.jeu] > modifications_[b.jeu];
+            }
+            if (tri == "downloads" && vues_[a.jeu] != vues_[b.jeu]) {
+                return vues_[a.jeu] > vues_[b.jeu];
+            }
+            if (a.score != b.score) return a.score > b.score;
+            return a.jeu < b.jeu;
+        };
+
+        // Tas borné aux debut + nombre meilleurs : le pire est au sommet
+        size_t k = std::min(debut + nombre, scores.size());
+        std::priority_queue<Correspondance, std::vector<Correspondance>, decltype(avant)> tas(avant);
+        for (const auto& candidat : scores) {
+            if (tas.size() < k) {
+                tas.push(candidat);
+            } else if (avant(candidat, tas.top())) {
+                tas.pop();
+                tas.push(candidat);
+            }
+        }
+
+        std::vector<Correspondance> meilleurs(tas.size());
+        for (size_t i = meilleurs.size(); i-- > 0; ) {
+            meilleurs[i] = tas.top();
+            tas.pop();
+        }
+        page.jeux.assign(meilleurs.begin() + debut, meilleurs.end());
+        return page;
+    }
+
+    JeuDeDonnees LocalIndex::jeu(IdJeu id, double score) const {
+        JeuDeDonnees jeu{};
+        jeu.id = std::string(ids_[id]);
+        jeu.titre = std::string(titres_[id]);
+        jeu.description = std::string(descriptions_[id]);
+        jeu.organisation = organisations_[id];
+        jeu.organisationCertifiee = certifiees_[id] != 0;
+        jeu.nombreTelechargements = static_cast<int>(vues_[id]);
+        jeu.nombreReutilisations = static_cast<int>(reutilisations_[id]);
+        jeu.score = score;
+
+        jeu.ressources.reserve(debutRessources_[id + 1] - debutRessources_[id]);
+        for (uint32_t r = debutRessources_[id]; r < debutRessources_[id + 1]; ++r) {
+            Ressource res{};
+            res.url = std::string(ressourceUrls_[r]);
+            res.titre = std::string(ressourceTitres_[r]);
+            if (ressourceFormats_[r] >= 0) res.format = static_cast<FormatFichier>(ressourceFormats_[r]);
+            jeu.ressources.push_back(std::move(res));
+        }
+        return jeu;
+    }
+
+}
@@ -1,26 +1,24 @@
 #include "search/SearchService.hpp"
+#include "search/CacheVerification.hpp"
+#include "search/CacheRecherche.hpp"
+#include "search/LocalIndex.hpp"
+#include "search/TextNormalizer.hpp"
 #include <simdjson.h>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <cctype>
 #include <ctime>
 #include <iostream>
-#include <regex>
 #include <fstream>
-
-#include <boost/beast.hpp>
-#include <boost/beast/ssl.hpp>
-#include <boost/asio.hpp>
-#include <boost/asio/ssl.hpp>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
 
 namespace civic {
 
-    namespace beast = boost::beast;
-    namespace http = beast::http;
-    namespace net = boost::asio;
-    namespace ssl = net::ssl;
-    using tcp = net::ip::tcp;
-
     namespace {
         std::string urlEncode(const std::string& value) {
             std::ostringstream escaped;
@@ -55,130 +53,199 @@ namespace civic {
             return ss.str();
         }
 
-        std::tuple<std::string, std::string, std::string> parseUrl(const std::string& url) {
-            std::regex urlRegex(R"((https?)://([^/:]+)(?::(\d+))?(/.*)?)", std::regex::icase);
-            std::smatch match;
-            
-            if (std::regex_match(url, match, urlRegex)) {
-                std::string scheme = match[1].str();
-                std::string host = match[2].str();
-                std::string port = match[3].str();
-                std::string path = match[4].str();
-                
-                if (port.empty()) {
-                    port = (scheme == "https") ? "443" : "80";
+        std::string hoteDe(const std::string& url) {
+            auto debut = url.find("://");
+            debut = (debut == std::string::npos) ? 0 : debut + 3;
+            auto fin = url.find_first_of(":/?", debut);
+            return url.substr(debut, fin == std::string::npos ? std::string::npos : fin - debut);
+        }
+
+        // Les callbacks arrivent sur le thread du client HTTPS ; chaque
+        // réponse libère une place et relance les vérifications en attente.
+        // `fin` est appelé une seule fois, quand plus rien n'est en vol.
+        struct LotVerification {
+            using Fin = std::function<void(std::vector<VerificationRessource>)>;
+
+            std::mutex mutex;
+            HttpsClient* client = nullptr;
+            CacheVerification* cache = nullptr;
+            OptionsVerification options;
+            std::chrono::steady_clock::time_point echeance;
+            std::vector<std::string> urls;
+            std::vector<std::string> hotes;
+            std::vector<VerificationRessource> resultats;
+            std::vector<std::vector<std::pair<std::string, std::string>>> conditions;
+            std::vector<char> verifiees;
+            std::deque<size_t> enAttente;
+            std::map<std::string, size_t> actifsParHote;
+            std::map<size_t, HttpsClient::IdRequete> enVol;
+            size_t actifs = 0;
+            size_t termines = 0;
+            bool abandonne = false;
+            bool signale = false;
+            Fin fin;
+        };
+
+        // Les URL déjà en cache et fraîches sont réglées ici, sans requête
+        std::shared_ptr<LotVerification> creerLot(HttpsClient& client, CacheVerification& cache,
+                                                  const std::vector<std::string>& urls,
+                                                  const OptionsVerification& options,
+                                                  std::chrono::steady_clock::time_point echeance,
+                                                  LotVerification::Fin fin) {
+            auto lot = std::make_shared<LotVerification>();
+            lot->client = &client;
+            lot->cache = &cache;
+            lot->options = options;
+            lot->echeance = echeance;
+            lot->urls = urls;
+            lot->verifiees.assign(urls.size(), 0);
+            lot->conditions.resize(urls.size());
+            lot->fin = std::move(fin);
+            for (size_t i = 0; i < urls.size(); ++i) {
+                lot->hotes.push_back(hoteDe(urls[i]));
+
+                OptionsRequete conditionnelle;
+                if (auto enCache = cache.consulter(urls[i], conditionnelle)) {
+                    lot->resultats.push_back(std::move(*enCache));
+                    lot->verifiees[i] = 1;
+                    ++lot->termines;
+                    continue;
                 }
-                if (path.empty()) {
-                    path = "/";
+                lot->conditions[i] = std::move(conditionnelle.entetes);
+                lot->enAttente.push_back(i);
+
+                VerificationRessource nonVerifiee;
+                nonVerifiee.resourceId = urls[i];
+                nonVerifiee.disponible = false;
+                nonVerifiee.httpStatus = 0;
+                nonVerifiee.tempsReponse = std::chrono::milliseconds(0);
+                lot->resultats.push_back(std::move(nonVerifiee));
+            }
+            return lot;
+        }
+
+        void lancerVerifications(const std::shared_ptr<LotVerification>& lot) {
+            std::vector<size_t> aLancer;
+            std::chrono::milliseconds timeout{0};
+            bool complet = false;
+            {
+                std::lock_guard<std::mutex> lock(lot->mutex);
+                // Passé l'échéance, ce qui n'est pas parti compte comme indisponible
+                if (std::chrono::steady_clock::now() >= lot->echeance) {
+                    lot->abandonne = true;
+                }
+                if (lot->abandonne) {
+                    lot->termines += lot->enAttente.size();
+                    lot->enAttente.clear();
+                }
+
+                for (auto it = lot->enAttente.begin();
+                     it != lot->enAttente.end() && lot->actifs < lot->options.maxConcurrence;) {
+                    auto& actifsHote = lot->actifsParHote[lot->hotes[*it]];
+                    if (actifsHote >= lot->options.maxParHote) {
+                        ++it;
+                        continue;
+                    }
+                    ++actifsHote;
+                    ++lot->actifs;
+                    aLancer.push_back(*it);
+                    it = lot->enAttente.erase(it);
+                }
+
+                auto reste = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    lot->echeance - std::chrono::steady_clock::now());
+                timeout = std::max(std::chrono::milliseconds(1), std::min(lot->options.timeoutRequete, reste));
+
+                if (lot->termines == lot->urls.size() && !lot->signale) {
+                    lot->signale = complet = true;
+                }
+            }
+
+            if (complet) {
+                lot->fin(std::move(lot->resultats));
+                return;
+            }
+
+            // Hors du verrou : une URL invalide rappelle immédiatement
+            for (size_t i : aLancer) {
+                OptionsRequete options;
+                options.verifierCertificat = true;
+                options.timeout = timeout;
+                options.entetes = lot->conditions[i];
+                auto id = lot->client->envoyerAsync(MethodeHttp::HEAD, lot->urls[i], std::move(options),
+                    [lot, i](ReponseHttp reponse) {
+                        {
+                            std::lock_guard<std::mutex> lock(lot->mutex);
+                            lot->resultats[i] = lot->cache->integrer(lot->urls[i], std::move(reponse));
+                            lot->verifiees[i] = 1;
+                            lot->enVol.erase(i);
+                            --lot->actifs;
+                            --lot->actifsParHote[lot->hotes[i]];
+                            ++lot->termines;
+                        }
+                        lancerVerifications(lot);
+                    });
+
+                std::lock_guard<std::mutex> lock(lot->mutex);
+                if (!lot->verifiees[i]) {
+                    lot->enVol[i] = id;
                 }
-                
-                return {host, port, path};
             }
-            return {"", "", ""};
         }
 
-        // Normalise une chaîne : minuscules, suppression accents, trim
-        std::string normaliserTexte(const std::string& texte) {
-            std::string resultat;
-            resultat.reserve(texte.size());
-            
-            // Table de conversion des caractères accentués UTF-8
-            static const std::vector<std::pair<std::string, std::string>> accents = {
-                {"é", "e"}, {"è", "e"}, {"ê", "e"}, {"ë", "e"},
-                {"à", "a"}, {"â", "a"}, {"ä", "a"},
-                {"ù", "u"}, {"û", "u"}, {"ü", "u"},
-                {"î", "i"}, {"ï", "i"},
-                {"ô", "o"}, {"ö", "o"},
-                {"ç", "c"},
-                {"É", "e"}, {"È", "e"}, {"Ê", "e"}, {"Ë", "e"},
-                {"À", "a"}, {"Â", "a"}, {"Ä", "a"},
-                {"Ù", "u"}, {"Û", "u"}, {"Ü", "u"},
-                {"Î", "i"}, {"Ï", "i"},
-                {"Ô", "o"}, {"Ö", "o"},
-                {"Ç", "c"}
-            };
-            
-            std::string temp = texte;
-            for (const auto& [accent, replacement] : accents) {
-                size_t pos = 0;
-                while ((pos = temp.find(accent, pos)) != std::string::npos) {
-                    temp.replace(pos, accent.length(), replacement);
-                    pos += replacement.length();
+        void annulerLot(const std::shared_ptr<LotVerification>& lot) {
+            std::vector<HttpsClient::IdRequete> ids;
+            {
+                std::lock_guard<std::mutex> lock(lot->mutex);
+                lot->abandonne = true;
+                for (const auto& [index, id] : lot->enVol) ids.push_back(id);
+            }
+            for (auto id : ids) {
+                lot->client->annuler(id);
+            }
+            lancerVerifications(lot);
+        }
+
+        std::vector<std::string> urlsAVerifier(const std::vector<JeuDeDonnees>& jeux) {
+            std::vector<std::string> urls;
+            for (const auto& jeu : jeux) {
+                for (const auto& res : jeu.ressources) {
+                    if (!res.url.empty()) urls.push_back(res.url);
                 }
             }
-            
-            for (char c : temp) {
-                if (std::isalnum(static_cast<unsigned char>(c)) || c == ' ' || c == '-') {
-                    resultat += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            return urls;
+        }
+
+        // Retire les ressources indisponibles, puis les jeux qui n'en ont plus.
+        // `verifs` suit l'ordre de urlsAVerifier(jeux).
+        void appliquerVerifications(std::vector<JeuDeDonnees>& jeux, const std::vector<VerificationRessource>& verifs) {
+            size_t i = 0;
+            for (auto& jeu : jeux) {
+                std::vector<Ressource> disponibles;
+                for (auto& res : jeu.ressources) {
+                    if (res.url.empty()) {
+                        disponibles.push_back(std::move(res));
+                        continue;
+                    }
+
+                    const auto& verif = verifs[i++];
+                    res.httpStatus = verif.httpStatus;
+                    if (!verif.disponible) {
+                        continue;
+                    }
+                    // En-tête arbitraire du serveur : seul le type normalisé est
+                    // interné, pour garder la table des symboles bornée
+                    if (verif.mimeTypeReel.has_value()) {
+                        if (auto type = SearchService::typeMedia(*verif.mimeTypeReel)) {
+                            res.mimeType = *type;
+                        }
+                    }
+                    disponibles.push_back(std::move(res));
                 }
+                jeu.ressources = std::move(disponibles);
             }
-            
-            // Trim
-            size_t start = resultat.find_first_not_of(" ");
-            size_t end = resultat.find_last_not_of(" ");
-            if (start == std::string::npos) return "";
-            return resultat.substr(start, end - start + 1);
-        }
-
-        // Dictionnaire de synonymes pour expansion de requête
-        const std::unordered_map<std::string, std::vector<std::string>>& getSynonymes() {
-            static const std::unordered_map<std::string, std::vector<std::string>> synonymes = {
-                // Transports
-                {"transport", {"mobilite", "deplacement", "circulation", "trafic"}},
-                {"velo", {"cyclable", "piste-cyclable", "bicyclette", "velocipede"}},
-                {"bus", {"autobus", "transport-commun", "ligne-bus"}},
-                {"train", {"sncf", "ferroviaire", "rail", "gare", "ter", "tgv"}},
-                {"voiture", {"automobile", "vehicule", "parking", "stationnement"}},
-                {"metro", {"metropolitain", "rer", "tramway", "tram"}},
-                
-                // Environnement
-                {"environnement", {"ecologie", "nature", "biodiversite", "climat"}},
-                {"pollution", {"qualite-air", "emission", "co2", "particules"}},
-                {"dechets", {"ordures", "recyclage", "tri", "collecte"}},
-                {"eau", {"assainissement", "potable", "cours-eau", "riviere"}},
-                {"energie", {"electricite", "gaz", "renouvelable", "solaire", "eolien"}},
-                
-                // Santé
-                {"sante", {"medical", "hopital", "medecin", "soins"}},
-                {"hopital", {"chu", "clinique", "urgences", "etablissement-sante"}},
-                {"medecin", {"generaliste", "specialiste", "praticien", "docteur"}},
-                {"pharmacie", {"officine", "medicament"}},
-                
-                // Éducation
-                {"education", {"enseignement", "scolaire", "formation"}},
-                {"ecole", {"primaire", "maternelle", "elementaire", "etablissement-scolaire"}},
-                {"college", {"secondaire", "collegien"}},
-                {"lycee", {"lyceen", "baccalaureat"}},
-                {"universite", {"faculte", "etudiant", "superieur", "campus"}},
-                
-                // Économie
-                {"economie", {"entreprise", "commerce", "emploi", "activite"}},
-                {"emploi", {"travail", "chomage", "offre-emploi", "recrutement"}},
-                {"entreprise", {"societe", "siret", "siren", "etablissement"}},
-                {"commerce", {"magasin", "boutique", "commercant"}},
-                
-                // Logement
-                {"logement", {"habitat", "immobilier", "residence", "habitation"}},
-                {"hlm", {"social", "logement-social", "bailleur"}},
-                
-                // Administration
-                {"mairie", {"commune", "municipal", "hotel-ville"}},
-                {"prefecture", {"departement", "sous-prefecture"}},
-                {"region", {"conseil-regional", "collectivite"}},
-                
-                // Culture
-                {"culture", {"musee", "bibliotheque", "theatre", "patrimoine"}},
-                {"sport", {"equipement-sportif", "stade", "gymnase", "piscine"}},
-                
-                // Sécurité
-                {"securite", {"police", "gendarmerie", "pompier", "secours"}},
-                {"accident", {"sinistre", "incident", "accidentologie"}},
-                
-                // Agriculture
-                {"agriculture", {"agricole", "exploitation", "ferme", "elevage"}},
-                {"bio", {"biologique", "agriculture-biologique", "label"}}
-            };
-            return synonymes;
+
+            std::erase_if(jeux, [](const JeuDeDonnees& jeu) { return jeu.ressources.empty(); });
         }
 
         // Normalise et nettoie la requête (sans ajouter de mots - l'API fait un AND implicite)
@@ -189,6 +256,243 @@ namespace civic {
             // On n'ajoute PAS de synonymes car l'API data.gouv fait un AND entre tous les mots
             return requeteNorm;
         }
+
+        // Réutilisé d'une réponse à l'autre sur un même thread : ses tampons
+        // gardent la taille de la plus grande réponse vue
+        simdjson::ondemand::parser& parserOnDemand() {
+            thread_local simdjson::ondemand::parser parser;
+            return parser;
+        }
+
+        // simdjson lit au-delà de la fin du texte : la capacité de la chaîne
+        // suffit souvent, sinon on recopie dans un tampon réutilisé
+        simdjson::padded_string_view avecRemplissage(const std::string& json) {
+            if (json.capacity() - json.size() >= simdjson::SIMDJSON_PADDING) {
+                return simdjson::padded_string_view(json);
+            }
+            thread_local std::string tampon;
+            tampon.reserve(json.size() + simdjson::SIMDJSON_PADDING);
+            tampon.assign(json);
+            return simdjson::padded_string_view(tampon);
+        }
+
+        // Valeur textuelle, vide si le champ est null ou d'un autre type
+        std::string_view texte(simdjson::ondemand::value& valeur) {
+            std::string_view sv;
+            if (valeur.get_string().get(sv) != simdjson::SUCCESS) return {};
+            return sv;
+        }
+
+        // Appelle `lire(cle, valeur)` pour chaque champ d'un objet, dans
+        // l'ordre du document. Un champ d'un autre type que l'objet est ignoré.
+        template<typename Lecteur>
+        simdjson::error_code parcourirObjet(simdjson::ondemand::value& valeur, Lecteur&& lire) {
+            simdjson::ondemand::object objet;
+            if (valeur.get_object().get(objet) != simdjson::SUCCESS) return simdjson::SUCCESS;
+            for (auto champ : objet) {
+                simdjson::ondemand::field f;
+                if (auto error = std::move(champ).get(f)) return error;
+                if (auto error = lire(f.escaped_key(), f.value())) return error;
+            }
+            return simdjson::SUCCESS;
+        }
+
+        template<typename Lecteur>
+        simdjson::error_code parcourirTableau(simdjson::ondemand::value& valeur, Lecteur&& lire) {
+            simdjson::ondemand::array tableau;
+            if (valeur.get_array().get(tableau) != simdjson::SUCCESS) return simdjson::SUCCESS;
+            for (auto element : tableau) {
+                simdjson::ondemand::value v;
+                if (auto error = element.get(v)) return error;
+                if (auto error = lire(v)) return error;
+            }
+            return simdjson::SUCCESS;
+        }
+
+        simdjson::error_code lireRessourceOnDemand(simdjson::ondemand::value& valeur, Ressource& res) {
+            std::string_view format, mime;
+            int64_t status = 200;
+            res.estPrincipale = true;
+
+            auto error = parcourirObjet(valeur, [&](std::string_view cle, simdjson::ondemand::value& v) {
+                if (cle == "id") res.id = texte(v);
+                else if (cle == "title") res.titre = texte(v);
+                else if (cle == "description") res.description = texte(v);
+                else if (cle == "url") res.url = texte(v);
+                else if (cle == "format") format = texte(v);
+                else if (cle == "mime") mime = texte(v);
+                else if (cle == "filesize") {
+                    int64_t taille = 0;
+                    if (v.get_int64().get(taille) == simdjson::SUCCESS) res.taille = taille;
+                }
+                else if (cle == "last_modified") {
+                    std::string_view sv;
+                    if (v.get_string().get(sv) == simdjson::SUCCESS) res.derniereMaj = parseISODate(std::string(sv));
+                } else if (cle == "type") {
+                    std::string_view sv;
+                    if (v.get_string().get(sv) == simdjson::SUCCESS) res.estPrincipale = (sv == "main");
+                } else if (cle == "schema") {
+                    return parcourirObjet(v, [&](std::string_view c, simdjson::ondemand::value& s) {
+                        std::string_view sv;
+                        if (c == "name" && s.get_string().get(sv) == simdjson::SUCCESS) res.schema = std::string(sv);
+                        return simdjson::SUCCESS;
+                    });
+                } else if (cle == "extras") {
+                    return parcourirObjet(v, [&](std::string_view c, simdjson::ondemand::value& e) {
+                        int64_t n = 0;
+                        if (c == "check:status" && e.get_int64().get(n) == simdjson::SUCCESS) status = n;
+                        return simdjson::SUCCESS;
+                    });
+                }
+                return simdjson::SUCCESS;
+            });
+            if (error) return error;
+
+            res.mimeType = mime.empty() ? format : mime;
+            auto formatOpt = SearchService::mimeTypeVersFormat(res.mimeType);
+            if (!formatOpt && !format.empty()) {
+                formatOpt = SearchService::mimeTypeVersFormat(std::string(format));
+            }
+            if (formatOpt) {
+                res.format = *formatOpt;
+            }
+            res.httpStatus = static_cast<int>(status);
+            return simdjson::SUCCESS;
+        }
+
+        // Remplit `jeu` dans l'ordre où les champs apparaissent, sans
+        // recherche de clé ni arbre intermédiaire
+        simdjson::error_code lireJeuOnDemand(simdjson::ondemand::object& objet, JeuDeDonnees& jeu) {
+            for (auto champ : objet) {
+                simdjson::ondemand::field f;
+                if (auto error = std::move(champ).get(f)) return error;
+
+                auto cle = f.escaped_key();
+                auto& v = f.value();
+                simdjson::error_code error = simdjson::SUCCESS;
+                std::string_view sv;
+
+                if (cle == "id") jeu.id = texte(v);
+                else if (cle == "slug") jeu.slug = texte(v);
+                else if (cle == "title") jeu.titre = texte(v);
+                else if (cle == "description") jeu.description = texte(v);
+                else if (cle == "license") jeu.licence = texte(v);
+                else if (cle == "created_at") {
+                    if (v.get_string().get(sv) == simdjson::SUCCESS) jeu.dateCreation = parseISODate(std::string(sv));
+                } else if (cle == "last_modified") {
+                    if (v.get_string().get(sv) == simdjson::SUCCESS) jeu.derniereMaj = parseISODate(std::string(sv));
+                } else if (cle == "organization") {
+                    error = parcourirObjet(v, [&](std::string_view c, simdjson::ondemand::value& o) {
+                        if (c == "name") jeu.organisation = texte(o);
+                        else if (c == "id") jeu.organisationId = texte(o);
+                        else if (c == "badges") {
+                            return parcourirTableau(o, [&](simdjson::ondemand::value& badge) {
+                                return parcourirObjet(badge, [&](std::string_view b, simdjson::ondemand::value& k) {
+                                    std::string_view kind;
+                                    if (b == "kind" && k.get_string().get(kind) == simdjson::SUCCESS &&
+                                        (kind == "public-service" || kind == "certified" || kind == "spd")) {
+                                        jeu.organisationCertifiee = true;
+                                    }
+                                    return simdjson::SUCCESS;
+                                });
+                            });
+                        }
+                        return simdjson::SUCCESS;
+                    });
+                } else if (cle == "tags") {
+                    error = parcourirTableau(v, [&](simdjson::ondemand::value& tag) {
+                        std::string_view t;
+                        if (tag.get_string().get(t) == simdjson::SUCCESS) jeu.tags.emplace_back(t);
+                        return simdjson::SUCCESS;
+                    });
+                } else if (cle == "spatial") {
+                    error = parcourirObjet(v, [&](std::string_view c, simdjson::ondemand::value& s) {
+                        if (c == "granularity") jeu.granulariteTerritoriale = texte(s);
+                        return simdjson::SUCCESS;
+                    });
+                } else if (cle == "metrics") {
+                    error = parcourirObjet(v, [&](std::string_view c, simdjson::ondemand::value& m) {
+                        int64_t n = 0;
+                        if (c == "views" && m.get_int64().get(n) == simdjson::SUCCESS) {
+                            jeu.nombreTelechargements = static_cast<int>(n);
+                        } else if (c == "reuses" && m.get_int64().get(n) == simdjson::SUCCESS) {
+                            jeu.nombreReutilisations = static_cast<int>(n);
+                        }
+                        return simdjson::SUCCESS;
+                    });
+                } else if (cle == "resources") {
+                    error = parcourirTableau(v, [&](simdjson::ondemand::value& r) {
+                        Ressource res{};
+                        if (auto e = lireRessourceOnDemand(r, res)) return e;
+                        jeu.ressources.push_back(std::move(res));
+                        return simdjson::SUCCESS;
+                    });
+                }
+                if (error) return error;
+            }
+            return simdjson::SUCCESS;
+        }
+    }
+
+    // Dictionnaire de synonymes pour expansion de requête
+    const std::unordered_map<std::string, std::vector<std::string>>& SearchService::getSynonymes() {
+        static const std::unordered_map<std::string, std::vector<std::string>> synonymes = {
+            // Transports
+            {"transport", {"mobilite", "deplacement", "circulation", "trafic"}},
+            {"velo", {"cyclable", "piste-cyclable", "bicyclette", "velocipede"}},
+            {"bus", {"autobus", "transport-commun", "ligne-bus"}},
+            {"train", {"sncf", "ferroviaire", "rail", "gare", "ter", "tgv"}},
+            {"voiture", {"automobile", "vehicule", "parking", "stationnement"}},
+            {"metro", {"metropolitain", "rer", "tramway", "tram"}},
+            
+            // Environnement
+            {"environnement", {"ecologie", "nature", "biodiversite", "climat"}},
+            {"pollution", {"qualite-air", "emission", "co2", "particules"}},
+            {"dechets", {"ordures", "recyclage", "tri", "collecte"}},
+            {"eau", {"assainissement", "potable", "cours-eau", "riviere"}},
+            {"energie", {"electricite", "gaz", "renouvelable", "solaire", "eolien"}},
+            
+            // Santé
+            {"sante", {"medical", "hopital", "medecin", "soins"}},
+            {"hopital", {"chu", "clinique", "urgences", "etablissement-sante"}},
+            {"medecin", {"generaliste", "specialiste", "praticien", "docteur"}},
+            {"pharmacie", {"officine", "medicament"}},
+            
+            // Éducation
+            {"education", {"enseignement", "scolaire", "formation"}},
+            {"ecole", {"primaire", "maternelle", "elementaire", "etablissement-scolaire"}},
+            {"college", {"secondaire", "collegien"}},
+            {"lycee", {"lyceen", "baccalaureat"}},
+            {"universite", {"faculte", "etudiant", "superieur", "campus"}},
+            
+            // Économie
+            {"economie", {"entreprise", "commerce", "emploi", "activite"}},
+            {"emploi", {"travail", "chomage", "offre-emploi", "recrutement"}},
+            {"entreprise", {"societe", "siret", "siren", "etablissement"}},
+            {"commerce", {"magasin", "boutique", "commercant"}},
+            
+            // Logement
+            {"logement", {"habitat", "immobilier", "residence", "habitation"}},
+            {"hlm", {"social", "logement-social", "bailleur"}},
+            
+            // Administration
+            {"mairie", {"commune", "municipal", "hotel-ville"}},
+            {"prefecture", {"departement", "sous-prefecture"}},
+            {"region", {"conseil-regional", "collectivite"}},
+            
+            // Culture
+            {"culture", {"musee", "bibliotheque", "theatre", "patrimoine"}},
+            {"sport", {"equipement-sportif", "stade", "gymnase", "piscine"}},
+            
+            // Sécurité
+            {"securite", {"police", "gendarmerie", "pompier", "secours"}},
+            {"accident", {"sinistre", "incident", "accidentologie"}},
+            
+            // Agriculture
+            {"agriculture", {"agricole", "exploitation", "ferme", "elevage"}},
+            {"bio", {"biologique", "agriculture-biologique", "label"}}
+        };
+        return synonymes;
     }
 
     // Retourne les tags associés à une thématique
@@ -250,6 +554,28 @@ namespace civic {
         return "";
     }
 
+    std::optional<std::string> SearchService::typeMedia(std::string_view contentType) {
+        // RFC 6838 : deux tokens d'au plus 127 caractères
+        auto token = [](std::string_view partie) {
+            if (partie.empty() || partie.size() > 127) return false;
+            return std::all_of(partie.begin(), partie.end(), [](unsigned char c) {
+                return std::isalnum(c) || std::string_view("!#$%&'*+-.^_`|~").find(c) != std::string_view::npos;
+            });
+        };
+
+        auto type = contentType.substr(0, contentType.find(';'));
+        while (!type.empty() && (type.front() == ' ' || type.front() == '\t')) type.remove_prefix(1);
+        while (!type.empty() && (type.back() == ' ' || type.back() == '\t')) type.remove_suffix(1);
+
+        auto barre = type.find('/');
+        if (barre == std::string_view::npos || !token(type.substr(0, barre)) || !token(type.substr(barre + 1))) {
+            return std::nullopt;
+        }
+        std::string resultat(type);
+        std::transform(resultat.begin(), resultat.end(), resultat.begin(), ::tolower);
+        return resultat;
+    }
+
     std::optional<FormatFichier> SearchService::mimeTypeVersFormat(const std::string& mimeType) {
         std::string mime = mimeType;
         std::transform(mime.begin(), mime.end(), mime.begin(), ::tolower);
@@ -315,8 +641,29 @@ namespace civic {
         };
     }
 
-    SearchService::SearchService() = default;
-    SearchService::~SearchService() = default;
+    SearchService::SearchService()
+        : client_(std::make_unique<HttpsClient>()), cache_(std::make_unique<CacheVerification>()),
+          cacheRecherche_(std::make_unique<CacheRecherche>()) {}
+
+    SearchService::SearchService(boost::asio::io_context& ioc)
+        : client_(std::make_unique<HttpsClient>(ioc)), cache_(std::make_unique<CacheVerification>()),
+          cacheRecherche_(std::make_unique<CacheRecherche>()) {}
+
+    SearchService::~SearchService() {
+        std::vector<IdOperation> ids;
+        {
+            std::lock_guard<std::mutex> lock(operationsMutex_);
+            for (const auto& [id, op] : operations_) ids.push_back(id);
+        }
+        for (auto id : ids) {
+            annuler(id);
+        }
+
+        std::unique_lock<std::mutex> lock(operationsMutex_);
+        operationsTerminees_.wait(lock, [this]() { return operations_.empty(); });
+        lock.unlock();
+        client_.reset();
+    }
 
     std::string SearchService::construireURLRecherche(const CriteresRecherche& criteres) const {
         std::ostringstream url;
@@ -364,136 +711,118 @@ namespace civic {
         return result;
     }
 
+    // L'URL couvre les paramètres envoyés à l'API ; le reste des critères
+    // ne sert qu'au filtrage local et doit donc aussi entrer dans la clé
+    std::string SearchService::cleRecherche(const CriteresRecherche& criteres) const {
+        std::vector<int> formats;
+        for (auto format : criteres.formatsAcceptes) {
+            formats.push_back(static_cast<int>(format));
+        }
+        std::sort(formats.begin(), formats.end());
+
+        std::ostringstream cle;
+        cle << construireURLRecherche(criteres)
+            << "#f=";
+        for (int format : formats) cle << format << ',';
+        cle << "&c=" << criteres.uniquementCertifiees
+            << "&g=" << static_cast<int>(criteres.granularite)
+            << "&pdf=" << criteres.exclurePDF
+            << "&img=" << criteres.exclureImages
+            << "&p=" << criteres.uniquementRessourcePrincipale
+            << "&v=" << criteres.verifierDisponibilite;
+        if (criteres.ageMaxJours) {
+            cle << "&age=" << *criteres.ageMaxJours;
+        }
+        if (criteres.miseAJourApres) {
+            cle << "&maj=" << std::chrono::duration_cast<std::chrono::seconds>(
+                criteres.miseAJourApres->time_since_epoch()).count();
+        }
+        return cle.str();
+    }
+
     std::string SearchService::httpGet(const std::string& url) const {
-        auto [host, port, path] = parseUrl(url);
-        
-        if (host.empty()) {
-            std::cerr << "[SEARCH] Invalid URL: " << url << std::endl;
+        OptionsRequete options;
+        options.timeout = std::chrono::seconds(timeoutSeconds_);
+        options.entetes = {{"Accept", "application/json"}};
+
+        auto res = client_->get(url, std::move(options));
+        if (!res.ok()) {
+            std::cerr << "[SEARCH] HTTP GET Error: " << res.erreur << std::endl;
             return "";
         }
-        
-        try {
-            net::io_context ioc;
-            ssl::context ctx(ssl::context::tlsv12_client);
-            
-            ctx.set_default_verify_paths();
-            ctx.set_verify_mode(ssl::verify_none);
-            
-            tcp::resolver resolver(ioc);
-            beast::ssl_stream<beast::tcp_stream> stream(ioc, ctx);
-            
-            if (!SSL_set_tlsext_host_name(stream.native_handle(), host.c_str())) {
-                beast::error_code ec{static_cast<int>(::ERR_get_error()), net::error::get_ssl_category()};
-                throw beast::system_error{ec};
-            }
-            
-            beast::get_lowest_layer(stream).expires_after(std::chrono::seconds(timeoutSeconds_));
-            
-            auto const results = resolver.resolve(host, port);
-            beast::get_lowest_layer(stream).connect(results);
-            stream.handshake(ssl::stream_base::client);
-            
-            http::request<http::string_body> req{http::verb::get, path, 11};
-            req.set(http::field::host, host);
-            req.set(http::field::user_agent, "CivicCore-HyperIngest/1.0");
-            req.set(http::field::accept, "application/json");
-            req.set(http::field::connection, "close");
-            
-            http::write(stream, req);
-            
-            beast::flat_buffer buffer;
-            http::response<http::string_body> res;
-            http::read(stream, buffer, res);
-            
-            beast::error_code ec;
-            stream.shutdown(ec);
-            
-            if (res.result() != http::status::ok) {
-                std::cerr << "[SEARCH] HTTP Error: " << res.result_int() << std::endl;
-                return "";
-            }
-            
-            return res.body();
-            
-        } catch (const std::exception& e) {
-            std::cerr << "[SEARCH] HTTP GET Error: " << e.what() << std::endl;
+        if (res.status != 200) {
+            std::cerr << "[SEARCH] HTTP Error: " << res.status << std::endl;
             return "";
         }
+
+        return std::move(res.corps);
     }
 
     VerificationRessource SearchService::httpHead(const std::string& url) const {
-        VerificationRessource result;
-        result.disponible = false;
-        result.httpStatus = 0;
-        
-        auto [host, port, path] = parseUrl(url);
+        return verifierRessources({url}).front();
+    }
+
+    std::vector<VerificationRessource> SearchService::verifierRessources(const std::vector<std::string>& urls) const {
+        if (urls.empty()) {
+            return {};
+        }
+
+        auto promesse = std::make_shared<std::promise<std::vector<VerificationRessource>>>();
+        auto future = promesse->get_future();
+        auto lot = creerLot(*client_, *cache_, urls, optionsVerification_,
+                            std::chrono::steady_clock::now() + optionsVerification_.delaiGlobal,
+                            [promesse](std::vector<VerificationRessource> verifs) {
+                                promesse->set_value(std::move(verifs));
+                            });
+        lancerVerifications(lot);
+        return future.get();
+    }
+
+    ResultatRecherche SearchService::parserReponse(const std::string& json,
+                                                    const CriteresRecherche& criteres,
+                                                    std::chrono::milliseconds tempsRecherche) const {
+        auto resultat = parserDom_ ? parserReponseDom(json, criteres, tempsRecherche)
+                                   : parserReponseOnDemand(json, criteres, tempsRecherche);
         
-        if (host.empty()) {
-            return result;
+        if (criteres.verifierDisponibilite) {
+            verifierDisponibilites(resultat.jeux);
         }
         
-        auto start = std::chrono::steady_clock::now();
+        return resultat;
+    }
+
+    bool SearchService::retenirJeu(JeuDeDonnees& jeu, const CriteresRecherche& criteres) const {
+        if (criteres.uniquementCertifiees && !jeu.organisationCertifiee) {
+            return false;
+        }
         
-        try {
-            net::io_context ioc;
-            ssl::context ctx(ssl::context::tlsv12_client);
-            ctx.set_default_verify_paths();
-            ctx.set_verify_mode(ssl::verify_peer);
-            
-            tcp::resolver resolver(ioc);
-            beast::ssl_stream<beast::tcp_stream> stream(ioc, ctx);
-            
-            if (!SSL_set_tlsext_host_name(stream.native_handle(), host.c_str())) {
-                return result;
-            }
-            
-            beast::get_lowest_layer(stream).expires_after(std::chrono::seconds(10));
-            
-            auto const results = resolver.resolve(host, port);
-            beast::get_lowest_layer(stream).connect(results);
-            stream.handshake(ssl::stream_base::client);
-            
-            http::request<http::empty_body> req{http::verb::head, path, 11};
-            req.set(http::field::host, host);
-            req.set(http::field::user_agent, "CivicCore-HyperIngest/1.0");
-            
-            http::write(stream, req);
-            
-            beast::flat_buffer buffer;
-            http::response<http::empty_body> res;
-            http::read(stream, buffer, res);
-            
-            auto end = std::chrono::steady_clock::now();
-            result.tempsReponse = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-            
-            result.httpStatus = res.result_int();
-            result.disponible = (res.result() == http::status::ok);
-            
-            auto ct = res.find(http::field::content_type);
-            if (ct != res.end()) {
-                result.mimeTypeReel = std::string(ct->value());
+        if (criteres.granularite != Territoire::TOUS) {
+            std::string granulariteRequise;
+            switch (criteres.granularite) {
+                case Territoire::NATIONAL: granulariteRequise = "country"; break;
+                case Territoire::REGIONAL: granulariteRequise = "fr:region"; break;
+                case Territoire::DEPARTEMENTAL: granulariteRequise = "fr:departement"; break;
+                case Territoire::COMMUNAL: granulariteRequise = "fr:commune"; break;
+                case Territoire::EPCI: granulariteRequise = "fr:epci"; break;
+                default: break;
             }
             
-            auto cl = res.find(http::field::content_length);
-            if (cl != res.end()) {
-                result.tailleReelle = std::stoll(std::string(cl->value()));
+            if (!granulariteRequise.empty() && 
+                jeu.granulariteTerritoriale.find(granulariteRequise) == std::string::npos) {
+                return false;
             }
-            
-            beast::error_code ec;
-            stream.shutdown(ec);
-            
-        } catch (const std::exception& e) {
-            auto end = std::chrono::steady_clock::now();
-            result.tempsReponse = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
         }
         
-        return result;
+        std::erase_if(jeu.ressources, [&](const Ressource& ressource) {
+            return !ressourceAcceptee(ressource, criteres);
+        });
+        return !jeu.ressources.empty();
     }
 
-    ResultatRecherche SearchService::parserReponse(const std::string& json,
-                                                    const CriteresRecherche& criteres,
-                                                    std::chrono::milliseconds tempsRecherche) const {
-        ResultatRecherche resultat;
+    ResultatRecherche SearchService::parserReponseDom(const std::string& json,
+                                                       const CriteresRecherche& criteres,
+                                                       std::chrono::milliseconds tempsRecherche) const {
+        ResultatRecherche resultat{};
         resultat.tempsRecherche = tempsRecherche;
         resultat.pageCourante = criteres.page;
         
@@ -518,19 +847,19 @@ namespace civic {
         }
         
         for (auto datasetEl : data) {
-            JeuDeDonnees jeu;
+            JeuDeDonnees jeu{};
             
             std::string_view sv;
             if (datasetEl["id"].get(sv) == simdjson::SUCCESS) jeu.id = std::string(sv);
             if (datasetEl["slug"].get(sv) == simdjson::SUCCESS) jeu.slug = std::string(sv);
             if (datasetEl["title"].get(sv) == simdjson::SUCCESS) jeu.titre = std::string(sv);
             if (datasetEl["description"].get(sv) == simdjson::SUCCESS) jeu.description = std::string(sv);
-            if (datasetEl["license"].get(sv) == simdjson::SUCCESS) jeu.licence = std::string(sv);
+            if (datasetEl["license"].get(sv) == simdjson::SUCCESS) jeu.licence = sv;
             
             simdjson::dom::element org;
             if (datasetEl["organization"].get(org) == simdjson::SUCCESS) {
-                if (org["name"].get(sv) == simdjson::SUCCESS) jeu.organisation = std::string(sv);
-                if (org["id"].get(sv) == simdjson::SUCCESS) jeu.organisationId = std::string(sv);
+                if (org["name"].get(sv) == simdjson::SUCCESS) jeu.organisation = sv;
+                if (org["id"].get(sv) == simdjson::SUCCESS) jeu.organisationId = sv;
                 
                 simdjson::dom::array badges;
                 if (org["badges"].get(badges) == simdjson::SUCCESS) {
@@ -560,7 +889,7 @@ namespace civic {
             if (datasetEl["tags"].get(tags) == simdjson::SUCCESS) {
                 for (auto tag : tags) {
                     if (tag.get(sv) == simdjson::SUCCESS) {
-                        jeu.tags.push_back(std::string(sv));
+                        jeu.tags.emplace_back(sv);
                     }
                 }
             }
@@ -568,24 +897,7 @@ namespace civic {
             simdjson::dom::element spatial;
             if (datasetEl["spatial"].get(spatial) == simdjson::SUCCESS) {
                 if (spatial["granularity"].get(sv) == simdjson::SUCCESS) {
-                    jeu.granulariteTerritoriale = std::string(sv);
-                }
-            }
-            
-            if (criteres.granularite != Territoire::TOUS) {
-                std::string granulariteRequise;
-                switch (criteres.granularite) {
-                    case Territoire::NATIONAL: granulariteRequise = "country"; break;
-                    case Territoire::REGIONAL: granulariteRequise = "fr:region"; break;
-                    case Territoire::DEPARTEMENTAL: granulariteRequise = "fr:departement"; break;
-                    case Territoire::COMMUNAL: granulariteRequise = "fr:commune"; break;
-                    case Territoire::EPCI: granulariteRequise = "fr:epci"; break;
-                    default: break;
-                }
-                
-                if (!granulariteRequise.empty() && 
-                    jeu.granulariteTerritoriale.find(granulariteRequise) == std::string::npos) {
-                    continue;
+                    jeu.granulariteTerritoriale = sv;
                 }
             }
             
@@ -601,7 +913,7 @@ namespace civic {
             simdjson::dom::array resources;
             if (datasetEl["resources"].get(resources) == simdjson::SUCCESS) {
                 for (auto resEl : resources) {
-                    Ressource res;
+                    Ressource res{};
                     
                     if (resEl["id"].get(sv) == simdjson::SUCCESS) res.id = std::string(sv);
                     if (resEl["title"].get(sv) == simdjson::SUCCESS) res.titre = std::string(sv);
@@ -650,9 +962,7 @@ namespace civic {
                 }
             }
             
-            jeu.ressources = filtrerRessources(jeu.ressources, criteres);
-            
-            if (!jeu.ressources.empty()) {
+            if (retenirJeu(jeu, criteres)) {
                 resultat.jeux.push_back(std::move(jeu));
             }
         }
@@ -660,6 +970,62 @@ namespace civic {
         return resultat;
     }
 
+    ResultatRecherche SearchService::parserReponseOnDemand(const std::string& json,
+                                                            const CriteresRecherche& criteres,
+                                                            std::chrono::milliseconds tempsRecherche) const {
+        ResultatRecherche resultat{};
+        resultat.tempsRecherche = tempsRecherche;
+        resultat.pageCourante = criteres.page;
+        
+        simdjson::ondemand::document doc;
+        simdjson::ondemand::object racine;
+        auto error = parserOnDemand().iterate(avecRemplissage(json)).get(doc);
+        if (!error) error = doc.get_object().get(racine);
+        if (error) {
+            std::cerr << "[SEARCH] JSON Parse Error: " << error << std::endl;
+            return resultat;
+        }
+        
+        // Un seul passage : "total" arrive après "data" dans les réponses
+        // de l'API, les jeux sont donc lus et filtrés au fil de l'eau
+        int64_t total = 0;
+        for (auto champ : racine) {
+            if (error) break;
+            simdjson::ondemand::field f;
+            if ((error = std::move(champ).get(f))) break;
+            
+            auto cle = f.escaped_key();
+            if (cle == "total") {
+                int64_t n = 0;
+                if (f.value().get_int64().get(n) == simdjson::SUCCESS) total = n;
+            } else if (cle == "data") {
+                simdjson::ondemand::array data;
+                if (f.value().get_array().get(data) != simdjson::SUCCESS) continue;
+                resultat.jeux.reserve(static_cast<size_t>(std::max(criteres.parPage, 0)));
+                for (auto element : data) {
+                    simdjson::ondemand::object objet;
+                    if ((error = element.get_object().get(objet))) break;
+                    
+                    JeuDeDonnees jeu{};
+                    if ((error = lireJeuOnDemand(objet, jeu))) break;
+                    if (retenirJeu(jeu, criteres)) {
+                        resultat.jeux.push_back(std::move(jeu));
+                    }
+                }
+            }
+        }
+        
+        if (error) {
+            std::cerr << "[SEARCH] JSON Parse Error: " << error << std::endl;
+            resultat.jeux.clear();
+            return resultat;
+        }
+        
+        resultat.totalResultats = static_cast<int>(total);
+        resultat.totalPages = (resultat.totalResultats + criteres.parPage - 1) / criteres.parPage;
+        return resultat;
+    }
+
     bool SearchService::ressourceAcceptee(const Ressource& ressource,
                                            const CriteresRecherche& criteres) const {
         auto formatOpt = mimeTypeVersFormat(ressource.mimeType);
@@ -712,54 +1078,21 @@ namespace civic {
         return true;
     }
 
-    std::vector<Ressource> SearchService::filtrerRessources(const std::vector<Ressource>& ressources,
-                                                             const CriteresRecherche& criteres) const {
-        std::vector<Ressource> resultat;
-        
-        for (const auto& res : ressources) {
-            if (ressourceAcceptee(res, criteres)) {
-                Ressource filteredRes = res;
-                
-                if (criteres.verifierDisponibilite && !res.url.empty()) {
-                    auto verif = httpHead(res.url);
-                    filteredRes.httpStatus = verif.httpStatus;
-                    
-                    if (!verif.disponible) {
-                        continue;
-                    }
-                    
-                    if (verif.mimeTypeReel.has_value()) {
-                        filteredRes.mimeType = *verif.mimeTypeReel;
-                    }
-                }
-                
-                resultat.push_back(std::move(filteredRes));
-            }
-        }
-        
-        return resultat;
+
+    // Vérifie toutes les ressources de la page en un seul lot
+    void SearchService::verifierDisponibilites(std::vector<JeuDeDonnees>& jeux) const {
+        appliquerVerifications(jeux, verifierRessources(urlsAVerifier(jeux)));
     }
 
     ResultatRecherche SearchService::rechercher(const CriteresRecherche& criteres) {
-        auto start = std::chrono::steady_clock::now();
-        
-        std::string url = construireURLRecherche(criteres);
-        std::cout << "[SEARCH] Query: " << url << std::endl;
-        
-        std::string json = httpGet(url);
-        
-        auto end = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-        
-        if (json.empty()) {
-            ResultatRecherche empty;
-            empty.requeteAPI = url;
-            empty.tempsRecherche = elapsed;
-            return empty;
-        }
-        
-        auto resultat = parserReponse(json, criteres, elapsed);
-        resultat.requeteAPI = url;
+        std::cout << "[SEARCH] Query: " << construireURLRecherche(criteres) << std::endl;
+
+        auto promesse = std::make_shared<std::promise<ResultatRecherche>>();
+        auto future = promesse->get_future();
+        rechercherAsync(criteres, [promesse](ResultatRecherche resultat) {
+            promesse->set_value(std::move(resultat));
+        });
+        auto resultat = future.get();
         
         std::cout << "[SEARCH] Found " << resultat.jeux.size() << " datasets with valid resources ("
                   << resultat.totalResultats << " total)" << std::endl;
@@ -767,11 +1100,154 @@ namespace civic {
         return resultat;
     }
 
-    void SearchService::rechercherAsync(const CriteresRecherche& criteres, SearchCallback callback) {
-        auto resultat = rechercher(criteres);
-        if (callback) {
-            callback(std::move(resultat));
+    // Une recherche utilisateur n'est qu'une attente sur le cache : `cle` et
+    // `attente` permettent à annuler() de la détacher. Les requêtes réelles
+    // (GET de la page puis lot de HEAD) sont des opérations internes où
+    // `requete` et `lot` désignent ce qui est en vol.
+    struct SearchService::OperationAsync {
+        std::mutex mutex;
+        bool annulee = false;
+        std::string cle;
+        CacheRecherche::IdAttente attente = 0;
+        HttpsClient::IdRequete requete = 0;
+        std::shared_ptr<LotVerification> lot;
+    };
+
+    SearchService::IdOperation SearchService::rechercherAsync(const CriteresRecherche& criteres,
+                                                              SearchCallback callback,
+                                                              std::chrono::milliseconds timeout) {
+        auto debut = std::chrono::steady_clock::now();
+        auto delai = timeout.count() > 0 ? timeout : std::chrono::milliseconds(std::chrono::seconds(timeoutSeconds_));
+        std::string url = construireURLRecherche(criteres);
+        std::string cle = cleRecherche(criteres);
+
+        auto op = std::make_shared<OperationAsync>();
+        IdOperation id = ouvrirOperation(op);
+
+        auto livrer = [this, id, url, debut, callback = std::move(callback)](std::optional<ResultatRecherche> resultat) {
+            if (!resultat) {
+                resultat.emplace();
+                resultat->totalResultats = 0;
+                resultat->pageCourante = 0;
+                resultat->totalPages = 0;
+            }
+            resultat->requeteAPI = url;
+            resultat->tempsRecherche = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - debut);
+            if (callback) {
+                callback(std::move(*resultat));
+            }
+            fermerOperation(id);
+        };
+
+        auto acces = cacheRecherche_->acquerir(cle, livrer);
+        if (acces.resultat) {
+            livrer(std::move(acces.resultat));
+            return id;
+        }
+
+        bool annulee;
+        {
+            std::lock_guard<std::mutex> lock(op->mutex);
+            op->cle = cle;
+            op->attente = acces.attente;
+            annulee = op->annulee;
+        }
+        if (annulee) {
+            if (auto attente = cacheRecherche_->retirer(cle, acces.attente)) {
+                (*attente)(std::nullopt);
+            }
+        }
+        if (acces.meneur) {
+            lancerRecherche(cle, url, criteres, delai);
+        }
+        return id;
+    }
+
+    // Opération interne partagée par toutes les attentes sur `cle`. Elle
+    // continue même si elles sont toutes annulées : son résultat sert le cache.
+    void SearchService::lancerRecherche(const std::string& cle, const std::string& url,
+                                        const CriteresRecherche& criteres, std::chrono::milliseconds delai) {
+        auto debut = std::chrono::steady_clock::now();
+        auto echeance = debut + delai;
+
+        auto op = std::make_shared<OperationAsync>();
+        IdOperation id = ouvrirOperation(op);
+
+        auto fin = [this, id, cle](std::optional<ResultatRecherche> resultat) {
+            cacheRecherche_->publier(cle, std::move(resultat));
+            fermerOperation(id);
+        };
+
+        OptionsRequete options;
+        options.timeout = delai;
+        options.entetes = {{"Accept", "application/json"}};
+
+        auto requete = client_->envoyerAsync(MethodeHttp::GET, url, std::move(options),
+            [this, op, criteres, debut, echeance, fin](ReponseHttp reponse) {
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - debut);
+                bool annulee;
+                {
+                    std::lock_guard<std::mutex> lock(op->mutex);
+                    annulee = op->annulee;
+                }
+                if (annulee) {
+                    fin(std::nullopt);
+                    return;
+                }
+                if (!reponse.ok() || reponse.status != 200) {
+                    std::cerr << "[SEARCH] HTTP GET Error: "
+                              << (reponse.ok() ? std::to_string(reponse.status) : reponse.erreur) << std::endl;
+                    fin(std::nullopt);
+                    return;
+                }
+
+                // Le filtrage statique se fait ici, la vérification en lot ensuite
+                CriteresRecherche statiques = criteres;
+                statiques.verifierDisponibilite = false;
+                auto resultat = std::make_shared<ResultatRecherche>(parserReponse(reponse.corps, statiques, elapsed));
+                if (!criteres.verifierDisponibilite) {
+                    fin(std::move(*resultat));
+                    return;
+                }
+
+                auto lot = creerLot(*client_, *cache_, urlsAVerifier(resultat->jeux), optionsVerification_,
+                                    std::min(echeance, std::chrono::steady_clock::now() + optionsVerification_.delaiGlobal),
+                    [op, resultat, fin](std::vector<VerificationRessource> verifs) {
+                        bool annulee;
+                        {
+                            std::lock_guard<std::mutex> lock(op->mutex);
+                            annulee = op->annulee;
+                        }
+                        if (annulee) {
+                            fin(std::nullopt);
+                            return;
+                        }
+                        appliquerVerifications(resultat->jeux, verifs);
+                        fin(std::move(*resultat));
+                    });
+
+                {
+                    std::lock_guard<std::mutex> lock(op->mutex);
+                    op->lot = lot;
+                    annulee = op->annulee;
+                }
+                if (annulee) {
+                    annulerLot(lot);
+                } else {
+                    lancerVerifications(lot);
+                }
+            });
+
+        // annuler() a pu passer avant que `requete` soit connu
+        bool annulee;
+        {
+            std::lock_guard<std::mutex> lock(op->mutex);
+            op->requete = requete;
+            annulee = op->annulee;
         }
+        if (annulee) client_->annuler(requete);
     }
 
     VerificationRessource SearchService::verifierRessource(const std::string& url) {
@@ -780,11 +1256,82 @@ namespace civic {
         return result;
     }
 
-    void SearchService::verifierRessourceAsync(const std::string& url, VerifyCallback callback) {
-        auto result = verifierRessource(url);
-        if (callback) {
-            callback(std::move(result));
+    SearchService::IdOperation SearchService::verifierRessourceAsync(const std::string& url, VerifyCallback callback,
+                                                                     std::chrono::milliseconds timeout) {
+        auto op = std::make_shared<OperationAsync>();
+        IdOperation id = ouvrirOperation(op);
+
+        OptionsVerification options = optionsVerification_;
+        if (timeout.count() > 0) {
+            options.timeoutRequete = timeout;
+        }
+
+        auto lot = creerLot(*client_, *cache_, {url}, options,
+                            std::chrono::steady_clock::now() + options.timeoutRequete,
+            [this, id, callback = std::move(callback)](std::vector<VerificationRessource> verifs) {
+                if (callback) {
+                    callback(std::move(verifs.front()));
+                }
+                fermerOperation(id);
+            });
+        {
+            std::lock_guard<std::mutex> lock(op->mutex);
+            op->lot = lot;
         }
+        lancerVerifications(lot);
+        return id;
+    }
+
+    void SearchService::annuler(IdOperation id) {
+        std::shared_ptr<OperationAsync> op;
+        {
+            std::lock_guard<std::mutex> lock(operationsMutex_);
+            auto it = operations_.find(id);
+            if (it == operations_.end()) return;
+            op = it->second;
+        }
+
+        std::string cle;
+        CacheRecherche::IdAttente attente;
+        HttpsClient::IdRequete requete;
+        std::shared_ptr<LotVerification> lot;
+        {
+            std::lock_guard<std::mutex> lock(op->mutex);
+            op->annulee = true;
+            cle = op->cle;
+            attente = op->attente;
+            requete = op->requete;
+            lot = op->lot;
+        }
+        if (attente) {
+            if (auto detachee = cacheRecherche_->retirer(cle, attente)) {
+                (*detachee)(std::nullopt);
+            }
+        }
+        if (requete) client_->annuler(requete);
+        if (lot) annulerLot(lot);
+    }
+
+    size_t SearchService::operationsEnCours() const {
+        std::lock_guard<std::mutex> lock(operationsMutex_);
+        return operations_.size();
+    }
+
+    SearchService::IdOperation SearchService::ouvrirOperation(std::shared_ptr<OperationAsync> op) {
+        std::lock_guard<std::mutex> lock(operationsMutex_);
+        IdOperation id = prochainId_++;
+        operations_.emplace(id, std::move(op));
+        return id;
+    }
+
+    // Appelé après le callback utilisateur : le destructeur attend que
+    // plus aucun callback ne puisse toucher au service
+    void SearchService::fermerOperation(IdOperation id) {
+        {
+            std::lock_guard<std::mutex> lock(operationsMutex_);
+            operations_.erase(id);
+        }
+        operationsTerminees_.notify_all();
     }
 
     std::optional<JeuDeDonnees> SearchService::getDataset(const std::string& datasetId) {
@@ -834,157 +1381,96 @@ namespace civic {
         return file.good();
     }
 
-    ResultatRecherche SearchService::rechercherLocal(const CriteresRecherche& criteres) {
-        auto start = std::chrono::steady_clock::now();
-
-        std::ifstream file("/data_enriched.json");
-        if (!file.is_open()) {
-            std::cerr << "[SEARCH-LOCAL] Erreur: Impossible d'ouvrir data_enriched.json" << std::endl;
-            return {};
-        }
-
-        std::string json_content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-        file.close();
-
-        simdjson::dom::parser parser;
-        simdjson::padded_string padded(json_content);
-        simdjson::dom::array doc;
-        auto error = parser.parse(padded).get(doc);
-
-        if (error) {
-            std::cerr << "[SEARCH-LOCAL] Erreur de parsing JSON: " << error << std::endl;
-            return {};
-        }
+    void SearchService::setCheminCatalogue(const std::string& chemin) {
+        std::lock_guard<std::mutex> lock(indexLocalMutex_);
+        cheminCatalogue_ = chemin;
+        indexLocal_.reset();
+        prochaineVerificationCatalogue_ = {};
+    }
 
-        std::vector<JeuDeDonnees> all_matches;
+    std::string SearchService::cheminCatalogue() const {
+        std::lock_guard<std::mutex> lock(indexLocalMutex_);
+        return cheminCatalogue_;
+    }
 
-        // Traitement de la requête textuelle
-        std::vector<std::string> query_words;
-        if (!criteres.requete.empty()) {
-            std::string requete_norm = normaliserTexte(criteres.requete);
-            std::stringstream ss(requete_norm);
-            std::string word;
-            while (ss >> word) {
-                query_words.push_back(word);
+    // Les recherches continuent sur l'index courant pendant qu'un seul
+    // appelant reconstruit le nouveau ; un échec garde l'ancien
+    std::shared_ptr<const LocalIndex> SearchService::indexLocal() {
+        auto maintenant = std::chrono::steady_clock::now();
+        std::string chemin;
+        std::shared_ptr<const LocalIndex> actuel;
+        {
+            std::lock_guard<std::mutex> lock(indexLocalMutex_);
+            if (indexLocal_ && maintenant < prochaineVerificationCatalogue_) {
+                return indexLocal_;
             }
+            chemin = cheminCatalogue_;
+            actuel = indexLocal_;
         }
-        
-        // Tags de la thématique
-        std::vector<std::string> tags_thematique = getTagsThematique(criteres.thematique);
 
-        for (simdjson::dom::element datasetEl : doc) {
-            bool match = true;
+        std::unique_lock<std::mutex> chargement(chargementIndexMutex_, std::defer_lock);
+        if (actuel) {
+            if (!chargement.try_lock()) return actuel;
+        } else {
+            chargement.lock();
+        }
 
-            // 1. Filtrage par certification
-            bool is_certified = false;
-            simdjson::dom::element org_el;
-            if (datasetEl["organization"].get(org_el) == simdjson::SUCCESS) {
-                simdjson::dom::array badges;
-                if (org_el["badges"].get(badges) == simdjson::SUCCESS) {
-                    for (auto badge : badges) {
-                        std::string_view kind;
-                        if (badge["kind"].get(kind) == simdjson::SUCCESS && (kind == "public-service" || kind == "certified" || kind == "spd")) {
-                            is_certified = true;
-                            break;
-                        }
-                    }
-                }
-            }
-            if (criteres.uniquementCertifiees && !is_certified) {
-                continue; // Skip non-certified if required
+        // Un autre appelant a pu recharger pendant l'attente
+        {
+            std::lock_guard<std::mutex> lock(indexLocalMutex_);
+            if (chemin != cheminCatalogue_ || indexLocal_ != actuel) {
+                return indexLocal_;
             }
+            prochaineVerificationCatalogue_ = maintenant + std::chrono::seconds(1);
+        }
 
-            // 2. Filtrage textuel (le coeur de la recherche)
-            if (!query_words.empty()) {
-                std::string text_corpus;
-                std::string_view sv;
+        std::error_code ec;
+        auto date = std::filesystem::last_write_time(chemin, ec);
+        if (actuel && (ec || date == dateCatalogue_)) {
+            return actuel;
+        }
 
-                if (datasetEl["title"].get(sv) == simdjson::SUCCESS) text_corpus += std::string(sv) + " ";
-                if (datasetEl["description"].get(sv) == simdjson::SUCCESS) text_corpus += std::string(sv) + " ";
+        auto index = std::make_shared<LocalIndex>();
+        index->setSynonymes(getSynonymes());
+        if (!index->charger(chemin)) {
+            return actuel;
+        }
+        if (actuel) {
+            std::cout << "[SEARCH-LOCAL] Catalogue rechargé: " << chemin << std::endl;
+        }
 
-                simdjson::dom::array tags;
-                if (datasetEl["tags"].get(tags) == simdjson::SUCCESS) {
-                    for (auto tag : tags) {
-                        if (tag.get(sv) == simdjson::SUCCESS) text_corpus += std::string(sv) + " ";
-                    }
-                }
-                
-                simdjson::dom::array enriched_keywords;
-                if (datasetEl["enriched_keywords"].get(enriched_keywords) == simdjson::SUCCESS) {
-                    for (auto keyword : enriched_keywords) {
-                        if (keyword.get(sv) == simdjson::SUCCESS) text_corpus += std::string(sv) + " ";
-                    }
-                }
+        std::lock_guard<std::mutex> lock(indexLocalMutex_);
+        if (chemin != cheminCatalogue_) {
+            return indexLocal_;
+        }
+        indexLocal_ = index;
+        dateCatalogue_ = date;
+        return index;
+    }
 
-                std::string corpus_norm = normaliserTexte(text_corpus);
-                
-                for (const auto& word : query_words) {
-                    if (corpus_norm.find(word) == std::string::npos) {
-                        match = false;
-                        break;
-                    }
-                }
-            }
-            if (!match) continue;
-            
-            // 3. Filtrage par thématique
-            if (criteres.thematique != Thematique::TOUTES) {
-                bool theme_match = false;
-                simdjson::dom::array tags;
-                if (datasetEl["tags"].get(tags) == simdjson::SUCCESS) {
-                    for (auto tag_el : tags) {
-                        std::string_view tag_sv;
-                        if (tag_el.get(tag_sv) == simdjson::SUCCESS) {
-                            for (const auto& theme_tag : tags_thematique) {
-                                if (theme_tag == tag_sv) {
-                                    theme_match = true;
-                                    break;
-                                }
-                            }
-                        }
-                        if (theme_match) break;
-                    }
-                }
-                if (!theme_match) continue;
-            }
+    ResultatRecherche SearchService::rechercherLocal(const CriteresRecherche& criteres) {
+        auto start = std::chrono::steady_clock::now();
 
-            JeuDeDonnees jeu;
-            std::string_view sv;
-            if (datasetEl["id"].get(sv) == simdjson::SUCCESS) jeu.id = std::string(sv);
-            if (datasetEl["title"].get(sv) == simdjson::SUCCESS) jeu.titre = std::string(sv);
-            if (datasetEl["description"].get(sv) == simdjson::SUCCESS) jeu.description = std::string(sv);
-            if (datasetEl["organization"]["name"].get(sv) == simdjson::SUCCESS) jeu.organisation = std::string(sv);
-            jeu.organisationCertifiee = is_certified;
-            
-            simdjson::dom::array resources;
-            if (datasetEl["resources"].get(resources) == simdjson::SUCCESS) {
-                for (auto resEl : resources) {
-                    Ressource res;
-                    if (resEl["url"].get(sv) == simdjson::SUCCESS) res.url = std::string(sv);
-                    if (resEl["title"].get(sv) == simdjson::SUCCESS) res.titre = std::string(sv);
-                    std::string mime;
-                    if (resEl["mime"].get(sv) == simdjson::SUCCESS) mime = std::string(sv);
-                    auto formatOpt = mimeTypeVersFormat(mime);
-                    if(formatOpt.has_value()) res.format = formatOpt.value();
-                    jeu.ressources.push_back(res);
-                }
-            }
-            all_matches.push_back(std::move(jeu));
+        auto index = indexLocal();
+        if (!index) {
+            return {};
         }
 
-        // Pagination
+        // Seuls les jeux de la page sont classés jusqu'au bout et matérialisés
+        size_t debut = criteres.page > 0 && criteres.parPage > 0
+            ? static_cast<size_t>(criteres.page - 1) * criteres.parPage : 0;
+        size_t nombre = criteres.page > 0 && criteres.parPage > 0 ? criteres.parPage : 0;
+        auto page = index->classer(criteres.requete, criteres.uniquementCertifiees,
+                                   getTagsThematique(criteres.thematique), criteres.tri, debut, nombre);
+
         ResultatRecherche resultat;
-        resultat.totalResultats = all_matches.size();
+        resultat.totalResultats = page.total;
         resultat.pageCourante = criteres.page;
         resultat.totalPages = (resultat.totalResultats > 0 && criteres.parPage > 0) ? (resultat.totalResultats + criteres.parPage - 1) / criteres.parPage : 0;
 
-        int start_index = (criteres.page - 1) * criteres.parPage;
-        
-        if (start_index < (int)all_matches.size()) {
-            int end_index = std::min(start_index + criteres.parPage, (int)all_matches.size());
-            for (int i = start_index; i < end_index; ++i) {
-                resultat.jeux.push_back(all_matches[i]);
-            }
+        resultat.jeux.reserve(page.jeux.size());
+        for (const auto& correspondance : page.jeux) {
+            resultat.jeux.push_back(index->jeu(correspondance.jeu, correspondance.score));
         }
         
         auto end = std::chrono::steady_clock::now();
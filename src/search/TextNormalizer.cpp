@@ -0,0 +1,143 @@
+#include "search/TextNormalizer.hpp"
+#include <array>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace civic {
+
+    namespace {
+        // Octet ASCII -> octet émis, 0 pour l'ignorer. Les blancs deviennent
+        // des espaces pour ne pas coller les mots de part et d'autre.
+        constexpr std::array<char, 256> tableAscii = []() {
+            std::array<char, 256> table{};
+            for (int c = 'a'; c <= 'z'; ++c) table[c] = static_cast<char>(c);
+            for (int c = 'A'; c <= 'Z'; ++c) table[c] = static_cast<char>(c - 'A' + 'a');
+            for (int c = '0'; c <= '9'; ++c) table[c] = static_cast<char>(c);
+            table[' '] = ' ';
+            table['\t'] = ' ';
+            table['\n'] = ' ';
+            table['\r'] = ' ';
+            table['-'] = '-';
+            return table;
+        }();
+
+        // Pliage des caractères sur deux octets, de U+00C0 (C3 80) à U+017F
+        // (C5 BF) : Latin-1 Supplément puis Latin Étendu-A
+        constexpr const char* tableLatin[3][64] = {
+            {
+            "a", "a", "a", "a", "a", "a", "ae", "c", "e", "e", "e", "e", "i", "i", "i", "i",
+            "d", "n", "o", "o", "o", "o", "o", "", "o", "u", "u", "u", "u", "y", "th", "ss",
+            "a", "a", "a", "a", "a", "a", "ae", "c", "e", "e", "e", "e", "i", "i", "i", "i",
+            "d", "n", "o", "o", "o", "o", "o", "", "o", "u", "u", "u", "u", "y", "th", "y",
+            },
+            {
+            "a", "a", "a", "a", "a", "a", "c", "c", "c", "c", "c", "c", "c", "c", "d", "d",
+            "d", "d", "e", "e", "e", "e", "e", "e", "e", "e", "e", "e", "g", "g", "g", "g",
+            "g", "g", "g", "g", "h", "h", "h", "h", "i", "i", "i", "i", "i", "i", "i", "i",
+            "i", "i", "ij", "ij", "j", "j", "k", "k", "k", "l", "l", "l", "l", "l", "l", "l",
+            },
+            {
+            "l", "l", "l", "n", "n", "n", "n", "n", "n", "n", "n", "n", "o", "o", "o", "o",
+            "o", "o", "oe", "oe", "r", "r", "r", "r", "r", "r", "s", "s", "s", "s", "s", "s",
+            "s", "s", "t", "t", "t", "t", "t", "t", "u", "u", "u", "u", "u", "u", "u", "u",
+            "u", "u", "u", "u", "w", "w", "y", "y", "y", "z", "z", "z", "z", "z", "z", "s",
+            },
+        };
+
+        bool estContinuation(unsigned char c) { return (c & 0xC0) == 0x80; }
+
+#if defined(__SSE2__)
+        // Copie 16 octets d'un coup s'ils sont tous ASCII et déjà « gardés »
+        // une fois en minuscules ; sinon rien n'est écrit et on repasse au
+        // chemin octet par octet
+        bool blocAscii(const char* entree, char* sortie) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(entree));
+            if (_mm_movemask_epi8(v) != 0) return false;
+
+            __m128i majuscule = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                              _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+            v = _mm_add_epi8(v, _mm_and_si128(majuscule, _mm_set1_epi8(0x20)));
+
+            __m128i lettre = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('a' - 1)),
+                                           _mm_cmplt_epi8(v, _mm_set1_epi8('z' + 1)));
+            __m128i chiffre = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                            _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+            __m128i garde = _mm_or_si128(_mm_or_si128(lettre, chiffre),
+                                         _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                                      _mm_cmpeq_epi8(v, _mm_set1_epi8('-'))));
+            if (_mm_movemask_epi8(garde) != 0xFFFF) return false;
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sortie), v);
+            return true;
+        }
+#endif
+    }
+
+    size_t normaliserTexte(std::string_view texte, char* sortie) {
+        const auto* p = reinterpret_cast<const unsigned char*>(texte.data());
+        const auto* fin = p + texte.size();
+        size_t n = 0;
+
+        while (p < fin) {
+#if defined(__SSE2__)
+            // Les espaces de tête sont retirés par le chemin scalaire
+            if (n > 0 && fin - p >= 16 && blocAscii(reinterpret_cast<const char*>(p), sortie + n)) {
+                p += 16;
+                n += 16;
+                continue;
+            }
+#endif
+            unsigned char c = *p;
+            if (c < 0x80) {
+                char emis = tableAscii[c];
+                if (emis && (emis != ' ' || n > 0)) sortie[n++] = emis;
+                ++p;
+                continue;
+            }
+
+            if (c >= 0xC2 && c <= 0xC5 && p + 1 < fin && estContinuation(p[1])) {
+                if (c == 0xC2) {
+                    // Espace insécable ; le reste du bloc (ponctuation, symboles) est ignoré
+                    if (p[1] == 0xA0 && n > 0) sortie[n++] = ' ';
+                } else {
+                    for (const char* pli = tableLatin[c - 0xC3][p[1] - 0x80]; *pli; ++pli) {
+                        sortie[n++] = *pli;
+                    }
+                }
+                p += 2;
+                continue;
+            }
+
+            // Autre séquence UTF-8 (ou octet invalide) : ignorée en entier
+            ++p;
+            while (p < fin && estContinuation(*p)) ++p;
+        }
+
+        while (n > 0 && sortie[n - 1] == ' ') --n;
+        return n;
+    }
+
+    std::string normaliserTexte(const std::string& texte) {
+        std::string resultat(texte.size(), '\0');
+        resultat.resize(normaliserTexte(std::string_view(texte), resultat.data()));
+        return resultat;
+    }
+
+    std::vector<std::string> decouperMots(const std::string& texteNormalise) {
+        std::vector<std::string> mots;
+        size_t debut = 0;
+        while (debut < texteNormalise.size()) {
+            size_t fin = texteNormalise.find_first_of(" -", debut);
+            if (fin == std::string::npos) fin = texteNormalise.size();
+            if (fin > debut) {
+                mots.emplace_back(texteNormalise, debut, fin - debut);
+            }
+            debut = fin + 1;
+        }
+        return mots;
+    }
+
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "search/CacheRecherche.hpp"
+
+namespace civic {
+namespace test {
+
+namespace {
+    ResultatRecherche resultat(int total, size_t jeux = 1) {
+        ResultatRecherche res;
+        res.totalResultats = total;
+        res.pageCourante = 1;
+        res.totalPages = 1;
+        res.tempsRecherche = std::chrono::milliseconds(0);
+        for (size_t i = 0; i < jeux; ++i) {
+            JeuDeDonnees jeu{};
+            jeu.id = "jeu-" + std::to_string(i);
+            jeu.titre = std::string(200, 'x');
+            res.jeux.push_back(std::move(jeu));
+        }
+        return res;
+    }
+}
+
+TEST(CacheRechercheTest, FirstCallerLeadsAndIsServedOnPublish) {
+    CacheRecherche cache;
+    std::optional<ResultatRecherche> recu;
+
+    auto acces = cache.acquerir("q=eau", [&](std::optional<ResultatRecherche> r) { recu = std::move(r); });
+    EXPECT_TRUE(acces.meneur);
+    EXPECT_FALSE(acces.resultat.has_value());
+    EXPECT_FALSE(recu.has_value());
+
+    cache.publier("q=eau", resultat(42));
+    ASSERT_TRUE(recu.has_value());
+    EXPECT_EQ(recu->totalResultats, 42);
+    EXPECT_EQ(cache.manquees(), 1u);
+    EXPECT_EQ(cache.taille(), 1u);
+}
+
+TEST(CacheRechercheTest, FreshEntryIsServedWithoutWaiting) {
+    CacheRecherche cache;
+    cache.acquerir("q=eau", [](std::optional<ResultatRecherche>) {});
+    cache.publier("q=eau", resultat(7));
+
+    bool appelee = false;
+    auto acces = cache.acquerir("q=eau", [&](std::optional<ResultatRecherche>) { appelee = true; });
+    ASSERT_TRUE(acces.resultat.has_value());
+    EXPECT_EQ(acces.resultat->totalResultats, 7);
+    EXPECT_FALSE(acces.meneur);
+    EXPECT_FALSE(appelee);
+    EXPECT_EQ(cache.trouvees(), 1u);
+}
+
+TEST(CacheRechercheTest, ConcurrentIdenticalQueriesShareOneFetch) {
+    CacheRecherche cache;
+    std::atomic<int> meneurs{0};
+    std::atomic<int> servies{0};
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&]() {
+            auto acces = cache.acquerir("q=bus", [&](std::optional<ResultatRecherche> r) {
+                if (r && r->totalResultats == 3) ++servies;
+            });
+            if (acces.meneur) ++meneurs;
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    EXPECT_EQ(meneurs.load(), 1);
+    EXPECT_EQ(cache.partagees(), 7u);
+    cache.publier("q=bus", resultat(3));
+    EXPECT_EQ(servies.load(), 8);
+}
+
+TEST(CacheRechercheTest, FailureIsDispatchedButNotStored) {
+    CacheRecherche cache;
+    bool echec = false;
+    cache.acquerir("q=eau", [&](std::optional<ResultatRecherche> r) { echec = !r.has_value(); });
+    cache.publier("q=eau", std::nullopt);
+
+    EXPECT_TRUE(echec);
+    EXPECT_EQ(cache.taille(), 0u);
+    EXPECT_TRUE(cache.acquerir("q=eau", [](std::optional<ResultatRecherche>) {}).meneur);
+}
+
+TEST(CacheRechercheTest, RemovedWaiterIsNotServed) {
+    CacheRecherche cache;
+    int appels = 0;
+    cache.acquerir("q=eau", [](std::optional<ResultatRecherche>) {});
+    auto acces = cache.acquerir("q=eau", [&](std::optional<ResultatRecherche>) { ++appels; });
+
+    auto detachee = cache.retirer("q=eau", acces.attente);
+    ASSERT_TRUE(detachee.has_value());
+    EXPECT_FALSE(cache.retirer("q=eau", acces.attente).has_value());
+
+    cache.publier("q=eau", resultat(1));
+    EXPECT_EQ(appels, 0);
+}
+
+TEST(CacheRechercheTest, ExpiredEntryStartsNewFetch) {
+    CacheRecherche cache(1024 * 1024, std::chrono::seconds(0));
+    cache.acquerir("q=eau", [](std::optional<ResultatRecherche>) {});
+    cache.publier("q=eau", resultat(1));
+
+    auto acces = cache.acquerir("q=eau", [](std::optional<ResultatRecherche>) {});
+    EXPECT_FALSE(acces.resultat.has_value());
+    EXPECT_TRUE(acces.meneur);
+}
+
+TEST(CacheRechercheTest, MemoryBoundEvictsOldResults) {
+    size_t unResultat = CacheRecherche::estimerPoids(resultat(0, 10));
+    CacheRecherche cache(unResultat * 4);
+
+    for (int i = 0; i < 64; ++i) {
+        std::string cle = "q=" + std::to_string(i);
+        cache.acquerir(cle, [](std::optional<ResultatRecherche>) {});
+        cache.publier(cle, resultat(i, 10));
+    }
+    EXPECT_LT(cache.taille(), 64u);
+    EXPECT_LE(cache.poids(), unResultat * 4 + 16 * unResultat);
+}
+
+} // namespace test
+} // namespace civic
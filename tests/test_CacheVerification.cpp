@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "search/CacheVerification.hpp"
+
+namespace civic {
+namespace test {
+
+namespace {
+    ReponseHttp reponse(int status, std::optional<std::string> etag = std::nullopt,
+                        std::optional<std::string> lastModified = std::nullopt) {
+        ReponseHttp res;
+        res.status = status;
+        res.etag = std::move(etag);
+        res.lastModified = std::move(lastModified);
+        if (status == 200) {
+            res.contentType = "text/csv";
+            res.contentLength = 2048;
+        }
+        return res;
+    }
+
+    bool aEntete(const OptionsRequete& options, const std::string& nom, const std::string& valeur) {
+        for (const auto& [n, v] : options.entetes) {
+            if (n == nom && v == valeur) return true;
+        }
+        return false;
+    }
+}
+
+TEST(CacheVerificationTest, MissSendsUnconditionalRequest) {
+    CacheVerification cache;
+    OptionsRequete options;
+
+    EXPECT_FALSE(cache.consulter("https://example.org/a.csv", options).has_value());
+    EXPECT_TRUE(options.entetes.empty());
+    EXPECT_EQ(cache.requetes(), 1u);
+}
+
+TEST(CacheVerificationTest, FreshEntryIsServedWithoutRequest) {
+    CacheVerification cache;
+    auto verif = cache.integrer("https://example.org/a.csv", reponse(200, "\"v1\""));
+    EXPECT_TRUE(verif.disponible);
+
+    OptionsRequete options;
+    auto enCache = cache.consulter("https://example.org/a.csv", options);
+    ASSERT_TRUE(enCache.has_value());
+    EXPECT_TRUE(enCache->disponible);
+    EXPECT_EQ(enCache->mimeTypeReel, "text/csv");
+    EXPECT_EQ(enCache->tailleReelle, 2048);
+    EXPECT_EQ(enCache->resourceId, "https://example.org/a.csv");
+    EXPECT_EQ(cache.servies(), 1u);
+}
+
+TEST(CacheVerificationTest, ExpiredEntryIsRevalidatedWithValidators) {
+    CacheVerification cache(100, std::chrono::seconds(0));
+    cache.integrer("https://example.org/a.csv", reponse(200, "\"v1\"", "Wed, 01 Jan 2025 00:00:00 GMT"));
+
+    OptionsRequete options;
+    EXPECT_FALSE(cache.consulter("https://example.org/a.csv", options).has_value());
+    EXPECT_TRUE(aEntete(options, "If-None-Match", "\"v1\""));
+    EXPECT_TRUE(aEntete(options, "If-Modified-Since", "Wed, 01 Jan 2025 00:00:00 GMT"));
+}
+
+TEST(CacheVerificationTest, NotModifiedKeepsStoredMetadata) {
+    CacheVerification cache(100, std::chrono::seconds(0));
+    cache.integrer("https://example.org/a.csv", reponse(200, "\"v1\""));
+
+    auto verif = cache.integrer("https://example.org/a.csv", reponse(304));
+    EXPECT_TRUE(verif.disponible);
+    EXPECT_EQ(verif.httpStatus, 200);
+    EXPECT_EQ(verif.mimeTypeReel, "text/csv");
+    EXPECT_EQ(cache.revalidees(), 1u);
+
+    // La revalidation rafraîchit l'entrée
+    cache.setTtl(std::chrono::hours(1));
+    OptionsRequete options;
+    EXPECT_TRUE(cache.consulter("https://example.org/a.csv", options).has_value());
+}
+
+TEST(CacheVerificationTest, NotModifiedWithoutEntryCountsAsAvailable) {
+    CacheVerification cache;
+    auto verif = cache.integrer("https://example.org/evicted.csv", reponse(304));
+    EXPECT_TRUE(verif.disponible);
+}
+
+TEST(CacheVerificationTest, TransientFailuresAreNotCached) {
+    CacheVerification cache;
+    cache.integrer("https://example.org/down.csv", reponse(0));
+    cache.integrer("https://example.org/busy.csv", reponse(503));
+    EXPECT_EQ(cache.taille(), 0u);
+
+    // Un 404 est une réponse définitive : on la garde
+    auto verif = cache.integrer("https://example.org/gone.csv", reponse(404));
+    EXPECT_FALSE(verif.disponible);
+    OptionsRequete options;
+    auto enCache = cache.consulter("https://example.org/gone.csv", options);
+    ASSERT_TRUE(enCache.has_value());
+    EXPECT_FALSE(enCache->disponible);
+}
+
+TEST(CacheVerificationTest, ExportImportRoundTrip) {
+    CacheVerification source;
+    source.integrer("https://example.org/a.csv", reponse(200, "\"a\""));
+    source.integrer("https://example.org/b.csv", reponse(404));
+
+    CacheVerification destination;
+    destination.importer(source.exporter());
+    EXPECT_EQ(destination.taille(), 2u);
+
+    auto a = destination.entree("https://example.org/a.csv");
+    ASSERT_TRUE(a.has_value());
+    EXPECT_EQ(a->etag, "\"a\"");
+}
+
+} // namespace test
+} // namespace civic
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "data/CatalogImporter.hpp"
+#include "data/StorageEngine.hpp"
+
+namespace civic {
+namespace test {
+
+namespace {
+    const char* catalogue = R"([
+        {"id": "a1", "title": "Population", "downloads": 12, "score": 0.5, "certified": true,
+         "tags": ["insee", "population"],
+         "organization": {"name": "INSEE", "badges": []},
+         "resources": [{"format": "csv", "filesize": 1024}, {"format": "json", "filesize": null}],
+         "mixed": 1},
+        {"id": "a2", "title": "Déchets", "downloads": null, "score": 3, "certified": false,
+         "tags": [], "organization": null,
+         "resources": [{"format": "xls", "url": "https://example.org"}],
+         "mixed": "un"},
+        {"id": "a3", "extra": null}
+    ])";
+}
+
+TEST(CatalogImporterTest, InfersTypedSchema) {
+    StorageEngine engine(":memory:");
+    CatalogImporter importer(engine);
+
+    auto result = importer.importJson(catalogue);
+    ASSERT_TRUE(result.ok);
+    EXPECT_EQ(result.columns, 10u);
+
+    EXPECT_EQ(importer.createStatement(),
+              "CREATE TABLE \"datasets_enriched\" ("
+              "\"id\" VARCHAR, \"title\" VARCHAR, \"downloads\" BIGINT, \"score\" DOUBLE, "
+              "\"certified\" BOOLEAN, \"tags\" VARCHAR[], \"organization\" VARCHAR, "
+              "\"resources\" STRUCT(\"format\" VARCHAR, \"filesize\" BIGINT, \"url\" VARCHAR)[], "
+              "\"mixed\" VARCHAR, \"extra\" VARCHAR)");
+}
+
+TEST(CatalogImporterTest, NestedColumnsAreConfigurable) {
+    StorageEngine engine(":memory:");
+    CatalogImporter importer(engine);
+
+    CatalogImportOptions options;
+    options.table = "catalogue";
+    options.nestedColumns = {"organization"};
+    auto result = importer.importJson(catalogue, options);
+    ASSERT_TRUE(result.ok);
+
+    const auto& sql = importer.createStatement();
+    EXPECT_EQ(sql.rfind("CREATE TABLE \"catalogue\" (", 0), 0u);
+    EXPECT_NE(sql.find("\"tags\" VARCHAR,"), std::string::npos);
+    EXPECT_NE(sql.find("\"organization\" STRUCT(\"name\" VARCHAR, \"badges\" VARCHAR[])"), std::string::npos);
+    EXPECT_NE(sql.find("\"resources\" VARCHAR,"), std::string::npos);
+}
+
+TEST(CatalogImporterTest, SchemaCoversKeysSeenOnlyInLastRow) {
+    std::string json = "[";
+    for (int i = 0; i < 20000; ++i) {
+        json += R"({"id": "d)" + std::to_string(i) + R"(", "downloads": )" + std::to_string(i) + "},";
+    }
+    json += R"({"id": "last", "downloads": "beaucoup", "late": 1.5}])";
+
+    StorageEngine engine(":memory:");
+    CatalogImporter importer(engine);
+    auto result = importer.importJson(json);
+    ASSERT_TRUE(result.ok);
+    EXPECT_EQ(result.columns, 3u);
+    EXPECT_EQ(importer.createStatement(),
+              "CREATE TABLE \"datasets_enriched\" (\"id\" VARCHAR, \"downloads\" VARCHAR, \"late\" DOUBLE)");
+}
+
+TEST(CatalogImporterTest, ParallelWritersLoadEveryRow) {
+    std::string json = "[";
+    for (int i = 0; i < 1000; ++i) {
+        if (i) json += ",";
+        json += R"({"id": "d)" + std::to_string(i) + R"(", "downloads": )" + std::to_string(i) +
+                R"(, "tags": ["t)" + std::to_string(i % 7) + R"("]})";
+    }
+    json += "]";
+
+    StorageEngine engine(":memory:");
+    CatalogImporter importer(engine);
+    CatalogImportOptions options;
+    options.writers = 4;
+    options.chunkRows = 64;
+    auto result = importer.importJson(json, options);
+    ASSERT_TRUE(result.ok);
+    EXPECT_EQ(result.rows, 1000u);
+    EXPECT_EQ(result.columns, 3u);
+
+    auto con = engine.createConnection();
+    auto count = con->Query("SELECT COUNT(*) FROM datasets_enriched WHERE len(tags) = 1");
+    ASSERT_FALSE(count->HasError());
+    EXPECT_EQ(count->GetValue(0, 0).GetValue<int64_t>(), 1000);
+}
+
+TEST(CatalogImporterTest, ReimportSwapsInStagingTable) {
+    StorageEngine engine(":memory:");
+    CatalogImporter importer(engine);
+    ASSERT_TRUE(importer.importJson(catalogue).ok);
+    ASSERT_TRUE(importer.importJson(R"([{"id": "b1"}, {"id": "b2"}])").ok);
+
+    auto con = engine.createConnection();
+    auto tables = con->Query("SELECT COUNT(*) FROM duckdb_tables() WHERE table_name = 'datasets_enriched__staging'");
+    ASSERT_FALSE(tables->HasError());
+    EXPECT_EQ(tables->GetValue(0, 0).GetValue<int64_t>(), 0);
+    auto count = con->Query("SELECT COUNT(*) FROM datasets_enriched");
+    ASSERT_FALSE(count->HasError());
+    EXPECT_EQ(count->GetValue(0, 0).GetValue<int64_t>(), 2);
+}
+
+TEST(CatalogImporterTest, RejectsInvalidCatalog) {
+    StorageEngine engine(":memory:");
+    CatalogImporter importer(engine);
+
+    EXPECT_FALSE(importer.importJson("[{\"id\": ").ok);
+    EXPECT_FALSE(importer.importJson("{\"id\": \"not an array\"}").ok);
+    EXPECT_FALSE(importer.importJson("[1, 2, 3]").ok);
+    EXPECT_FALSE(importer.importFile("/nonexistent/catalogue.json").ok);
+}
+
+} // namespace test
+} // namespace civic
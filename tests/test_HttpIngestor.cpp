@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 #include <thread>
 #include <chrono>
+#include <atomic>
+#include <memory>
 #include <boost/asio.hpp>
 #include "Network/HttpIngestor.hpp"
+#include "core/Payload.hpp"
 #include "core/RingBuffer.hpp"
 
 namespace civic {
@@ -10,7 +13,7 @@ namespace test {
 
 
 TEST(HttpIngestorTest, ConstructorValid) {
-    RingBuffer<std::string> buffer(16);
+    RingBuffer<Payload> buffer(16);
     boost::asio::io_context ioc;
     
     EXPECT_NO_THROW({
@@ -19,8 +22,8 @@ TEST(HttpIngestorTest, ConstructorValid) {
 }
 
 TEST(HttpIngestorTest, MultipleIngestorsOnSameContext) {
-    RingBuffer<std::string> buffer1(16);
-    RingBuffer<std::string> buffer2(16);
+    RingBuffer<Payload> buffer1(16);
+    RingBuffer<Payload> buffer2(16);
     boost::asio::io_context ioc;
     
     EXPECT_NO_THROW({
@@ -30,7 +33,7 @@ TEST(HttpIngestorTest, MultipleIngestorsOnSameContext) {
 }
 
 TEST(HttpIngestorTest, FetchCreatesRequest) {
-    RingBuffer<std::string> buffer(16);
+    RingBuffer<Payload> buffer(16);
     boost::asio::io_context ioc;
     HttpIngestor ingestor(buffer, ioc);
     
@@ -38,7 +41,7 @@ TEST(HttpIngestorTest, FetchCreatesRequest) {
 }
 
 TEST(HttpIngestorTest, FetchWithDifferentPaths) {
-    RingBuffer<std::string> buffer(16);
+    RingBuffer<Payload> buffer(16);
     boost::asio::io_context ioc;
     HttpIngestor ingestor(buffer, ioc);
     
@@ -48,7 +51,7 @@ TEST(HttpIngestorTest, FetchWithDifferentPaths) {
 }
 
 TEST(HttpIngestorTest, FetchWithDifferentPorts) {
-    RingBuffer<std::string> buffer(16);
+    RingBuffer<Payload> buffer(16);
     boost::asio::io_context ioc;
     
     HttpIngestor ingestor1(buffer, ioc);
@@ -87,7 +90,7 @@ TEST_F(HttpIngestorIntegrationTest, FetchFromHttpbin) {
         GTEST_SKIP() << "Network not available";
     }
     
-    RingBuffer<std::string> buffer(16);
+    RingBuffer<Payload> buffer(16);
     boost::asio::io_context ioc;
     HttpIngestor ingestor(buffer, ioc);
     
@@ -98,7 +101,7 @@ TEST_F(HttpIngestorIntegrationTest, FetchFromHttpbin) {
     });
     
     auto start = std::chrono::steady_clock::now();
-    std::string data;
+    Payload data;
     bool received = false;
     
     while (std::chrono::steady_clock::now() - start < std::chrono::seconds(10)) {
@@ -114,22 +117,23 @@ TEST_F(HttpIngestorIntegrationTest, FetchFromHttpbin) {
     
     if (received) {
         EXPECT_FALSE(data.empty());
+        std::string_view body = data.view();
         // Skip if server returned an error page (503, etc.)
-        if (data.find("<html>") != std::string::npos || 
-            data.find("Service Unavailable") != std::string::npos ||
-            data.find("503") != std::string::npos) {
+        if (body.find("<html>") != std::string::npos || 
+            body.find("Service Unavailable") != std::string::npos ||
+            body.find("503") != std::string::npos) {
             GTEST_SKIP() << "Server returned error page - service unavailable";
         }
         // Check for valid JSON structure (curly braces)
-        bool hasJsonStructure = (data.find("{") != std::string::npos);
-        EXPECT_TRUE(hasJsonStructure) << "Response: " << data.substr(0, 200);
+        bool hasJsonStructure = (body.find("{") != std::string::npos);
+        EXPECT_TRUE(hasJsonStructure) << "Response: " << body.substr(0, 200);
     } else {
         GTEST_SKIP() << "Request timed out";
     }
 }
 
 TEST_F(HttpIngestorIntegrationTest, FetchInvalidHost) {
-    RingBuffer<std::string> buffer(16);
+    RingBuffer<Payload> buffer(16);
     boost::asio::io_context ioc;
     HttpIngestor ingestor(buffer, ioc);
     
@@ -144,18 +148,19 @@ TEST_F(HttpIngestorIntegrationTest, FetchInvalidHost) {
     ioc.stop();
     ioThread.join();
     
-    std::string data;
+    Payload data;
     EXPECT_FALSE(buffer.pop(data));
 }
 
 TEST(HttpIngestorTest, BufferIntegration) {
-    RingBuffer<std::string> buffer(4);
+    RingBuffer<Payload> buffer(4);
     boost::asio::io_context ioc;
+    PayloadPool pool;
     
-    buffer.push("data1");
-    buffer.push("data2");
-    buffer.push("data3");
-    buffer.push("data4");
+    buffer.push(pool.copyOf("data1"));
+    buffer.push(pool.copyOf("data2"));
+    buffer.push(pool.copyOf("data3"));
+    buffer.push(pool.copyOf("data4"));
     
     HttpIngestor ingestor(buffer, ioc);
     
@@ -163,7 +168,7 @@ TEST(HttpIngestorTest, BufferIntegration) {
 }
 
 TEST(HttpIngestorTest, AsyncOperationCancellation) {
-    RingBuffer<std::string> buffer(16);
+    RingBuffer<Payload> buffer(16);
     boost::asio::io_context ioc;
     HttpIngestor ingestor(buffer, ioc);
     
@@ -175,7 +180,7 @@ TEST(HttpIngestorTest, AsyncOperationCancellation) {
 }
 
 TEST(HttpIngestorTest, MultipleSequentialFetches) {
-    RingBuffer<std::string> buffer(32);
+    RingBuffer<Payload> buffer(32);
     boost::asio::io_context ioc;
     
     for (int i = 0; i < 5; ++i) {
@@ -187,7 +192,7 @@ TEST(HttpIngestorTest, MultipleSequentialFetches) {
 }
 
 TEST(HttpIngestorTest, EmptyPath) {
-    RingBuffer<std::string> buffer(16);
+    RingBuffer<Payload> buffer(16);
     boost::asio::io_context ioc;
     HttpIngestor ingestor(buffer, ioc);
     
@@ -195,7 +200,7 @@ TEST(HttpIngestorTest, EmptyPath) {
 }
 
 TEST(HttpIngestorTest, LongPath) {
-    RingBuffer<std::string> buffer(16);
+    RingBuffer<Payload> buffer(16);
     boost::asio::io_context ioc;
     HttpIngestor ingestor(buffer, ioc);
     
@@ -204,7 +209,7 @@ TEST(HttpIngestorTest, LongPath) {
 }
 
 TEST(HttpIngestorTest, PathWithQueryParams) {
-    RingBuffer<std::string> buffer(16);
+    RingBuffer<Payload> buffer(16);
     boost::asio::io_context ioc;
     HttpIngestor ingestor(buffer, ioc);
     
@@ -212,7 +217,7 @@ TEST(HttpIngestorTest, PathWithQueryParams) {
 }
 
 TEST(HttpIngestorTest, PathWithSpecialCharacters) {
-    RingBuffer<std::string> buffer(16);
+    RingBuffer<Payload> buffer(16);
     boost::asio::io_context ioc;
     HttpIngestor ingestor(buffer, ioc);
     
@@ -220,7 +225,7 @@ TEST(HttpIngestorTest, PathWithSpecialCharacters) {
 }
 
 TEST(HttpIngestorTest, DestructorCleanup) {
-    RingBuffer<std::string> buffer(16);
+    RingBuffer<Payload> buffer(16);
     boost::asio::io_context ioc;
     
     {
@@ -232,7 +237,7 @@ TEST(HttpIngestorTest, DestructorCleanup) {
 }
 
 TEST(HttpIngestorTest, RapidCreationDestruction) {
-    RingBuffer<std::string> buffer(16);
+    RingBuffer<Payload> buffer(16);
     boost::asio::io_context ioc;
     
     for (int i = 0; i < 10; ++i) {
@@ -244,5 +249,194 @@ TEST(HttpIngestorTest, RapidCreationDestruction) {
     SUCCEED();
 }
 
+// Minimal keep-alive HTTP server on 127.0.0.1 for the pooling tests.
+// Answers every GET with {"n": <count>} and closes after `closeEvery`
+// responses on a connection when set.
+class LocalHttpServer {
+public:
+    explicit LocalHttpServer(size_t closeEvery = 0)
+        : acceptor_(ioc_, tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 0)),
+          closeEvery_(closeEvery)
+    {
+        accept();
+        thread_ = std::thread([this]() { ioc_.run(); });
+    }
+
+    ~LocalHttpServer() {
+        ioc_.stop();
+        thread_.join();
+    }
+
+    std::string port() const { return std::to_string(acceptor_.local_endpoint().port()); }
+    size_t accepted() const { return accepted_.load(); }
+    size_t served() const { return served_.load(); }
+
+private:
+    struct Connection : std::enable_shared_from_this<Connection> {
+        Connection(tcp::socket socket, LocalHttpServer& server) : stream(std::move(socket)), server(server) {}
+
+        void read() {
+            req = {};
+            http::async_read(stream, buffer, req, [self = shared_from_this()](beast::error_code ec, size_t) {
+                if (!ec) self->respond();
+            });
+        }
+
+        void respond() {
+            size_t n = ++server.served_;
+            bool close = server.closeEvery_ > 0 && ++answered % server.closeEvery_ == 0;
+            res = {http::status::ok, 11};
+            res.set(http::field::content_type, "application/json");
+            res.body() = "{\"n\": " + std::to_string(n) + "}";
+            res.keep_alive(!close);
+            res.prepare_payload();
+            http::async_write(stream, res, [self = shared_from_this(), close](beast::error_code ec, size_t) {
+                if (ec) return;
+                if (close) {
+                    beast::error_code ignored;
+                    self->stream.socket().shutdown(tcp::socket::shutdown_send, ignored);
+                    return;
+                }
+                self->read();
+            });
+        }
+
+        beast::tcp_stream stream;
+        LocalHttpServer& server;
+        beast::flat_buffer buffer;
+        http::request<http::empty_body> req;
+        http::response<http::string_body> res;
+        size_t answered = 0;
+    };
+
+    void accept() {
+        acceptor_.async_accept([this](beast::error_code ec, tcp::socket socket) {
+            if (ec) return;
+            ++accepted_;
+            std::make_shared<Connection>(std::move(socket), *this)->read();
+            accept();
+        });
+    }
+
+    boost::asio::io_context ioc_;
+    tcp::acceptor acceptor_;
+    size_t closeEvery_;
+    std::atomic<size_t> accepted_{0};
+    std::atomic<size_t> served_{0};
+    std::thread thread_;
+};
+
+template<typename Pred>
+bool waitFor(Pred pred, std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+TEST(HttpIngestorTest, ReusesConnectionForSameHost) {
+    LocalHttpServer server;
+    RingBuffer<Payload> buffer(64);
+    boost::asio::io_context ioc;
+    auto work = boost::asio::make_work_guard(ioc);
+    std::thread ioThread([&ioc]() { ioc.run(); });
+    
+    HttpIngestor ingestor(buffer, ioc);
+    for (int i = 0; i < 10; ++i) {
+        ingestor.fetch("127.0.0.1", server.port(), "/item/" + std::to_string(i));
+    }
+    
+    EXPECT_TRUE(waitFor([&]() { return ingestor.responses() == 10; }));
+    EXPECT_EQ(server.accepted(), 1u);
+    EXPECT_EQ(ingestor.connectionsOpened(), 1u);
+    
+    // Pipelined responses come back in request order
+    for (int i = 1; i <= 10; ++i) {
+        Payload data;
+        ASSERT_TRUE(buffer.pop(data));
+        EXPECT_EQ(data.view(), "{\"n\": " + std::to_string(i) + "}");
+    }
+    
+    ingestor.stop();
+    work.reset();
+    ioc.stop();
+    ioThread.join();
+}
+
+TEST(HttpIngestorTest, ReconnectsWhenServerCloses) {
+    LocalHttpServer server(3);
+    RingBuffer<Payload> buffer(64);
+    boost::asio::io_context ioc;
+    auto work = boost::asio::make_work_guard(ioc);
+    std::thread ioThread([&ioc]() { ioc.run(); });
+    
+    HttpIngestor ingestor(buffer, ioc);
+    for (int i = 0; i < 9; ++i) {
+        ingestor.fetch("127.0.0.1", server.port(), "/");
+    }
+    
+    EXPECT_TRUE(waitFor([&]() { return ingestor.responses() == 9; }));
+    EXPECT_EQ(server.served(), 9u);
+    EXPECT_EQ(server.accepted(), 3u);
+    
+    ingestor.stop();
+    // Counters survive the shutdown for final reporting
+    EXPECT_EQ(ingestor.responses(), 9u);
+    EXPECT_EQ(ingestor.connectionsOpened(), 3u);
+    work.reset();
+    ioc.stop();
+    ioThread.join();
+}
+
+TEST(HttpIngestorTest, PollKeepsFetching) {
+    LocalHttpServer server;
+    RingBuffer<Payload> buffer(1024);
+    boost::asio::io_context ioc;
+    auto work = boost::asio::make_work_guard(ioc);
+    std::thread ioThread([&ioc]() { ioc.run(); });
+    
+    HttpIngestor ingestor(buffer, ioc);
+    ingestor.poll("127.0.0.1", server.port(), "/stream", std::chrono::milliseconds(1));
+    
+    EXPECT_TRUE(waitFor([&]() { return ingestor.responses() >= 20; }));
+    ingestor.stop();
+    
+    EXPECT_EQ(server.accepted(), 1u);
+    Payload data;
+    EXPECT_TRUE(buffer.pop(data));
+    EXPECT_FALSE(data.empty());
+    
+    work.reset();
+    ioc.stop();
+    ioThread.join();
+}
+
+TEST(HttpIngestorTest, OversizedResponseIsDroppedNotRetried) {
+    LocalHttpServer server;
+    RingBuffer<Payload> buffer(16);
+    boost::asio::io_context ioc;
+    auto work = boost::asio::make_work_guard(ioc);
+    std::thread ioThread([&ioc]() { ioc.run(); });
+    
+    HttpIngestorOptions options;
+    options.maxBodyBytes = 4;
+    HttpIngestor ingestor(buffer, ioc, options);
+    ingestor.poll("127.0.0.1", server.port(), "/big", std::chrono::milliseconds(1));
+    
+    EXPECT_TRUE(waitFor([&]() { return ingestor.dropped() == 1; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(server.served(), 1u);
+    EXPECT_EQ(ingestor.responses(), 0u);
+    Payload data;
+    EXPECT_FALSE(buffer.pop(data));
+    
+    ingestor.stop();
+    work.reset();
+    ioc.stop();
+    ioThread.join();
+}
+
 } // namespace test
 } // namespace civic
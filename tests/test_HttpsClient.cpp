@@ -0,0 +1,314 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast.hpp>
+#include <boost/beast/ssl.hpp>
+#include <openssl/pem.h>
+#include <openssl/x509v3.h>
+#include "search/HttpsClient.hpp"
+
+namespace civic {
+namespace test {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace ssl = boost::asio::ssl;
+using tcp = boost::asio::ip::tcp;
+
+// Self-signed certificate for 127.0.0.1, generated once per test binary
+struct TestCertificate {
+    std::string cert;
+    std::string key;
+
+    static const TestCertificate& get() {
+        static const TestCertificate instance = generate();
+        return instance;
+    }
+
+private:
+    static std::string drain(BIO* bio) {
+        char* data = nullptr;
+        long len = BIO_get_mem_data(bio, &data);
+        std::string out(data, static_cast<size_t>(len));
+        BIO_free(bio);
+        return out;
+    }
+
+    static TestCertificate generate() {
+        EVP_PKEY* pkey = EVP_EC_gen("P-256");
+        X509* x509 = X509_new();
+        X509_set_version(x509, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(x509), 1);
+        X509_gmtime_adj(X509_getm_notBefore(x509), -60);
+        X509_gmtime_adj(X509_getm_notAfter(x509), 3600);
+        X509_set_pubkey(x509, pkey);
+
+        X509_NAME* name = X509_get_subject_name(x509);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                                   reinterpret_cast<const unsigned char*>("127.0.0.1"), -1, -1, 0);
+        X509_set_issuer_name(x509, name);
+
+        X509V3_CTX ctx;
+        X509V3_set_ctx_nodb(&ctx);
+        X509V3_set_ctx(&ctx, x509, x509, nullptr, nullptr, 0);
+        X509_EXTENSION* san = X509V3_EXT_conf_nid(nullptr, &ctx, NID_subject_alt_name, "IP:127.0.0.1");
+        X509_add_ext(x509, san, -1);
+        X509_EXTENSION_free(san);
+        X509_sign(x509, pkey, EVP_sha256());
+
+        BIO* certBio = BIO_new(BIO_s_mem());
+        PEM_write_bio_X509(certBio, x509);
+        BIO* keyBio = BIO_new(BIO_s_mem());
+        PEM_write_bio_PrivateKey(keyBio, pkey, nullptr, nullptr, 0, nullptr, nullptr);
+
+        TestCertificate result{drain(certBio), drain(keyBio)};
+        X509_free(x509);
+        EVP_PKEY_free(pkey);
+        return result;
+    }
+};
+
+// closeEvery: answers "Connection: close" every N responses.
+// dropIdle: announces keep-alive but drops the socket after each response,
+// like a server whose idle timeout fired.
+class LocalHttpsServer {
+public:
+    explicit LocalHttpsServer(size_t closeEvery = 0, bool dropIdle = false)
+        : ctx_(ssl::context::tls_server),
+          acceptor_(ioc_, tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 0)),
+          closeEvery_(closeEvery), dropIdle_(dropIdle)
+    {
+        const auto& cert = TestCertificate::get();
+        ctx_.use_certificate_chain(boost::asio::buffer(cert.cert));
+        ctx_.use_private_key(boost::asio::buffer(cert.key), ssl::context::pem);
+        accept();
+        thread_ = std::thread([this]() { ioc_.run(); });
+    }
+
+    ~LocalHttpsServer() {
+        ioc_.stop();
+        thread_.join();
+    }
+
+    std::string url(const std::string& target = "/") const {
+        return "https://127.0.0.1:" + std::to_string(acceptor_.local_endpoint().port()) + target;
+    }
+    size_t accepted() const { return accepted_.load(); }
+    size_t served() const { return served_.load(); }
+
+private:
+    struct Connection : std::enable_shared_from_this<Connection> {
+        Connection(tcp::socket socket, LocalHttpsServer& server)
+            : stream(std::move(socket), server.ctx_), server(server) {}
+
+        void start() {
+            stream.async_handshake(ssl::stream_base::server, [self = shared_from_this()](beast::error_code ec) {
+                if (!ec) self->read();
+            });
+        }
+
+        void read() {
+            req = {};
+            http::async_read(stream, buffer, req, [self = shared_from_this()](beast::error_code ec, size_t) {
+                if (!ec) self->respond();
+            });
+        }
+
+        void respond() {
+            size_t n = ++server.served_;
+            bool close = server.closeEvery_ > 0 && ++answered % server.closeEvery_ == 0;
+            res = {http::status::ok, 11};
+            res.set(http::field::content_type, "application/json");
+            res.set(http::field::etag, "\"v" + std::to_string(n) + "\"");
+            res.keep_alive(!close);
+            if (req.method() == http::verb::head) {
+                res.content_length(1234);
+            } else {
+                res.body() = std::string(req.target()) + " " + std::to_string(n);
+                res.prepare_payload();
+            }
+
+            http::async_write(stream, res, [self = shared_from_this(), close](beast::error_code ec, size_t) {
+                if (ec) return;
+                if (close || self->server.dropIdle_) {
+                    beast::error_code ignored;
+                    beast::get_lowest_layer(self->stream).socket().shutdown(tcp::socket::shutdown_both, ignored);
+                    return;
+                }
+                self->read();
+            });
+        }
+
+        beast::ssl_stream<beast::tcp_stream> stream;
+        LocalHttpsServer& server;
+        beast::flat_buffer buffer;
+        http::request<http::empty_body> req;
+        http::response<http::string_body> res;
+        size_t answered = 0;
+    };
+
+    void accept() {
+        acceptor_.async_accept([this](beast::error_code ec, tcp::socket socket) {
+            if (ec) return;
+            ++accepted_;
+            std::make_shared<Connection>(std::move(socket), *this)->start();
+            accept();
+        });
+    }
+
+    boost::asio::io_context ioc_;
+    ssl::context ctx_;
+    tcp::acceptor acceptor_;
+    size_t closeEvery_;
+    bool dropIdle_;
+    std::atomic<size_t> accepted_{0};
+    std::atomic<size_t> served_{0};
+    std::thread thread_;
+};
+
+TEST(HttpsClientTest, ReusesKeepAliveConnection) {
+    LocalHttpsServer server;
+    HttpsClient client;
+
+    for (int i = 1; i <= 5; ++i) {
+        auto res = client.get(server.url("/item"));
+        ASSERT_TRUE(res.ok()) << res.erreur;
+        EXPECT_EQ(res.status, 200);
+        EXPECT_EQ(res.corps, "/item " + std::to_string(i));
+        EXPECT_EQ(res.connexionReutilisee, i > 1);
+    }
+
+    EXPECT_EQ(server.accepted(), 1u);
+    EXPECT_EQ(client.connexionsOuvertes(), 1u);
+}
+
+TEST(HttpsClientTest, ResumesTlsSessionOnReconnect) {
+    LocalHttpsServer server(1);
+    HttpsClient client;
+
+    for (int i = 0; i < 3; ++i) {
+        auto res = client.get(server.url());
+        ASSERT_TRUE(res.ok()) << res.erreur;
+        EXPECT_EQ(res.sessionReprise, i > 0);
+    }
+
+    EXPECT_EQ(server.accepted(), 3u);
+    EXPECT_EQ(client.sessionsReprises(), 2u);
+}
+
+TEST(HttpsClientTest, RetriesWhenPooledConnectionWasDropped) {
+    LocalHttpsServer server(0, true);
+    HttpsClient client;
+
+    auto first = client.get(server.url());
+    ASSERT_TRUE(first.ok()) << first.erreur;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    auto second = client.get(server.url());
+    ASSERT_TRUE(second.ok()) << second.erreur;
+    EXPECT_EQ(second.status, 200);
+    EXPECT_EQ(server.accepted(), 2u);
+}
+
+TEST(HttpsClientTest, HeadReadsHeadersWithoutBody) {
+    LocalHttpsServer server;
+    HttpsClient client;
+    client.ajouterCertificatRacine(TestCertificate::get().cert);
+
+    OptionsRequete options;
+    options.verifierCertificat = true;
+    for (int i = 0; i < 2; ++i) {
+        auto res = client.head(server.url("/data.csv"), options);
+        ASSERT_TRUE(res.ok()) << res.erreur;
+        EXPECT_EQ(res.status, 200);
+        ASSERT_TRUE(res.contentLength.has_value());
+        EXPECT_EQ(*res.contentLength, 1234);
+        EXPECT_EQ(res.contentType, "application/json");
+        EXPECT_TRUE(res.etag.has_value());
+        EXPECT_TRUE(res.corps.empty());
+    }
+    EXPECT_EQ(server.accepted(), 1u);
+}
+
+TEST(HttpsClientTest, BodyLargerThanLimitFails) {
+    LocalHttpsServer server;
+    HttpsClient client;
+
+    OptionsRequete options;
+    options.tailleMaxCorps = 8;
+    auto res = client.get(server.url("/a-rather-long-target"), options);
+    EXPECT_FALSE(res.ok());
+    EXPECT_NE(res.erreur.find("Lecture"), std::string::npos);
+    EXPECT_TRUE(res.corps.empty());
+
+    auto small = client.get(server.url("/ok"));
+    ASSERT_TRUE(small.ok()) << small.erreur;
+    EXPECT_EQ(small.corps, "/ok 2");
+}
+
+TEST(HttpsClientTest, VerifiedRequestRejectsUntrustedCertificate) {
+    LocalHttpsServer server;
+    HttpsClient client;
+
+    OptionsRequete options;
+    options.verifierCertificat = true;
+    auto res = client.head(server.url(), options);
+    EXPECT_FALSE(res.ok());
+    EXPECT_EQ(res.status, 0);
+
+    // Unverified requests keep working against the same host
+    auto unverified = client.get(server.url());
+    EXPECT_TRUE(unverified.ok()) << unverified.erreur;
+}
+
+TEST(HttpsClientTest, InvalidUrlFailsImmediately) {
+    HttpsClient client;
+    auto res = client.get("not a url");
+    EXPECT_FALSE(res.ok());
+    EXPECT_FALSE(res.erreur.empty());
+}
+
+TEST(HttpsClientTest, TimesOutOnSilentServer) {
+    boost::asio::io_context ioc;
+    tcp::acceptor acceptor(ioc, tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 0));
+    HttpsClient client;
+
+    OptionsRequete options;
+    options.timeout = std::chrono::milliseconds(200);
+    auto start = std::chrono::steady_clock::now();
+    auto res = client.get("https://127.0.0.1:" + std::to_string(acceptor.local_endpoint().port()) + "/", options);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_FALSE(res.ok());
+    EXPECT_LT(elapsed, std::chrono::seconds(5));
+}
+
+TEST(HttpsClientTest, CancelledRequestCallsBackOnce) {
+    boost::asio::io_context ioc;
+    tcp::acceptor acceptor(ioc, tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 0));
+    HttpsClient client;
+
+    std::promise<ReponseHttp> promesse;
+    std::atomic<int> rappels{0};
+    auto id = client.envoyerAsync(MethodeHttp::GET,
+        "https://127.0.0.1:" + std::to_string(acceptor.local_endpoint().port()) + "/", {},
+        [&](ReponseHttp res) {
+            if (++rappels == 1) promesse.set_value(std::move(res));
+        });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    client.annuler(id);
+
+    auto future = promesse.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_FALSE(future.get().ok());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(rappels.load(), 1);
+}
+
+} // namespace test
+} // namespace civic
@@ -17,10 +17,9 @@ TEST(IntegrationTest, DataPipeline) {
     ThreadPool pool(2);
     
     std::atomic<int> processedCount{0};
-    std::atomic<bool> shouldRun{true};
     
-    pool.setTask([&]() {
-        while (shouldRun.load()) {
+    pool.startService([&](std::stop_token stop) {
+        while (!stop.stop_requested()) {
             std::string data;
             if (buffer.pop(data)) {
                 storage.ingest(*con, data);
@@ -46,7 +45,6 @@ TEST(IntegrationTest, DataPipeline) {
     }
     
     std::this_thread::sleep_for(std::chrono::milliseconds(500));
-    shouldRun = false;
     pool.stop();
     
     EXPECT_EQ(processedCount.load(), numItems);
@@ -63,7 +61,7 @@ TEST(IntegrationTest, MultipleProducerPipeline) {
     const int totalItems = numProducers * itemsPerProducer;
     
     ThreadPool pool(2);
-    pool.setTask([&]() {
+    pool.startService([&](std::stop_token) {
         while (shouldRun.load() || consumedCount.load() < producedCount.load()) {
             std::string data;
             if (buffer.pop(data)) {
@@ -199,10 +197,9 @@ TEST(IntegrationTest, SimulatedHttpIngestion) {
     ThreadPool pool(2);
     
     std::atomic<int> ingestedCount{0};
-    std::atomic<bool> shouldRun{true};
     
-    pool.setTask([&]() {
-        while (shouldRun.load()) {
+    pool.startService([&](std::stop_token stop) {
+        while (!stop.stop_requested()) {
             std::string data;
             if (buffer.pop(data)) {
                 storage.ingest(*con, data);
@@ -228,7 +225,6 @@ TEST(IntegrationTest, SimulatedHttpIngestion) {
     }
     
     std::this_thread::sleep_for(std::chrono::milliseconds(300));
-    shouldRun = false;
     pool.stop();
     
     EXPECT_EQ(ingestedCount.load(), static_cast<int>(simulatedResponses.size()));
@@ -276,37 +272,46 @@ TEST(IntegrationTest, BufferFullRecovery) {
 }
 
 
-TEST(IntegrationTest, ThroughputBenchmark) {
-    RingBuffer<std::string> buffer(1024);
-    std::atomic<int> count{0};
-    std::atomic<bool> running{true};
-    
+namespace {
+
+template<typename Buffer>
+void runThroughputBenchmark(const char* label) {
     const auto testDuration = std::chrono::seconds(1);
     
-    std::thread consumer([&]() {
-        while (running.load()) {
-            std::string data;
-            if (buffer.pop(data)) {
-                count.fetch_add(1);
+    for (size_t batchSize : {size_t(1), size_t(16), size_t(256)}) {
+        Buffer buffer(1024);
+        std::atomic<long long> count{0};
+        std::atomic<bool> running{true};
+        
+        std::thread consumer([&]() {
+            std::vector<std::string> batch;
+            batch.reserve(batchSize);
+            while (running.load()) {
+                batch.clear();
+                size_t n = buffer.try_pop_bulk(std::back_inserter(batch), batchSize);
+                count.fetch_add(static_cast<long long>(n), std::memory_order_relaxed);
             }
+        });
+        
+        std::vector<std::string> payloads(batchSize, "benchmark data payload");
+        auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < testDuration) {
+            buffer.try_push_bulk(payloads.begin(), payloads.end());
         }
-    });
-    
-    auto start = std::chrono::steady_clock::now();
-    while (std::chrono::steady_clock::now() - start < testDuration) {
-        buffer.push("benchmark data payload");
+        
+        running = false;
+        consumer.join();
+        
+        EXPECT_GT(count.load(), 10000);
+        
+        std::cout << "[BENCHMARK] " << label << " batch " << batchSize << ": " << count.load() 
+                  << " items/s" << std::endl;
     }
-    
-    running = false;
-    consumer.join();
-    
-    EXPECT_GT(count.load(), 10000);
-    
-    std::cout << "[BENCHMARK] Processed " << count.load() << " items in 1 second" << std::endl;
 }
 
-TEST(IntegrationTest, LatencyTest) {
-    RingBuffer<std::chrono::steady_clock::time_point> buffer(1024);
+template<typename Buffer>
+void runLatencyTest(const char* label) {
+    Buffer buffer(1024);
     std::vector<long long> latencies;
     std::mutex latencyMutex;
     std::atomic<bool> running{true};
@@ -342,11 +347,29 @@ TEST(IntegrationTest, LatencyTest) {
         for (auto l : latencies) sum += l;
         long long avgNs = sum / latencies.size();
         
-        std::cout << "[BENCHMARK] Average latency: " << avgNs << " ns" << std::endl;
+        std::cout << "[BENCHMARK] " << label << " average latency: " << avgNs << " ns" << std::endl;
         
         EXPECT_LT(avgNs, 1000000);
     }
 }
 
+}
+
+TEST(IntegrationTest, ThroughputBenchmark) {
+    runThroughputBenchmark<RingBuffer<std::string>>("MPMC");
+}
+
+TEST(IntegrationTest, SpscThroughputBenchmark) {
+    runThroughputBenchmark<SpscRingBuffer<std::string>>("SPSC");
+}
+
+TEST(IntegrationTest, LatencyTest) {
+    runLatencyTest<RingBuffer<std::chrono::steady_clock::time_point>>("MPMC");
+}
+
+TEST(IntegrationTest, SpscLatencyTest) {
+    runLatencyTest<SpscRingBuffer<std::chrono::steady_clock::time_point>>("SPSC");
+}
+
 } 
 } 
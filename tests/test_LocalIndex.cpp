@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "search/LocalIndex.hpp"
+#include "search/SearchService.hpp"
+
+namespace civic {
+namespace test {
+
+namespace {
+    const char* catalogue = R"([
+        {"id": "a", "title": "Pharmacies d'Île-de-France", "description": "Liste des officines",
+         "tags": ["sante", "pharmacie"],
+         "organization": {"name": "ARS", "badges": [{"kind": "certified"}]},
+         "resources": [{"url": "https://example.org/a.csv", "title": "Export", "mime": "text/csv"}]},
+        {"id": "b", "title": "Horaires des bus", "description": "Réseau de transport urbain",
+         "tags": ["transport", "bus"], "enriched_keywords": ["mobilité"],
+         "organization": {"name": "Ville", "badges": []},
+         "resources": [{"url": "https://example.org/b.json", "mime": "application/json"},
+                       {"url": "https://example.org/b.pdf", "mime": "application/pdf"}]},
+        {"id": "c", "title": "Qualité de l'eau potable", "description": "Analyses sanitaires",
+         "tags": ["sante", "environnement"],
+         "organization": {"name": "Ministère", "badges": [{"kind": "public-service"}]},
+         "resources": []}
+    ])";
+
+    LocalIndex indexTest() {
+        LocalIndex index;
+        EXPECT_TRUE(index.construire(catalogue));
+        return index;
+    }
+}
+
+TEST(LocalIndexTest, BuildsFromCatalog) {
+    auto index = indexTest();
+    EXPECT_EQ(index.taille(), 3u);
+    EXPECT_GT(index.vocabulaire(), 10u);
+}
+
+TEST(LocalIndexTest, RejectsInvalidJson) {
+    LocalIndex index;
+    EXPECT_FALSE(index.construire("{not json"));
+    EXPECT_EQ(index.taille(), 0u);
+}
+
+TEST(LocalIndexTest, MatchesNormalizedWordPrefixes) {
+    auto index = indexTest();
+    EXPECT_EQ(index.rechercher("PHARMA", false, {}), std::vector<LocalIndex::IdJeu>{0});
+    EXPECT_EQ(index.rechercher("qualite eau", false, {}), std::vector<LocalIndex::IdJeu>{2});
+    EXPECT_EQ(index.rechercher("mobilite", false, {}), std::vector<LocalIndex::IdJeu>{1});
+    EXPECT_EQ(index.rechercher("ile", false, {}), std::vector<LocalIndex::IdJeu>{0});
+}
+
+TEST(LocalIndexTest, RequiresEveryQueryWord) {
+    auto index = indexTest();
+    EXPECT_TRUE(index.rechercher("bus pharmacie", false, {}).empty());
+    EXPECT_TRUE(index.rechercher("inconnu", false, {}).empty());
+}
+
+TEST(LocalIndexTest, EmptyQueryReturnsWholeCatalogInOrder) {
+    auto index = indexTest();
+    EXPECT_EQ(index.rechercher("", false, {}), (std::vector<LocalIndex::IdJeu>{0, 1, 2}));
+}
+
+TEST(LocalIndexTest, FiltersByThemeTagsAndCertification) {
+    auto index = indexTest();
+    EXPECT_EQ(index.rechercher("", false, {"sante", "pharmacie"}), (std::vector<LocalIndex::IdJeu>{0, 2}));
+    EXPECT_EQ(index.rechercher("", true, {}), (std::vector<LocalIndex::IdJeu>{0, 2}));
+    EXPECT_EQ(index.rechercher("analyses", true, {"sante"}), std::vector<LocalIndex::IdJeu>{2});
+    EXPECT_TRUE(index.rechercher("", false, {"culture"}).empty());
+}
+
+TEST(LocalIndexTest, MaterializesDatasetWithResources) {
+    auto index = indexTest();
+    auto jeu = index.jeu(1);
+    EXPECT_EQ(jeu.id, "b");
+    EXPECT_EQ(jeu.titre, "Horaires des bus");
+    EXPECT_EQ(jeu.organisation, "Ville");
+    EXPECT_FALSE(jeu.organisationCertifiee);
+    ASSERT_EQ(jeu.ressources.size(), 2u);
+    EXPECT_EQ(jeu.ressources[0].url, "https://example.org/b.json");
+    EXPECT_EQ(jeu.ressources[0].format, FormatFichier::JSON);
+
+    EXPECT_TRUE(index.jeu(0).organisationCertifiee);
+    EXPECT_TRUE(index.jeu(2).ressources.empty());
+}
+
+namespace {
+    const char* catalogueClasse = R"([
+        {"id": "desc", "title": "Horaires", "description": "Arrêts de bus et de tramway",
+         "created_at": "2021-01-01T00:00:00", "last_modified": "2024-06-01T00:00:00",
+         "metrics": {"views": 900}},
+        {"id": "titre", "title": "Réseau de bus", "description": "Lignes urbaines",
+         "created_at": "2023-01-01T00:00:00", "last_modified": "2022-01-01T00:00:00",
+         "metrics": {"views": 10}},
+        {"id": "tag", "title": "Transports", "description": "Données de mobilité", "tags": ["bus"],
+         "created_at": "2022-01-01T00:00:00", "last_modified": "2023-01-01T00:00:00",
+         "metrics": {"views": 50}},
+        {"id": "autre", "title": "Pistes cyclables", "description": "Aménagements"}
+    ])";
+
+    std::vector<std::string> ids(const LocalIndex& index, const LocalIndex::PageLocale& page) {
+        std::vector<std::string> resultat;
+        for (const auto& c : page.jeux) resultat.push_back(index.jeu(c.jeu).id);
+        return resultat;
+    }
+}
+
+TEST(LocalIndexTest, RanksTitleMatchesAboveTagsAndDescription) {
+    LocalIndex index;
+    ASSERT_TRUE(index.construire(catalogueClasse));
+
+    auto page = index.classer("bus", false, {}, "relevance", 0, 10);
+    EXPECT_EQ(page.total, 3u);
+    EXPECT_EQ(ids(index, page), (std::vector<std::string>{"titre", "tag", "desc"}));
+    EXPECT_GT(page.jeux[0].score, page.jeux[1].score);
+    EXPECT_GT(page.jeux[2].score, 0.0);
+}
+
+TEST(LocalIndexTest, SortsByRequestedCriterion) {
+    LocalIndex index;
+    ASSERT_TRUE(index.construire(catalogueClasse));
+
+    EXPECT_EQ(ids(index, index.classer("bus", false, {}, "downloads", 0, 10)),
+              (std::vector<std::string>{"desc", "tag", "titre"}));
+    EXPECT_EQ(ids(index, index.classer("bus", false, {}, "created", 0, 10)),
+              (std::vector<std::string>{"titre", "tag", "desc"}));
+    EXPECT_EQ(ids(index, index.classer("bus", false, {}, "last_modified", 0, 10)),
+              (std::vector<std::string>{"desc", "tag", "titre"}));
+}
+
+TEST(LocalIndexTest, ReturnsOnlyRequestedPage) {
+    LocalIndex index;
+    ASSERT_TRUE(index.construire(catalogueClasse));
+
+    auto page = index.classer("bus", false, {}, "relevance", 1, 1);
+    EXPECT_EQ(page.total, 3u);
+    EXPECT_EQ(ids(index, page), std::vector<std::string>{"tag"});
+
+    EXPECT_TRUE(index.classer("bus", false, {}, "relevance", 3, 5).jeux.empty());
+    EXPECT_EQ(index.classer("", false, {}, "relevance", 0, 2).total, 4u);
+    EXPECT_EQ(ids(index, index.classer("", false, {}, "relevance", 0, 2)),
+              (std::vector<std::string>{"desc", "titre"}));
+}
+
+TEST(LocalIndexTest, MaterializedDatasetCarriesScore) {
+    LocalIndex index;
+    ASSERT_TRUE(index.construire(catalogueClasse));
+
+    auto page = index.classer("bus", false, {}, "relevance", 0, 1);
+    ASSERT_EQ(page.jeux.size(), 1u);
+    auto jeu = index.jeu(page.jeux[0].jeu, page.jeux[0].score);
+    EXPECT_DOUBLE_EQ(jeu.score, page.jeux[0].score);
+    EXPECT_EQ(jeu.nombreTelechargements, 10);
+}
+
+TEST(LocalIndexTest, ExpandsQueryWordsWithSynonyms) {
+    LocalIndex index;
+    index.setSynonymes({{"velo", {"cyclable", "piste-cyclable"}}, {"bus", {"autobus"}}});
+    ASSERT_TRUE(index.construire(catalogueClasse));
+
+    auto page = index.classer("velo", false, {}, "relevance", 0, 10);
+    EXPECT_EQ(page.total, 1u);
+    EXPECT_EQ(ids(index, page), std::vector<std::string>{"autre"});
+
+    // Chaque mot reste obligatoire : « velo bus » demande les deux
+    EXPECT_TRUE(index.rechercher("velo bus", false, {}).empty());
+
+    LocalIndex sansSynonymes;
+    ASSERT_TRUE(sansSynonymes.construire(catalogueClasse));
+    EXPECT_EQ(sansSynonymes.classer("velo", false, {}, "relevance", 0, 10).total, 0u);
+}
+
+TEST(LocalIndexTest, SynonymMatchesWeighLessThanDirectMatches) {
+    LocalIndex index;
+    index.setSynonymes({{"mobilite", {"bus"}}});
+    ASSERT_TRUE(index.construire(catalogueClasse));
+
+    // « tag » contient « mobilité » ; les autres seulement le synonyme « bus »
+    auto page = index.classer("mobilite", false, {}, "relevance", 0, 10);
+    EXPECT_EQ(page.total, 3u);
+    ASSERT_FALSE(page.jeux.empty());
+    EXPECT_EQ(index.jeu(page.jeux[0].jeu).id, "tag");
+}
+
+TEST(LocalIndexTest, LoadsMappedFile) {
+    auto chemin = std::filesystem::temp_directory_path() / ("catalogue_" + std::to_string(::getpid()) + ".json");
+    { std::ofstream(chemin) << catalogue; }
+
+    LocalIndex index;
+    EXPECT_TRUE(index.charger(chemin.string()));
+    EXPECT_EQ(index.taille(), 3u);
+    EXPECT_EQ(index.jeu(2).titre, "Qualité de l'eau potable");
+    EXPECT_FALSE(LocalIndex().charger(chemin.string() + ".absent"));
+    std::filesystem::remove(chemin);
+}
+
+TEST(LocalIndexTest, SearchServiceReloadsCatalogWhenModified) {
+    auto chemin = std::filesystem::temp_directory_path() / ("catalogue_reload_" + std::to_string(::getpid()) + ".json");
+    { std::ofstream(chemin) << catalogue; }
+
+    SearchService service;
+    service.setCheminCatalogue(chemin.string());
+    auto criteres = CriteresBuilder().requete("tramway").build();
+    EXPECT_EQ(service.rechercherLocal(criteres).totalResultats, 0);
+
+    { std::ofstream(chemin) << R"([{"id": "t", "title": "Lignes de tramway", "resources": []}])"; }
+    std::filesystem::last_write_time(chemin, std::filesystem::last_write_time(chemin) + std::chrono::seconds(5));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+
+    auto resultat = service.rechercherLocal(criteres);
+    EXPECT_EQ(resultat.totalResultats, 1);
+    ASSERT_EQ(resultat.jeux.size(), 1u);
+    EXPECT_EQ(resultat.jeux[0].id, "t");
+    std::filesystem::remove(chemin);
+}
+
+} // namespace test
+} // namespace civic
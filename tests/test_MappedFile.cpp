@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include "core/MappedFile.hpp"
+
+namespace civic {
+namespace test {
+
+class MappedFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() /
+                 ("mapped_file_test_" + std::to_string(::getpid()) + ".bin")).string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    void write(const std::string& content) {
+        std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+        out << content;
+    }
+
+    std::string path_;
+};
+
+TEST_F(MappedFileTest, MapsContentFollowedByZeroPadding) {
+    write("{\"a\": 1}");
+    auto file = MappedFile::open(path_, 64);
+    ASSERT_TRUE(file.has_value());
+    EXPECT_EQ(file->view(), "{\"a\": 1}");
+    EXPECT_EQ(file->padding(), 64u);
+    for (size_t i = 0; i < 64; ++i) {
+        EXPECT_EQ(file->data()[file->size() + i], '\0');
+    }
+}
+
+TEST_F(MappedFileTest, PaddingIsReadableWhenFileEndsOnPageBoundary) {
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    write(std::string(page, 'x'));
+    auto file = MappedFile::open(path_, 64);
+    ASSERT_TRUE(file.has_value());
+    EXPECT_EQ(file->size(), page);
+    EXPECT_EQ(file->data()[page - 1], 'x');
+    EXPECT_EQ(file->data()[page + 63], '\0');
+}
+
+TEST_F(MappedFileTest, EmptyFileHasOnlyPadding) {
+    write("");
+    auto file = MappedFile::open(path_, 16);
+    ASSERT_TRUE(file.has_value());
+    EXPECT_EQ(file->size(), 0u);
+    EXPECT_EQ(file->data()[15], '\0');
+}
+
+TEST_F(MappedFileTest, MissingFileOrDirectoryFails) {
+    EXPECT_FALSE(MappedFile::open(path_ + ".missing").has_value());
+    EXPECT_FALSE(MappedFile::open(std::filesystem::temp_directory_path().string()).has_value());
+}
+
+TEST_F(MappedFileTest, MoveTransfersOwnership) {
+    write("abc");
+    auto file = MappedFile::open(path_);
+    ASSERT_TRUE(file.has_value());
+    MappedFile moved = std::move(*file);
+    EXPECT_EQ(moved.view(), "abc");
+    EXPECT_EQ(file->data(), nullptr);
+}
+
+} // namespace test
+} // namespace civic
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <string>
+#include "core/Payload.hpp"
+#include "core/RingBuffer.hpp"
+
+namespace civic {
+namespace test {
+
+
+TEST(PayloadTest, DefaultIsEmpty) {
+    Payload payload;
+    EXPECT_TRUE(payload.empty());
+    EXPECT_EQ(payload.size(), 0u);
+    EXPECT_EQ(payload.useCount(), 0u);
+    EXPECT_EQ(payload.view(), "");
+}
+
+TEST(PayloadTest, CopyOfKeepsBytes) {
+    PayloadPool pool;
+    auto payload = pool.copyOf(R"({"key": "value"})");
+
+    EXPECT_EQ(payload.view(), R"({"key": "value"})");
+    EXPECT_GE(payload.capacity(), payload.size());
+}
+
+TEST(PayloadTest, PaddingIsReadable) {
+    PayloadPool pool;
+    std::string json(300, 'x');
+    auto payload = pool.acquire(json.size());
+    payload.append(json.data(), json.size());
+
+    const char* end = payload.data() + payload.capacity();
+    for (size_t i = 0; i < kPayloadPadding; ++i) {
+        EXPECT_EQ(end[i], '\0');
+    }
+}
+
+TEST(PayloadTest, CopySharesBytes) {
+    PayloadPool pool;
+    auto first = pool.copyOf("shared");
+    Payload second = first;
+
+    EXPECT_EQ(first.data(), second.data());
+    EXPECT_EQ(first.useCount(), 2u);
+
+    second = Payload();
+    EXPECT_EQ(first.useCount(), 1u);
+}
+
+TEST(PayloadTest, MoveTransfersOwnership) {
+    PayloadPool pool;
+    auto first = pool.copyOf("moved");
+    const char* bytes = first.data();
+
+    Payload second = std::move(first);
+    EXPECT_EQ(second.data(), bytes);
+    EXPECT_EQ(second.useCount(), 1u);
+    EXPECT_TRUE(first.empty());
+}
+
+TEST(PayloadTest, AppendGrowsAndKeepsContent) {
+    PayloadPool pool;
+    auto payload = pool.acquire(16);
+
+    std::string expected;
+    for (int i = 0; i < 1000; ++i) {
+        std::string chunk = "chunk" + std::to_string(i) + ";";
+        payload.append(chunk.data(), chunk.size());
+        expected += chunk;
+    }
+
+    EXPECT_EQ(payload.view(), expected);
+}
+
+TEST(PayloadTest, ReleasedBlocksAreReused) {
+    PayloadPool pool;
+
+    for (int i = 0; i < 100; ++i) {
+        auto payload = pool.copyOf("recycled payload");
+    }
+
+    EXPECT_EQ(pool.allocations(), 1u);
+    EXPECT_EQ(pool.reuses(), 99u);
+}
+
+TEST(PayloadTest, PayloadOutlivesPool) {
+    Payload payload;
+    {
+        PayloadPool pool;
+        payload = pool.copyOf("survivor");
+    }
+
+    EXPECT_EQ(payload.view(), "survivor");
+}
+
+TEST(PayloadTest, UnpooledReserve) {
+    Payload payload;
+    payload.append("abc", 3);
+
+    EXPECT_EQ(payload.view(), "abc");
+}
+
+TEST(PayloadTest, CrossThreadRelease) {
+    PayloadPool pool;
+    RingBuffer<Payload> buffer(64);
+    const int numItems = 10000;
+
+    std::thread consumer([&]() {
+        int received = 0;
+        Payload payload;
+        while (received < numItems) {
+            if (buffer.pop(payload)) {
+                EXPECT_EQ(payload.view(), "cross-thread");
+                payload = Payload();
+                ++received;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (int i = 0; i < numItems; ++i) {
+        auto payload = pool.copyOf("cross-thread");
+        while (!buffer.push(payload)) {
+            std::this_thread::yield();
+        }
+    }
+
+    consumer.join();
+
+    // Popped handles leave the ring, so slabs go back to the pool
+    EXPECT_LT(pool.allocations(), static_cast<size_t>(numItems));
+    EXPECT_EQ(pool.allocations() + pool.reuses(), static_cast<size_t>(numItems));
+}
+
+}
+}
@@ -3,6 +3,10 @@
 #include <vector>
 #include <atomic>
 #include <set>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <chrono>
 #include "core/RingBuffer.hpp"
 
 namespace civic {
@@ -279,5 +283,445 @@ TEST(RingBufferTest, StressTest) {
     EXPECT_EQ(totalPushed.load(), totalPopped.load());
 }
 
+TEST(RingBufferTest, MoveOnlyType) {
+    RingBuffer<std::unique_ptr<int>> buffer(4);
+    
+    EXPECT_TRUE(buffer.push(std::make_unique<int>(7)));
+    
+    std::unique_ptr<int> value;
+    EXPECT_TRUE(buffer.pop(value));
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, 7);
+}
+
+TEST(RingBufferTest, PushMovesFromSource) {
+    RingBuffer<std::string> buffer(4);
+    
+    std::string payload(1000, 'x');
+    EXPECT_TRUE(buffer.push(std::move(payload)));
+    EXPECT_TRUE(payload.empty());
+    
+    std::string value;
+    EXPECT_TRUE(buffer.pop(value));
+    EXPECT_EQ(value.size(), 1000u);
+}
+
+TEST(RingBufferTest, Emplace) {
+    RingBuffer<std::string> buffer(4);
+    
+    EXPECT_TRUE(buffer.emplace(3, 'a'));
+    EXPECT_TRUE(buffer.emplace("literal"));
+    
+    std::string value;
+    EXPECT_TRUE(buffer.pop(value));
+    EXPECT_EQ(value, "aaa");
+    EXPECT_TRUE(buffer.pop(value));
+    EXPECT_EQ(value, "literal");
+}
+
+TEST(RingBufferTest, EmplaceOnFullBufferReturnsFalse) {
+    RingBuffer<int> buffer(2);
+    
+    EXPECT_TRUE(buffer.emplace(1));
+    EXPECT_TRUE(buffer.emplace(2));
+    EXPECT_FALSE(buffer.emplace(3));
+}
+
+TEST(RingBufferTest, PushBulkAndPopBulk) {
+    RingBuffer<int> buffer(16);
+    std::vector<int> input = {1, 2, 3, 4, 5, 6, 7, 8};
+    
+    EXPECT_EQ(buffer.try_push_bulk(input.begin(), input.end()), input.size());
+    
+    std::vector<int> output;
+    EXPECT_EQ(buffer.try_pop_bulk(std::back_inserter(output), 5), 5u);
+    EXPECT_EQ(buffer.try_pop_bulk(std::back_inserter(output), 100), 3u);
+    EXPECT_EQ(output, input);
+    
+    EXPECT_EQ(buffer.try_pop_bulk(std::back_inserter(output), 100), 0u);
+}
+
+TEST(RingBufferTest, PushBulkStopsWhenFull) {
+    RingBuffer<int> buffer(8);
+    std::vector<int> input(12);
+    for (int i = 0; i < 12; ++i) input[i] = i;
+    
+    EXPECT_EQ(buffer.try_push_bulk(input.begin(), input.end()), 8u);
+    EXPECT_EQ(buffer.try_push_bulk(input.begin(), input.end()), 0u);
+    
+    std::vector<int> output;
+    EXPECT_EQ(buffer.try_pop_bulk(std::back_inserter(output), 3), 3u);
+    EXPECT_EQ(buffer.try_push_bulk(input.begin() + 8, input.end()), 3u);
+    
+    EXPECT_EQ(buffer.try_pop_bulk(std::back_inserter(output), 100), 8u);
+    std::vector<int> expected = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    EXPECT_EQ(output, expected);
+}
+
+TEST(RingBufferTest, BulkWrapAround) {
+    RingBuffer<int> buffer(8);
+    std::vector<int> output;
+    
+    int next = 0;
+    for (int cycle = 0; cycle < 10; ++cycle) {
+        std::vector<int> input = {next, next + 1, next + 2, next + 3, next + 4};
+        next += 5;
+        EXPECT_EQ(buffer.try_push_bulk(input.begin(), input.end()), 5u);
+        EXPECT_EQ(buffer.try_pop_bulk(std::back_inserter(output), 5), 5u);
+    }
+    
+    for (int i = 0; i < next; ++i) {
+        EXPECT_EQ(output[i], i);
+    }
+}
+
+TEST(RingBufferTest, PushBulkMovesElements) {
+    RingBuffer<std::unique_ptr<int>> buffer(4);
+    std::vector<std::unique_ptr<int>> input;
+    input.push_back(std::make_unique<int>(1));
+    input.push_back(std::make_unique<int>(2));
+    
+    EXPECT_EQ(buffer.try_push_bulk(std::make_move_iterator(input.begin()),
+                                   std::make_move_iterator(input.end())), 2u);
+    EXPECT_EQ(input[0], nullptr);
+    
+    std::vector<std::unique_ptr<int>> output;
+    EXPECT_EQ(buffer.try_pop_bulk(std::back_inserter(output), 4), 2u);
+    EXPECT_EQ(*output[1], 2);
+}
+
+TEST(RingBufferTest, BulkMultipleProducersMultipleConsumers) {
+    RingBuffer<int> buffer(256);
+    const int numProducers = 4;
+    const int numConsumers = 4;
+    const int itemsPerProducer = 20000;
+    const int totalItems = numProducers * itemsPerProducer;
+    
+    std::atomic<int> consumedCount{0};
+    std::vector<std::vector<int>> consumed(numConsumers);
+    
+    std::vector<std::thread> producers;
+    for (int p = 0; p < numProducers; ++p) {
+        producers.emplace_back([&, p]() {
+            std::vector<int> batch;
+            for (int i = 0; i < itemsPerProducer; i += 32) {
+                batch.clear();
+                for (int j = i; j < std::min(i + 32, itemsPerProducer); ++j) {
+                    batch.push_back(p * itemsPerProducer + j);
+                }
+                auto first = batch.begin();
+                while (first != batch.end()) {
+                    first += buffer.try_push_bulk(first, batch.end());
+                    if (first != batch.end()) std::this_thread::yield();
+                }
+            }
+        });
+    }
+    
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < numConsumers; ++c) {
+        consumers.emplace_back([&, c]() {
+            while (consumedCount.load() < totalItems) {
+                size_t n = buffer.try_pop_bulk(std::back_inserter(consumed[c]), 64);
+                if (n == 0) {
+                    std::this_thread::yield();
+                } else {
+                    consumedCount.fetch_add(static_cast<int>(n));
+                }
+            }
+        });
+    }
+    
+    for (auto& t : producers) t.join();
+    for (auto& t : consumers) t.join();
+    
+    std::set<int> all;
+    for (const auto& v : consumed) all.insert(v.begin(), v.end());
+    EXPECT_EQ(all.size(), static_cast<size_t>(totalItems));
+    EXPECT_EQ(consumedCount.load(), totalItems);
+}
+
+TEST(RingBufferTest, SpscFullAndWrapAround) {
+    SpscRingBuffer<int> buffer(4);
+    
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_TRUE(buffer.push(round * 10 + i));
+        }
+        EXPECT_FALSE(buffer.push(99));
+        
+        for (int i = 0; i < 4; ++i) {
+            int value = -1;
+            EXPECT_TRUE(buffer.pop(value));
+            EXPECT_EQ(value, round * 10 + i);
+        }
+        int value;
+        EXPECT_FALSE(buffer.pop(value));
+    }
+}
+
+TEST(RingBufferTest, SpscBulkAndMoveOnly) {
+    SpscRingBuffer<std::unique_ptr<int>> buffer(4);
+    std::vector<std::unique_ptr<int>> input;
+    for (int i = 0; i < 6; ++i) input.push_back(std::make_unique<int>(i));
+    
+    EXPECT_EQ(buffer.try_push_bulk(std::make_move_iterator(input.begin()),
+                                   std::make_move_iterator(input.end())), 4u);
+    EXPECT_NE(input[4], nullptr);
+    
+    std::vector<std::unique_ptr<int>> output;
+    EXPECT_EQ(buffer.try_pop_bulk(std::back_inserter(output), 3), 3u);
+    EXPECT_TRUE(buffer.emplace(std::make_unique<int>(42)));
+    EXPECT_EQ(buffer.try_pop_bulk(std::back_inserter(output), 8), 2u);
+    
+    ASSERT_EQ(output.size(), 5u);
+    EXPECT_EQ(*output[3], 3);
+    EXPECT_EQ(*output[4], 42);
+}
+
+TEST(RingBufferTest, SpscPreservesOrderAcrossThreads) {
+    SpscRingBuffer<int> buffer(64);
+    const int numItems = 200000;
+    
+    std::thread producer([&]() {
+        for (int i = 0; i < numItems; ++i) {
+            while (!buffer.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    
+    int expected = 0;
+    bool ordered = true;
+    std::vector<int> batch;
+    while (expected < numItems) {
+        batch.clear();
+        if (buffer.try_pop_bulk(std::back_inserter(batch), 16) == 0) {
+            std::this_thread::yield();
+        }
+        for (int value : batch) {
+            ordered = ordered && (value == expected);
+            ++expected;
+        }
+    }
+    producer.join();
+    
+    EXPECT_TRUE(ordered);
+}
+
+TEST(RingBufferTest, SingleProducerPolicyMultipleConsumers) {
+    SpmcRingBuffer<int> buffer(128);
+    const int numConsumers = 4;
+    const int totalItems = 40000;
+    
+    std::atomic<int> consumedCount{0};
+    std::vector<std::vector<int>> consumed(numConsumers);
+    
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < numConsumers; ++c) {
+        consumers.emplace_back([&, c]() {
+            while (consumedCount.load() < totalItems) {
+                int value;
+                if (buffer.pop(value)) {
+                    consumed[c].push_back(value);
+                    consumedCount++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    
+    for (int i = 0; i < totalItems; ++i) {
+        while (!buffer.push(i)) {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& t : consumers) t.join();
+    
+    std::set<int> all;
+    for (const auto& v : consumed) all.insert(v.begin(), v.end());
+    EXPECT_EQ(all.size(), static_cast<size_t>(totalItems));
+}
+
+TEST(RingBufferTest, MultipleProducersSingleConsumerPolicy) {
+    MpscRingBuffer<int> buffer(128);
+    const int numProducers = 4;
+    const int itemsPerProducer = 10000;
+    const int totalItems = numProducers * itemsPerProducer;
+    
+    std::vector<std::thread> producers;
+    for (int p = 0; p < numProducers; ++p) {
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < itemsPerProducer; ++i) {
+                while (!buffer.push(p * itemsPerProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    
+    std::vector<int> lastSeen(numProducers, -1);
+    bool ordered = true;
+    int received = 0;
+    while (received < totalItems) {
+        int value;
+        if (buffer.pop(value)) {
+            int p = value / itemsPerProducer;
+            ordered = ordered && (value > lastSeen[p]);
+            lastSeen[p] = value;
+            ++received;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& t : producers) t.join();
+    
+    // Per-producer FIFO order holds
+    EXPECT_TRUE(ordered);
+}
+
+TEST(RingBufferTest, PopWaitBlocksUntilPush) {
+    SpscRingBuffer<int, ParkingWait> buffer(8);
+    int value = 0;
+    
+    std::thread consumer([&]() {
+        EXPECT_TRUE(buffer.pop_wait(value));
+    });
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_TRUE(buffer.push(7));
+    consumer.join();
+    
+    EXPECT_EQ(value, 7);
+}
+
+TEST(RingBufferTest, PushWaitBlocksWhenFull) {
+    RingBuffer<int, ProducerPolicy::Multi, ConsumerPolicy::Multi, ParkingWait> buffer(2);
+    EXPECT_TRUE(buffer.push(1));
+    EXPECT_TRUE(buffer.push(2));
+    
+    std::atomic<bool> pushed{false};
+    std::thread producer([&]() {
+        EXPECT_TRUE(buffer.push_wait(3));
+        pushed = true;
+    });
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(pushed.load());
+    
+    int value;
+    EXPECT_TRUE(buffer.pop(value));
+    producer.join();
+    EXPECT_TRUE(pushed.load());
+}
+
+TEST(RingBufferTest, CloseWakesParkedConsumersAndDrains) {
+    SpmcRingBuffer<int, ParkingWait> buffer(16);
+    const int numConsumers = 3;
+    std::atomic<int> received{0};
+    
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < numConsumers; ++c) {
+        consumers.emplace_back([&]() {
+            int value;
+            while (buffer.pop_wait(value)) {
+                received++;
+            }
+        });
+    }
+    
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(buffer.push_wait(i));
+    }
+    buffer.close();
+    for (auto& t : consumers) t.join();
+    
+    EXPECT_EQ(received.load(), 10);
+    EXPECT_FALSE(buffer.push_wait(11));
+}
+
+TEST(RingBufferTest, PopBulkWaitTimesOut) {
+    MpscRingBuffer<int, ParkingWait> buffer(8);
+    std::vector<int> out;
+    
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(buffer.pop_bulk_wait(std::back_inserter(out), 4, std::chrono::milliseconds(30)), 0u);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(30));
+    
+    buffer.push(1);
+    buffer.push(2);
+    EXPECT_EQ(buffer.pop_bulk_wait(std::back_inserter(out), 4, std::chrono::milliseconds(30)), 2u);
+}
+
+TEST(RingBufferTest, BlockingStrategiesTransferEverything) {
+    auto run = [](auto& buffer) {
+        const int numItems = 50000;
+        long long sum = 0;
+        std::thread consumer([&]() {
+            int value;
+            while (buffer.pop_wait(value)) sum += value;
+        });
+        for (int i = 0; i < numItems; ++i) {
+            buffer.push_wait(i);
+        }
+        buffer.close();
+        consumer.join();
+        return sum;
+    };
+    
+    const long long expected = 50000LL * 49999 / 2;
+    SpscRingBuffer<int, BusySpinWait> spinning(1024);
+    SpscRingBuffer<int, YieldingWait> yielding(1024);
+    RingBuffer<int, ProducerPolicy::Multi, ConsumerPolicy::Multi, ParkingWait> parking(1024);
+    
+    EXPECT_EQ(run(spinning), expected);
+    EXPECT_EQ(run(yielding), expected);
+    EXPECT_EQ(run(parking), expected);
+}
+
+TEST(RingBufferTest, ParkingWaitSmallRingDoesNotDeadlock) {
+    // Producer and consumers both park on a 2-slot ring: each side's ready
+    // check notifies the other side's wait object
+    SpmcRingBuffer<int, ParkingWait> buffer(2);
+    const int numItems = 100000;
+    const int numConsumers = 3;
+    std::atomic<long long> sum{0};
+    std::atomic<int> received{0};
+    
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < numConsumers; ++c) {
+        consumers.emplace_back([&, c]() {
+            if (c == 0) {
+                std::vector<int> out;
+                while (true) {
+                    out.clear();
+                    bool wasClosed = buffer.closed();
+                    size_t n = buffer.pop_bulk_wait(std::back_inserter(out), 2, std::chrono::milliseconds(5));
+                    for (int v : out) sum += v;
+                    received += static_cast<int>(n);
+                    // Once closed, an empty result means drained rather than timed out
+                    if (n == 0 && wasClosed) break;
+                }
+            } else {
+                int value;
+                while (buffer.pop_wait(value)) {
+                    sum += value;
+                    received++;
+                }
+            }
+        });
+    }
+    
+    for (int i = 0; i < numItems; ++i) {
+        EXPECT_TRUE(buffer.push_wait(i));
+    }
+    buffer.close();
+    for (auto& t : consumers) t.join();
+    
+    EXPECT_EQ(received.load(), numItems);
+    EXPECT_EQ(sum.load(), static_cast<long long>(numItems) * (numItems - 1) / 2);
+}
+
 }
 }
@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 #include <chrono>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <boost/asio.hpp>
 #include "search/SearchService.hpp"
 
 namespace civic {
@@ -58,6 +62,18 @@ TEST(SearchServiceTest, MimeTypeVersFormatReturnsNulloptForUnknown) {
     EXPECT_FALSE(format.has_value());
 }
 
+TEST(SearchServiceTest, TypeMediaDropsParameters) {
+    EXPECT_EQ(SearchService::typeMedia("text/csv"), "text/csv");
+    EXPECT_EQ(SearchService::typeMedia(" Text/CSV ; charset=UTF-8"), "text/csv");
+    EXPECT_EQ(SearchService::typeMedia("multipart/form-data; boundary=----x42"), "multipart/form-data");
+    EXPECT_EQ(SearchService::typeMedia("application/vnd.geo+json"), "application/vnd.geo+json");
+    EXPECT_FALSE(SearchService::typeMedia("").has_value());
+    EXPECT_FALSE(SearchService::typeMedia("csv").has_value());
+    EXPECT_FALSE(SearchService::typeMedia("text/").has_value());
+    EXPECT_FALSE(SearchService::typeMedia("text/c sv").has_value());
+    EXPECT_FALSE(SearchService::typeMedia("text/" + std::string(200, 'x')).has_value());
+}
+
 TEST(SearchServiceTest, MimeTypeVersFormatIsCaseInsensitive) {
     auto format = SearchService::mimeTypeVersFormat("TEXT/CSV");
     ASSERT_TRUE(format.has_value());
@@ -239,6 +255,305 @@ TEST(SearchServiceTest, ConstructorCreatesValidInstance) {
     });
 }
 
+TEST(SearchServiceTest, VerifierRessourcesKeepsOrderAndMeetsDeadline) {
+    // Accepte les connexions sans jamais répondre au handshake
+    boost::asio::io_context ioc;
+    boost::asio::ip::tcp::acceptor silent(ioc, {boost::asio::ip::make_address("127.0.0.1"), 0});
+    std::string lent = "https://127.0.0.1:" + std::to_string(silent.local_endpoint().port());
+    
+    SearchService service;
+    OptionsVerification options;
+    options.maxParHote = 2;
+    options.delaiGlobal = std::chrono::milliseconds(300);
+    service.setOptionsVerification(options);
+    
+    std::vector<std::string> urls = {lent + "/a", "pas une url", lent + "/b", lent + "/c", lent + "/d"};
+    auto start = std::chrono::steady_clock::now();
+    auto verifs = service.verifierRessources(urls);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    
+    ASSERT_EQ(verifs.size(), urls.size());
+    for (size_t i = 0; i < urls.size(); ++i) {
+        EXPECT_EQ(verifs[i].resourceId, urls[i]);
+        EXPECT_FALSE(verifs[i].disponible);
+        EXPECT_EQ(verifs[i].httpStatus, 0);
+    }
+    // Une seule échéance pour le lot, pas une par requête
+    EXPECT_LT(elapsed, std::chrono::seconds(2));
+}
+
+TEST(SearchServiceTest, VerifierRessourcesHandlesEmptyList) {
+    SearchService service;
+    EXPECT_TRUE(service.verifierRessources({}).empty());
+}
+
+TEST(SearchServiceTest, VerifierRessourceAsyncDoesNotBlockAndCancels) {
+    boost::asio::io_context ioc;
+    boost::asio::ip::tcp::acceptor silent(ioc, {boost::asio::ip::make_address("127.0.0.1"), 0});
+    std::string url = "https://127.0.0.1:" + std::to_string(silent.local_endpoint().port()) + "/";
+    
+    SearchService service;
+    std::atomic<int> rappels{0};
+    std::vector<SearchService::IdOperation> ids;
+    
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 200; ++i) {
+        ids.push_back(service.verifierRessourceAsync(url, [&](VerificationRessource verif) {
+            EXPECT_FALSE(verif.disponible);
+            ++rappels;
+        }, std::chrono::seconds(30)));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    
+    for (auto id : ids) service.annuler(id);
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (rappels.load() < 200 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(rappels.load(), 200);
+    EXPECT_EQ(service.operationsEnCours(), 0u);
+}
+
+TEST(SearchServiceTest, VerifierRessourceAsyncHonorsTimeout) {
+    boost::asio::io_context ioc;
+    boost::asio::ip::tcp::acceptor silent(ioc, {boost::asio::ip::make_address("127.0.0.1"), 0});
+    std::string url = "https://127.0.0.1:" + std::to_string(silent.local_endpoint().port()) + "/";
+    
+    SearchService service;
+    std::promise<VerificationRessource> promesse;
+    auto start = std::chrono::steady_clock::now();
+    service.verifierRessourceAsync(url, [&](VerificationRessource verif) {
+        promesse.set_value(std::move(verif));
+    }, std::chrono::milliseconds(200));
+    
+    auto future = promesse.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_FALSE(future.get().disponible);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(150));
+}
+
+TEST(SearchServiceTest, RechercherAsyncCancelledStillCallsBack) {
+    SearchService service;
+    std::promise<ResultatRecherche> promesse;
+    auto id = service.rechercherAsync(CriteresBuilder().requete("test").build(), [&](ResultatRecherche r) {
+        promesse.set_value(std::move(r));
+    });
+    service.annuler(id);
+    
+    auto future = promesse.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    auto resultat = future.get();
+    EXPECT_TRUE(resultat.jeux.empty());
+    EXPECT_FALSE(resultat.requeteAPI.empty());
+}
+
+TEST(SearchServiceTest, RunsOnInjectedIoContext) {
+    boost::asio::io_context ioc;
+    auto work = boost::asio::make_work_guard(ioc);
+    std::thread ioThread([&ioc]() { ioc.run(); });
+    
+    {
+        SearchService service(ioc);
+        std::promise<std::thread::id> promesse;
+        service.verifierRessourceAsync("https://127.0.0.1:1/", [&](VerificationRessource) {
+            promesse.set_value(std::this_thread::get_id());
+        }, std::chrono::seconds(2));
+        
+        auto future = promesse.get_future();
+        ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        EXPECT_EQ(future.get(), ioThread.get_id());
+    }
+    
+    work.reset();
+    ioThread.join();
+}
+
+// ============================================================================
+// TESTS DU PARSING DES RÉPONSES
+// ============================================================================
+
+namespace {
+    const char* reponseApi = R"({
+        "data": [
+            {"id": "d1", "slug": "pharmacies", "title": "Pharmacies d'Île-de-France",
+             "description": "Liste \"officielle\"", "license": "lov2",
+             "created_at": "2021-03-04T10:00:00", "last_modified": "2024-01-02T08:30:00",
+             "organization": {"id": "o1", "name": "ARS", "badges": [{"kind": "other"}, {"kind": "certified"}]},
+             "tags": ["sante", null, "pharmacie"],
+             "spatial": {"granularity": "fr:region", "zones": ["fr:region:11"]},
+             "metrics": {"views": 1200, "reuses": 3, "followers": 7},
+             "extras": {"nested": {"deep": [1, 2, {"x": null}]}},
+             "resources": [
+                 {"id": "r1", "title": "Export", "url": "https://example.org/a.csv", "format": "csv",
+                  "mime": null, "filesize": 2048, "type": "main", "schema": {"name": "etalab/pharmacies"},
+                  "extras": {"check:status": 200, "check:date": "2024-01-01"}},
+                 {"id": "r2", "title": "Doc", "url": "https://example.org/a.pdf", "mime": "application/pdf", "type": "documentation"},
+                 {"id": "r3", "title": "API", "url": "https://example.org/a.json", "mime": "application/json",
+                  "extras": {"check:status": 404}}
+             ]},
+            {"id": "d2", "title": "Horaires", "organization": null, "spatial": null, "license": null,
+             "resources": [{"id": "r4", "url": "https://example.org/b.geojson", "format": "geojson", "type": "main"}]},
+            {"id": "d3", "title": "Images", "organization": {"name": "Ville", "badges": []},
+             "resources": [{"id": "r5", "url": "https://example.org/c.png", "mime": "image/png", "type": "main"}]}
+        ],
+        "next_page": null, "page": 1, "page_size": 20, "total": 41
+    })";
+
+    CriteresRecherche criteresParsing() {
+        return CriteresBuilder().verifierDisponibilite(false).parPage(20).build();
+    }
+
+    void expectMemesJeux(const ResultatRecherche& a, const ResultatRecherche& b) {
+        EXPECT_EQ(a.totalResultats, b.totalResultats);
+        EXPECT_EQ(a.totalPages, b.totalPages);
+        ASSERT_EQ(a.jeux.size(), b.jeux.size());
+        for (size_t i = 0; i < a.jeux.size(); ++i) {
+            const auto& x = a.jeux[i];
+            const auto& y = b.jeux[i];
+            EXPECT_EQ(x.id, y.id);
+            EXPECT_EQ(x.slug, y.slug);
+            EXPECT_EQ(x.titre, y.titre);
+            EXPECT_EQ(x.description, y.description);
+            EXPECT_EQ(x.licence, y.licence);
+            EXPECT_EQ(x.organisation, y.organisation);
+            EXPECT_EQ(x.organisationId, y.organisationId);
+            EXPECT_EQ(x.organisationCertifiee, y.organisationCertifiee);
+            EXPECT_EQ(x.tags, y.tags);
+            EXPECT_EQ(x.granulariteTerritoriale, y.granulariteTerritoriale);
+            EXPECT_EQ(x.dateCreation, y.dateCreation);
+            EXPECT_EQ(x.derniereMaj, y.derniereMaj);
+            EXPECT_EQ(x.nombreTelechargements, y.nombreTelechargements);
+            EXPECT_EQ(x.nombreReutilisations, y.nombreReutilisations);
+            ASSERT_EQ(x.ressources.size(), y.ressources.size());
+            for (size_t j = 0; j < x.ressources.size(); ++j) {
+                EXPECT_EQ(x.ressources[j].id, y.ressources[j].id);
+                EXPECT_EQ(x.ressources[j].url, y.ressources[j].url);
+                EXPECT_EQ(x.ressources[j].mimeType, y.ressources[j].mimeType);
+                EXPECT_EQ(x.ressources[j].format, y.ressources[j].format);
+                EXPECT_EQ(x.ressources[j].taille, y.ressources[j].taille);
+                EXPECT_EQ(x.ressources[j].estPrincipale, y.ressources[j].estPrincipale);
+                EXPECT_EQ(x.ressources[j].schema, y.ressources[j].schema);
+                EXPECT_EQ(x.ressources[j].httpStatus, y.ressources[j].httpStatus);
+            }
+        }
+    }
+
+    ResultatRecherche parser(SearchService& service, bool dom, const std::string& json,
+                             const CriteresRecherche& criteres) {
+        service.setParserDom(dom);
+        return service.parserReponse(json, criteres, std::chrono::milliseconds(0));
+    }
+}
+
+TEST(SearchServiceTest, ParserReponseMapsFieldsInOnePass) {
+    SearchService service;
+    auto resultat = service.parserReponse(reponseApi, criteresParsing(), std::chrono::milliseconds(0));
+
+    EXPECT_EQ(resultat.totalResultats, 41);
+    EXPECT_EQ(resultat.totalPages, 3);
+    ASSERT_EQ(resultat.jeux.size(), 2u);
+
+    const auto& jeu = resultat.jeux[0];
+    EXPECT_EQ(jeu.id, "d1");
+    EXPECT_EQ(jeu.titre, "Pharmacies d'Île-de-France");
+    EXPECT_EQ(jeu.description, "Liste \"officielle\"");
+    EXPECT_EQ(jeu.organisation, "ARS");
+    EXPECT_TRUE(jeu.organisationCertifiee);
+    EXPECT_EQ(jeu.tags, (std::vector<std::string>{"sante", "pharmacie"}));
+    EXPECT_EQ(jeu.granulariteTerritoriale, "fr:region");
+    EXPECT_EQ(jeu.nombreTelechargements, 1200);
+    EXPECT_EQ(jeu.nombreReutilisations, 3);
+    // r2 est une documentation PDF ; r3 sans "type" compte comme principale
+    ASSERT_EQ(jeu.ressources.size(), 2u);
+    EXPECT_EQ(jeu.ressources[0].id, "r1");
+    EXPECT_EQ(jeu.ressources[0].format, FormatFichier::CSV);
+    EXPECT_EQ(jeu.ressources[0].mimeType, "csv");
+    EXPECT_EQ(jeu.ressources[0].taille, 2048);
+    EXPECT_EQ(jeu.ressources[0].schema, "etalab/pharmacies");
+    EXPECT_EQ(jeu.ressources[0].httpStatus, 200);
+    EXPECT_EQ(jeu.ressources[1].id, "r3");
+    EXPECT_EQ(jeu.ressources[1].format, FormatFichier::JSON);
+    EXPECT_EQ(jeu.ressources[1].httpStatus, 404);
+
+    EXPECT_EQ(resultat.jeux[1].id, "d2");
+    EXPECT_FALSE(resultat.jeux[1].organisationCertifiee);
+    EXPECT_EQ(resultat.jeux[1].ressources[0].format, FormatFichier::GEOJSON);
+}
+
+TEST(SearchServiceTest, ParserReponseOnDemandMatchesDom) {
+    SearchService service;
+    std::vector<CriteresRecherche> criteres = {
+        criteresParsing(),
+        CriteresBuilder().verifierDisponibilite(false).certifieesUniquement().build(),
+        CriteresBuilder().verifierDisponibilite(false).territoire(Territoire::REGIONAL).build(),
+        CriteresBuilder().verifierDisponibilite(false).ressourcePrincipaleUniquement(false)
+            .formatsStricts({FormatFichier::JSON}).build(),
+    };
+    for (const auto& c : criteres) {
+        expectMemesJeux(parser(service, false, reponseApi, c), parser(service, true, reponseApi, c));
+    }
+}
+
+TEST(SearchServiceTest, ParserReponseRejectsInvalidJson) {
+    SearchService service;
+    for (bool dom : {false, true}) {
+        auto resultat = parser(service, dom, R"({"data": [{"id": "x", "resources": [)", criteresParsing());
+        EXPECT_TRUE(resultat.jeux.empty());
+        EXPECT_EQ(resultat.pageCourante, 1);
+
+        EXPECT_TRUE(parser(service, dom, "[]", criteresParsing()).jeux.empty());
+    }
+}
+
+TEST(SearchServiceTest, BenchmarkParserReponseOnDemandVsDom) {
+    std::string json = R"({"data": [)";
+    for (int i = 0; i < 1000; ++i) {
+        if (i) json += ',';
+        json += R"({"id": "jeu-)" + std::to_string(i) + R"(", "slug": "jeu", "title": "Jeu de données numéro )" +
+                std::to_string(i) + R"(", "description": "Une description assez longue pour ressembler à celles de )"
+                R"(l'API, avec des accents et des \"guillemets\".", "license": "lov2",
+                "organization": {"id": "o", "name": "Organisation", "badges": [{"kind": "certified"}],
+                                 "logo": "https://example.org/logo.png", "page": "https://example.org/org"},
+                "tags": ["a", "b", "c", "d"], "spatial": {"granularity": "fr:commune", "zones": ["fr:commune:75056"]},
+                "metrics": {"views": 42, "reuses": 1, "followers": 3}, "harvest": null,
+                "extras": {"ods:url": "https://example.org", "nested": {"k": [1, 2, 3]}},
+                "resources": [{"id": "r", "title": "Export", "url": "https://example.org/f.csv", "format": "csv",
+                               "mime": "text/csv", "filesize": 1024, "type": "main",
+                               "extras": {"check:status": 200, "check:headers:content-type": "text/csv"}},
+                              {"id": "r2", "title": "Doc", "url": "https://example.org/f.pdf",
+                               "mime": "application/pdf", "type": "documentation"}]})";
+    }
+    json += R"(], "page": 1, "page_size": 1000, "total": 1000})";
+
+    SearchService service;
+    auto criteres = CriteresBuilder().verifierDisponibilite(false).parPage(1000).build();
+    constexpr int iterations = 20;
+
+    auto mesurer = [&](bool dom) {
+        service.setParserDom(dom);
+        size_t jeux = 0;
+        auto debut = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            jeux += service.parserReponse(json, criteres, std::chrono::milliseconds(0)).jeux.size();
+        }
+        EXPECT_EQ(jeux, 1000u * iterations);
+        return std::chrono::steady_clock::now() - debut;
+    };
+    mesurer(false);
+    auto onDemand = mesurer(false);
+    auto dom = mesurer(true);
+
+    auto mbps = [&](std::chrono::steady_clock::duration d) {
+        double secondes = std::chrono::duration<double>(d).count();
+        return secondes > 0 ? json.size() * iterations / secondes / (1024 * 1024) : 0.0;
+    };
+    std::cout << "[BENCHMARK] parserReponse " << json.size() / 1024 << " KiB: on-demand "
+              << mbps(onDemand) << " MiB/s, DOM " << mbps(dom) << " MiB/s" << std::endl;
+
+    EXPECT_LT(onDemand, dom);
+}
+
 // Note: Les tests suivants nécessitent une connexion réseau
 // Ils peuvent être marqués comme DISABLED_ pour les tests CI
 
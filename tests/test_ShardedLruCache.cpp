@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/ShardedLruCache.hpp"
+
+namespace civic {
+namespace test {
+
+TEST(ShardedLruCacheTest, GetReturnsStoredValue) {
+    ShardedLruCache<std::string, int> cache(100);
+    cache.put("a", 1);
+    cache.put("b", 2);
+
+    EXPECT_EQ(cache.get("a"), 1);
+    EXPECT_EQ(cache.get("b"), 2);
+    EXPECT_FALSE(cache.get("c").has_value());
+    EXPECT_EQ(cache.hits(), 2u);
+    EXPECT_EQ(cache.misses(), 1u);
+}
+
+TEST(ShardedLruCacheTest, PutOverwritesExistingKey) {
+    ShardedLruCache<std::string, int> cache(100);
+    cache.put("a", 1);
+    cache.put("a", 5);
+
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(cache.get("a"), 5);
+}
+
+TEST(ShardedLruCacheTest, EvictsLeastRecentlyUsed) {
+    ShardedLruCache<int, int> cache(3, 1);
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.put(3, 3);
+    cache.get(1); // 2 is now the oldest
+    cache.put(4, 4);
+
+    EXPECT_TRUE(cache.get(1).has_value());
+    EXPECT_FALSE(cache.get(2).has_value());
+    EXPECT_TRUE(cache.get(3).has_value());
+    EXPECT_TRUE(cache.get(4).has_value());
+    EXPECT_EQ(cache.evictions(), 1u);
+}
+
+TEST(ShardedLruCacheTest, CapacityCountsWeights) {
+    ShardedLruCache<int, std::string> cache(100, 1);
+    cache.put(1, "x", 40);
+    cache.put(2, "y", 40);
+    cache.put(3, "z", 40);
+
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.weight(), 80u);
+    EXPECT_FALSE(cache.get(1).has_value());
+
+    // An entry larger than the shard still goes in, alone
+    cache.put(4, "big", 500);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_TRUE(cache.get(4).has_value());
+}
+
+TEST(ShardedLruCacheTest, EraseAndClear) {
+    ShardedLruCache<int, int> cache(100);
+    for (int i = 0; i < 50; ++i) cache.put(i, i);
+
+    EXPECT_TRUE(cache.erase(10));
+    EXPECT_FALSE(cache.erase(10));
+    EXPECT_EQ(cache.size(), 49u);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.weight(), 0u);
+}
+
+TEST(ShardedLruCacheTest, ForEachVisitsEveryEntry) {
+    ShardedLruCache<int, int> cache(1000);
+    for (int i = 0; i < 200; ++i) cache.put(i, i * 2);
+
+    long sum = 0;
+    size_t count = 0;
+    cache.forEach([&](int key, int value) {
+        EXPECT_EQ(value, key * 2);
+        sum += key;
+        ++count;
+    });
+    EXPECT_EQ(count, 200u);
+    EXPECT_EQ(sum, 199 * 200 / 2);
+}
+
+TEST(ShardedLruCacheTest, ShardCountRoundsUpToPowerOfTwo) {
+    ShardedLruCache<int, int> cache(100, 5);
+    EXPECT_EQ(cache.shardCount(), 8u);
+}
+
+TEST(ShardedLruCacheTest, ConcurrentAccess) {
+    ShardedLruCache<int, int> cache(512);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, t]() {
+            for (int i = 0; i < 20000; ++i) {
+                int key = (i * 7 + t) % 1024;
+                if (i % 3 == 0) {
+                    cache.put(key, key);
+                } else if (auto value = cache.get(key)) {
+                    EXPECT_EQ(*value, key);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_LE(cache.size(), 512u + cache.shardCount());
+}
+
+} // namespace test
+} // namespace civic
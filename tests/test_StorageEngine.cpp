@@ -1,8 +1,13 @@
 #include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
 #include <string>
 #include <thread>
 #include <vector>
+#include <unistd.h>
+#include "core/ThreadPool.hpp"
 #include "data/StorageEngine.hpp"
+#include "data/VerificationStore.hpp"
 
 namespace civic {
 namespace test {
@@ -313,5 +318,508 @@ TEST(StorageEngineTest, BatchIngestion) {
     EXPECT_LT(duration.count(), 5000);
 }
 
+TEST(StorageEngineTest, IngestBatchAppendsAllRows) {
+    StorageEngine engine(":memory:");
+    auto con = engine.createConnection();
+    
+    std::vector<std::string> batch;
+    for (int i = 0; i < 1000; ++i) {
+        batch.push_back(R"({"slideshow": {"author": "Batch", "title": "Item)" + 
+                        std::to_string(i) + R"("}})");
+    }
+    
+    EXPECT_EQ(engine.ingestBatch(*con, batch), 1000u);
+    
+    auto result = con->Query("SELECT COUNT(*) FROM ingest_logs");
+    ASSERT_FALSE(result->HasError());
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), 1000);
+}
+
+TEST(StorageEngineTest, IngestBatchExtractsFields) {
+    StorageEngine engine(":memory:");
+    auto con = engine.createConnection();
+    
+    std::vector<std::string> batch = {
+        R"({"slideshow": {"author": "Batch Author", "title": "Batch Title"}})",
+        R"({"key": "value"})"
+    };
+    engine.ingestBatch(*con, batch);
+    
+    auto result = con->Query("SELECT author, title FROM ingest_logs ORDER BY author");
+    ASSERT_FALSE(result->HasError());
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<std::string>(), "Batch Author");
+    EXPECT_EQ(result->GetValue(1, 0).GetValue<std::string>(), "Batch Title");
+    EXPECT_EQ(result->GetValue(0, 1).GetValue<std::string>(), "Unknown");
+    EXPECT_EQ(result->GetValue(1, 1).GetValue<std::string>(), "Untitled");
+}
+
+TEST(StorageEngineTest, IngestBatchSkipsInvalidJson) {
+    StorageEngine engine(":memory:");
+    auto con = engine.createConnection();
+    
+    std::vector<std::string> batch = {
+        R"({"slideshow": {"author": "A", "title": "T"}})",
+        "{ not valid json }",
+        "{}"
+    };
+    
+    EXPECT_EQ(engine.ingestBatch(*con, batch), 2u);
+}
+
+TEST(StorageEngineTest, IngestBatchEmpty) {
+    StorageEngine engine(":memory:");
+    auto con = engine.createConnection();
+    
+    std::vector<std::string> batch;
+    EXPECT_EQ(engine.ingestBatch(*con, batch), 0u);
+}
+
+TEST(StorageEngineTest, IngestBatchThroughput) {
+    StorageEngine engine(":memory:");
+    auto con = engine.createConnection();
+    
+    std::vector<std::string> batch;
+    for (int i = 0; i < 1024; ++i) {
+        batch.push_back(R"({"slideshow": {"author": "HighFreq Bot", "title": "Benchmark Data", "date": "2025"}})");
+    }
+    
+    const int numBatches = 100;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < numBatches; ++i) {
+        engine.ingestBatch(*con, batch);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    
+    std::cout << "[BENCHMARK] ingestBatch: " 
+              << static_cast<long long>(numBatches * batch.size() / seconds) << " rows/s" << std::endl;
+    
+    EXPECT_LT(seconds, 10.0);
+}
+
+TEST(StorageEngineTest, WriterCommitMakesRowsVisible) {
+    StorageEngine engine(":memory:");
+    auto writer = engine.createWriter();
+    
+    std::vector<std::string> batch(10, R"({"slideshow": {"author": "Writer", "title": "Row"}})");
+    EXPECT_EQ(writer->append(batch), 10u);
+    EXPECT_EQ(writer->pendingRows(), 10u);
+    
+    writer->commit();
+    EXPECT_EQ(writer->pendingRows(), 0u);
+    
+    auto con = engine.createConnection();
+    auto result = con->Query("SELECT COUNT(*) FROM ingest_logs");
+    ASSERT_FALSE(result->HasError());
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), 10);
+}
+
+TEST(StorageEngineTest, ConcurrentWriters) {
+    StorageEngine engine(":memory:");
+    const int numThreads = 4;
+    const int batchesPerThread = 20;
+    const int batchSize = 256;
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&engine, t]() {
+            auto writer = engine.createWriter();
+            std::vector<std::string> batch;
+            for (int i = 0; i < batchSize; ++i) {
+                batch.push_back(R"({"slideshow": {"author": "Thread)" + std::to_string(t) + 
+                                R"(", "title": "Item)" + std::to_string(i) + R"("}})");
+            }
+            for (int b = 0; b < batchesPerThread; ++b) {
+                writer->append(batch);
+                writer->commit();
+            }
+        });
+    }
+    
+    for (auto& t : threads) {
+        t.join();
+    }
+    
+    auto con = engine.createConnection();
+    auto result = con->Query("SELECT COUNT(*) FROM ingest_logs");
+    ASSERT_FALSE(result->HasError());
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), numThreads * batchesPerThread * batchSize);
+}
+
+TEST(StorageEngineTest, QueryDuringWriterCommits) {
+    StorageEngine engine(":memory:");
+    std::atomic<bool> writing{true};
+    std::atomic<int> queries{0};
+    
+    std::thread writerThread([&]() {
+        auto writer = engine.createWriter();
+        std::vector<std::string> batch(512, R"({"slideshow": {"author": "W", "title": "T"}})");
+        for (int b = 0; b < 50; ++b) {
+            writer->append(batch);
+            writer->commit();
+        }
+        writing = false;
+    });
+    
+    std::thread queryThread([&]() {
+        auto con = engine.createConnection();
+        do {
+            auto result = con->Query("SELECT COUNT(*), COUNT(DISTINCT author) FROM ingest_logs");
+            EXPECT_FALSE(result->HasError());
+            queries.fetch_add(1);
+        } while (writing.load());
+    });
+    
+    writerThread.join();
+    queryThread.join();
+    
+    auto con = engine.createConnection();
+    auto result = con->Query("SELECT COUNT(*) FROM ingest_logs");
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), 50 * 512);
+    EXPECT_GT(queries.load(), 0);
+}
+
+TEST(StorageEngineTest, ParserContextReusesBuffers) {
+    ParserContext parser;
+    const size_t initialCapacity = parser.capacity();
+    EXPECT_GE(initialCapacity, ParserContext::kInitialCapacity);
+    
+    std::string_view author, title;
+    for (int i = 0; i < 1000; ++i) {
+        std::string json = R"({"slideshow": {"author": "Author)" + std::to_string(i) + R"(", "title": "T"}})";
+        ASSERT_TRUE(parser.extractFields(json, author, title));
+        EXPECT_EQ(author, "Author" + std::to_string(i));
+    }
+    
+    EXPECT_EQ(parser.capacity(), initialCapacity);
+    EXPECT_FALSE(parser.extractFields("{ not valid json }", author, title));
+}
+
+TEST(StorageEngineTest, ParallelParsersIndependent) {
+    const int numThreads = 4;
+    std::atomic<int> mismatches{0};
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([t, &mismatches]() {
+            ParserContext parser;
+            std::string expected = "Thread" + std::to_string(t);
+            std::string json = R"({"slideshow": {"author": ")" + expected + R"(", "title": "T"}})";
+            std::string_view author, title;
+            for (int i = 0; i < 10000; ++i) {
+                if (!parser.extractFields(json, author, title) || author != expected) {
+                    mismatches.fetch_add(1);
+                }
+            }
+        });
+    }
+    
+    for (auto& t : threads) {
+        t.join();
+    }
+    
+    EXPECT_EQ(mismatches.load(), 0);
+}
+
+TEST(StorageEngineTest, ParserContextParsesPayloadInPlace) {
+    PayloadPool pool;
+    ParserContext parser;
+    
+    auto payload = pool.copyOf(R"({"slideshow": {"author": "Payload Author", "title": "Payload Title"}})");
+    std::string_view author, title;
+    ASSERT_TRUE(parser.extractFields(payload, author, title));
+    EXPECT_EQ(author, "Payload Author");
+    EXPECT_EQ(title, "Payload Title");
+    
+    EXPECT_FALSE(parser.extractFields(Payload(), author, title));
+}
+
+TEST(StorageEngineTest, WriterAppendsPayloads) {
+    StorageEngine engine(":memory:");
+    PayloadPool pool;
+    auto writer = engine.createWriter();
+    
+    std::vector<Payload> batch;
+    for (int i = 0; i < 100; ++i) {
+        batch.push_back(pool.copyOf(R"({"slideshow": {"author": "Pooled", "title": "Item)" + 
+                                    std::to_string(i) + R"("}})"));
+    }
+    
+    EXPECT_EQ(writer->append(batch), 100u);
+    writer->commit();
+    
+    auto con = engine.createConnection();
+    auto result = con->Query("SELECT COUNT(*) FROM ingest_logs WHERE author = 'Pooled'");
+    ASSERT_FALSE(result->HasError());
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), 100);
+}
+
+TEST(StorageEngineTest, ParserContextSplitsNdjson) {
+    ParserContext parser;
+    simdjson::padded_string ndjson(std::string(
+        "{\"slideshow\": {\"author\": \"A\", \"title\": \"One\"}}\n"
+        "\n"
+        "{\"slideshow\": {\"author\": \"B\", \"title\": \"Two\"}}\r\n"
+        "{\"other\": 1}"));
+    
+    std::vector<std::string> seen;
+    size_t count = parser.extractMany(std::string_view(ndjson), [&](std::string_view raw, std::string_view author, std::string_view title) {
+        seen.push_back(std::string(author) + "/" + std::string(title) + " " + std::string(raw));
+    });
+    
+    EXPECT_EQ(count, 3u);
+    EXPECT_EQ(seen, (std::vector<std::string>{
+        "A/One {\"slideshow\": {\"author\": \"A\", \"title\": \"One\"}}",
+        "B/Two {\"slideshow\": {\"author\": \"B\", \"title\": \"Two\"}}",
+        "Unknown/Untitled {\"other\": 1}"}));
+}
+
+TEST(StorageEngineTest, ParserContextSkipsInvalidNdjsonLines) {
+    ParserContext parser;
+    simdjson::padded_string ndjson(std::string(
+        "{\"slideshow\": {\"author\": \"A\", \"title\": \"1\"}}\n"
+        "{\"slideshow\": }\n"
+        "{\"slideshow\": {\"author\": \"B\", \"title\": \"2\"}}\n"
+        "{\"unterminated\": \"x}\n"
+        "{\"slideshow\": {\"author\": \"C\", \"title\": \"3\"}}\n"));
+    
+    std::vector<std::string> authors;
+    size_t count = parser.extractMany(std::string_view(ndjson), [&](std::string_view raw, std::string_view author, std::string_view) {
+        authors.emplace_back(author);
+        EXPECT_EQ(raw.front(), '{');
+        EXPECT_EQ(raw.back(), '}');
+    });
+    
+    EXPECT_EQ(count, 3u);
+    EXPECT_EQ(authors, (std::vector<std::string>{"A", "B", "C"}));
+}
+
+TEST(StorageEngineTest, IngestNdjsonFileUsesParallelWriters) {
+    auto path = std::filesystem::temp_directory_path() / ("ingest_" + std::to_string(::getpid()) + ".jsonl");
+    const int lines = 20000;
+    {
+        std::ofstream out(path);
+        for (int i = 0; i < lines; ++i) {
+            out << R"({"slideshow": {"author": "Bulk", "title": "Line)" << i << R"("}})" << '\n';
+        }
+        out << "not json\n";
+    }
+    
+    StorageEngine engine(":memory:");
+    NdjsonOptions options;
+    options.windowBytes = 64 * 1024;
+    options.writers = 4;
+    EXPECT_EQ(engine.ingestNdjson(path.string(), options), static_cast<size_t>(lines));
+    
+    auto con = engine.createConnection();
+    auto result = con->Query("SELECT COUNT(*), COUNT(DISTINCT title) FROM ingest_logs WHERE author = 'Bulk'");
+    ASSERT_FALSE(result->HasError());
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), lines);
+    EXPECT_EQ(result->GetValue(1, 0).GetValue<int64_t>(), lines);
+    
+    EXPECT_EQ(engine.ingestNdjson(path.string() + ".missing"), 0u);
+    std::filesystem::remove(path);
+}
+
+TEST(StorageEngineTest, IngestNdjsonBuffer) {
+    StorageEngine engine(":memory:");
+    std::string ndjson = R"({"slideshow": {"author": "Buf", "title": "1"}})" "\n"
+                         R"({"slideshow": {"author": "Buf", "title": "2"}})";
+    EXPECT_EQ(engine.ingestNdjsonBuffer(ndjson), 2u);
+    EXPECT_EQ(engine.ingestNdjsonBuffer(""), 0u);
+}
+
+TEST(StorageEngineTest, IngestNdjsonRunsOnCallerPool) {
+    std::string ndjson;
+    for (int i = 0; i < 1000; ++i) {
+        ndjson += R"({"slideshow": {"author": "Pool", "title": "Line)" + std::to_string(i) + R"("}})" "\n";
+    }
+
+    ThreadPool pool(3);
+    StorageEngine engine(":memory:");
+    NdjsonOptions options;
+    options.windowBytes = 4 * 1024;
+    options.pool = &pool;
+    EXPECT_EQ(engine.ingestNdjsonBuffer(ndjson, options), 1000u);
+    // The pool outlives the call and can run the next load
+    EXPECT_EQ(engine.ingestNdjsonBuffer(ndjson, options), 1000u);
+}
+
+TEST(StorageEngineTest, IngestNdjsonThroughput) {
+    std::string ndjson;
+    for (int i = 0; i < 200000; ++i) {
+        ndjson += R"({"slideshow": {"author": "HighFreq Bot", "title": "Benchmark Data", "date": "2025"}})" "\n";
+    }
+    
+    StorageEngine engine(":memory:");
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t rows = engine.ingestNdjsonBuffer(ndjson);
+    double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    
+    std::cout << "[BENCHMARK] ingestNdjson: " << static_cast<long long>(rows / seconds) << " rows/s, "
+              << static_cast<long long>(ndjson.size() / seconds / (1024 * 1024)) << " MiB/s" << std::endl;
+    
+    EXPECT_EQ(rows, 200000u);
+    EXPECT_LT(seconds, 10.0);
+}
+
+TEST(StorageEngineTest, VerificationStoreRoundTrip) {
+    StorageEngine engine(":memory:");
+    VerificationStore store(engine);
+    
+    CacheVerification cache;
+    EntreeVerification entree;
+    entree.verification.httpStatus = 200;
+    entree.verification.disponible = true;
+    entree.verification.mimeTypeReel = "text/csv";
+    entree.verification.tailleReelle = 4096;
+    entree.verification.tempsReponse = std::chrono::milliseconds(12);
+    entree.etag = "\"abc\"";
+    entree.verifieeLe = std::chrono::system_clock::now();
+    cache.enregistrer("https://example.org/a.csv", entree);
+    
+    entree.verification.httpStatus = 404;
+    entree.verification.disponible = false;
+    entree.verification.mimeTypeReel.reset();
+    entree.verification.tailleReelle.reset();
+    entree.etag.reset();
+    entree.lastModified = "Wed, 01 Jan 2025 00:00:00 GMT";
+    cache.enregistrer("https://example.org/gone.csv", entree);
+    
+    EXPECT_EQ(store.save(cache), 2u);
+    
+    CacheVerification recharge;
+    EXPECT_EQ(store.load(recharge), 2u);
+    
+    auto a = recharge.entree("https://example.org/a.csv");
+    ASSERT_TRUE(a.has_value());
+    EXPECT_TRUE(a->verification.disponible);
+    EXPECT_EQ(a->verification.mimeTypeReel, "text/csv");
+    EXPECT_EQ(a->verification.tailleReelle, 4096);
+    EXPECT_EQ(a->etag, "\"abc\"");
+    
+    auto gone = recharge.entree("https://example.org/gone.csv");
+    ASSERT_TRUE(gone.has_value());
+    EXPECT_EQ(gone->verification.httpStatus, 404);
+    EXPECT_FALSE(gone->verification.mimeTypeReel.has_value());
+    EXPECT_FALSE(gone->etag.has_value());
+    EXPECT_EQ(gone->lastModified, "Wed, 01 Jan 2025 00:00:00 GMT");
+    
+    // Une seconde sauvegarde remplace la table au lieu de l'allonger
+    EXPECT_EQ(store.save(recharge), 2u);
+    auto con = engine.createConnection();
+    auto result = con->Query("SELECT COUNT(*) FROM verification_cache");
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), 2);
+}
+
+namespace {
+    ExtractionSpec resourceSpec(bool keepRaw) {
+        using Kind = ExtractedColumn::Kind;
+        ExtractionSpec spec;
+        spec.type = "datagouv_resource";
+        spec.table = "resources";
+        spec.columns = {
+            {"resource_id", "/resource_id", Kind::Varchar, {}},
+            {"format", "/format", Kind::Enum, {"text/csv", "application/json"}},
+            {"taille", "/taille", Kind::BigInt, {}},
+            {"modified", "/meta/modified", Kind::Timestamp, {}},
+        };
+        spec.keepRaw = keepRaw;
+        return spec;
+    }
+}
+
+TEST(StorageEngineTest, ExtractionSpecCreateStatement) {
+    EXPECT_EQ(resourceSpec(false).createStatement(),
+              "CREATE TABLE IF NOT EXISTS \"resources\" (ingest_ts TIMESTAMP, \"resource_id\" VARCHAR, "
+              "\"format\" ENUM('text/csv', 'application/json'), \"taille\" BIGINT, \"modified\" TIMESTAMP)");
+    EXPECT_NE(resourceSpec(true).createStatement().find(", raw_data TEXT)"), std::string::npos);
+}
+
+TEST(StorageEngineTest, WriterRoutesTypedPayloadsToExtractionTable) {
+    StorageEngine engine(":memory:");
+    ASSERT_TRUE(engine.addExtraction(resourceSpec(false)));
+
+    std::vector<std::string> batch = {
+        R"({"type": "datagouv_resource", "resource_id": "r1", "format": "text/csv", "taille": 2048,
+            "meta": {"modified": "2025-03-01 12:00:00"}})",
+        R"({"type": "datagouv_resource", "resource_id": "r2", "format": "application/zip", "taille": "n/a"})",
+        R"({"slideshow": {"author": "Typed", "title": "Untouched"}})",
+    };
+    auto writer = engine.createWriter();
+    EXPECT_EQ(writer->append(batch), 3u);
+    EXPECT_EQ(writer->appendNdjson(R"({"type": "datagouv_resource", "resource_id": "r3", "taille": 1})" "\n"
+                                   + std::string(simdjson::SIMDJSON_PADDING, ' ')), 1u);
+    writer->commit();
+
+    auto con = engine.createConnection();
+    auto typed = con->Query("SELECT COUNT(*), COUNT(format), SUM(taille), COUNT(modified) FROM resources");
+    ASSERT_FALSE(typed->HasError());
+    EXPECT_EQ(typed->GetValue(0, 0).GetValue<int64_t>(), 3);
+    EXPECT_EQ(typed->GetValue(1, 0).GetValue<int64_t>(), 1);
+    EXPECT_EQ(typed->GetValue(2, 0).GetValue<int64_t>(), 2049);
+    EXPECT_EQ(typed->GetValue(3, 0).GetValue<int64_t>(), 1);
+
+    auto logs = con->Query("SELECT COUNT(*) FROM ingest_logs");
+    ASSERT_FALSE(logs->HasError());
+    EXPECT_EQ(logs->GetValue(0, 0).GetValue<int64_t>(), 1);
+}
+
+TEST(StorageEngineTest, OutOfRangeEpochBecomesNull) {
+    StorageEngine engine(":memory:");
+    ASSERT_TRUE(engine.addExtraction(resourceSpec(false)));
+
+    std::vector<std::string> batch = {
+        R"({"type": "datagouv_resource", "resource_id": "r1", "meta": {"modified": 1000000000000000}})",
+        R"({"type": "datagouv_resource", "resource_id": "r2", "meta": {"modified": 1700000000}})",
+    };
+    auto writer = engine.createWriter();
+    EXPECT_EQ(writer->append(batch), 2u);
+    writer->commit();
+
+    auto con = engine.createConnection();
+    auto result = con->Query("SELECT COUNT(*), COUNT(modified) FROM resources");
+    ASSERT_FALSE(result->HasError());
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), 2);
+    EXPECT_EQ(result->GetValue(1, 0).GetValue<int64_t>(), 1);
+}
+
+TEST(StorageEngineTest, FailedRowDoesNotDropRestOfBatch) {
+    StorageEngine engine(":memory:");
+    ASSERT_TRUE(engine.addExtraction(resourceSpec(false)));
+    auto writer = engine.createWriter();
+    auto con = engine.createConnection();
+    ASSERT_FALSE(con->Query("DROP TABLE resources")->HasError());
+
+    std::vector<std::string> batch = {
+        R"({"type": "datagouv_resource", "resource_id": "r1"})",
+        R"({"slideshow": {"author": "After", "title": "1"}})",
+        R"({"type": "datagouv_resource", "resource_id": "r2"})",
+        R"({"slideshow": {"author": "After", "title": "2"}})",
+    };
+    EXPECT_EQ(writer->append(batch), 2u);
+    EXPECT_EQ(writer->pendingRows(), 2u);
+    writer->commit();
+
+    auto result = con->Query("SELECT COUNT(*) FROM ingest_logs WHERE author = 'After'");
+    ASSERT_FALSE(result->HasError());
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<int64_t>(), 2);
+}
+
+TEST(StorageEngineTest, ExtractionKeepsRawDataOnRequest) {
+    StorageEngine engine(":memory:");
+    ASSERT_TRUE(engine.addExtraction(resourceSpec(true)));
+
+    std::string raw = R"({"type": "datagouv_resource", "resource_id": "r1"})";
+    auto writer = engine.createWriter();
+    EXPECT_EQ(writer->append(std::span<const std::string>(&raw, 1)), 1u);
+    writer->commit();
+
+    auto con = engine.createConnection();
+    auto result = con->Query("SELECT raw_data FROM resources");
+    ASSERT_FALSE(result->HasError());
+    EXPECT_EQ(result->GetValue(0, 0).GetValue<std::string>(), raw);
+}
+
 } 
 }
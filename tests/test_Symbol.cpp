@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "core/Symbol.hpp"
+
+namespace civic {
+namespace test {
+
+TEST(SymbolTest, EqualContentsShareStorage) {
+    Symbol a("text/csv");
+    Symbol b(std::string("text/") + "csv");
+    Symbol c(std::string_view("application/json"));
+
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a.data(), b.data());
+    EXPECT_FALSE(a == c);
+}
+
+TEST(SymbolTest, DefaultIsEmpty) {
+    Symbol s;
+    EXPECT_TRUE(s.empty());
+    EXPECT_EQ(s, Symbol(""));
+    EXPECT_EQ(s.str(), "");
+}
+
+TEST(SymbolTest, ComparesAndConvertsLikeAString) {
+    Symbol s = std::string("fr:region");
+    EXPECT_EQ(s, "fr:region");
+    EXPECT_EQ(s, std::string("fr:region"));
+    EXPECT_EQ(s, std::string_view("fr:region"));
+    EXPECT_NE(s.find("region"), std::string::npos);
+    EXPECT_EQ(s.size(), 9u);
+
+    const std::string& ref = s;
+    EXPECT_EQ(ref, "fr:region");
+    std::string copie = s;
+    EXPECT_EQ(copie, "fr:region");
+
+    std::ostringstream out;
+    out << s;
+    EXPECT_EQ(out.str(), "fr:region");
+    EXPECT_TRUE(Symbol("a") < Symbol("b"));
+}
+
+TEST(SymbolTest, HashesByIdentity) {
+    std::unordered_set<Symbol> set;
+    set.insert("sante");
+    set.insert(std::string("sante"));
+    set.insert("transport");
+    EXPECT_EQ(set.size(), 2u);
+    EXPECT_TRUE(set.count(Symbol("sante")));
+}
+
+TEST(SymbolTest, ConcurrentInterningYieldsOneCopy) {
+    std::vector<std::thread> threads;
+    std::vector<const char*> adresses(8);
+    for (size_t t = 0; t < adresses.size(); ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 1000; ++i) {
+                Symbol(std::to_string(i) + "-concurrent");
+            }
+            adresses[t] = Symbol("shared-concurrent").data();
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    for (auto* adresse : adresses) EXPECT_EQ(adresse, adresses[0]);
+    EXPECT_GE(Symbol::tableSize(), 1001u);
+}
+
+} // namespace test
+} // namespace civic
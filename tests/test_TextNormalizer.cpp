@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "search/TextNormalizer.hpp"
+
+namespace civic {
+namespace test {
+
+namespace {
+    // Implémentation d'origine (remplacements successifs puis filtrage),
+    // gardée comme référence de comportement et de performance
+    std::string normaliserTexteReference(const std::string& texte) {
+        std::string resultat;
+        resultat.reserve(texte.size());
+        
+        // Table de conversion des caractères accentués UTF-8
+        static const std::vector<std::pair<std::string, std::string>> accents = {
+            {"é", "e"}, {"è", "e"}, {"ê", "e"}, {"ë", "e"},
+            {"à", "a"}, {"â", "a"}, {"ä", "a"},
+            {"ù", "u"}, {"û", "u"}, {"ü", "u"},
+            {"î", "i"}, {"ï", "i"},
+            {"ô", "o"}, {"ö", "o"},
+            {"ç", "c"},
+            {"É", "e"}, {"È", "e"}, {"Ê", "e"}, {"Ë", "e"},
+            {"À", "a"}, {"Â", "a"}, {"Ä", "a"},
+            {"Ù", "u"}, {"Û", "u"}, {"Ü", "u"},
+            {"Î", "i"}, {"Ï", "i"},
+            {"Ô", "o"}, {"Ö", "o"},
+            {"Ç", "c"}
+        };
+        
+        std::string temp = texte;
+        for (const auto& [accent, replacement] : accents) {
+            size_t pos = 0;
+            while ((pos = temp.find(accent, pos)) != std::string::npos) {
+                temp.replace(pos, accent.length(), replacement);
+                pos += replacement.length();
+            }
+        }
+        
+        for (char c : temp) {
+            if (std::isalnum(static_cast<unsigned char>(c)) || c == ' ' || c == '-') {
+                resultat += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+        }
+        
+        // Trim
+        size_t start = resultat.find_first_not_of(" ");
+        size_t end = resultat.find_last_not_of(" ");
+        if (start == std::string::npos) return "";
+        return resultat.substr(start, end - start + 1);
+    }
+
+    std::string normaliser(std::string_view texte) {
+        std::string sortie(texte.size(), '\0');
+        sortie.resize(normaliserTexte(texte, sortie.data()));
+        return sortie;
+    }
+}
+
+TEST(TextNormalizerTest, LowercasesAndFoldsFrenchAccents) {
+    EXPECT_EQ(normaliserTexte("Économie Régionale"), "economie regionale");
+    EXPECT_EQ(normaliserTexte("ÀÂÄ àâä ÇçÉÈÊË ÎÏîï ÔÖôö ÙÛÜùûü"), "aaa aaa cceeee iiii oooo uuuuuu");
+}
+
+TEST(TextNormalizerTest, FoldsLatinSupplementAndExtendedA) {
+    EXPECT_EQ(normaliserTexte("Œuvre cœur"), "oeuvre coeur");
+    EXPECT_EQ(normaliserTexte("Straße Ñandú Łódź"), "strasse nandu lodz");
+    EXPECT_EQ(normaliserTexte("Ærø Ĳssel"), "aero ijssel");
+}
+
+TEST(TextNormalizerTest, DropsPunctuationAndOtherScripts) {
+    EXPECT_EQ(normaliserTexte("l'eau, c'est (bien) 100% !"), "leau cest bien 100");
+    EXPECT_EQ(normaliserTexte("prix € × 2 ÷ 3"), "prix   2  3");
+    EXPECT_EQ(normaliserTexte("日本 data"), "data");
+    EXPECT_EQ(normaliserTexte("l\xE2\x80\x99" "eau"), "leau");
+}
+
+TEST(TextNormalizerTest, TrimsAndKeepsInnerSpacesAndHyphens) {
+    EXPECT_EQ(normaliserTexte("   piste-cyclable   "), "piste-cyclable");
+    EXPECT_EQ(normaliserTexte("a  b"), "a  b");
+    EXPECT_EQ(normaliserTexte(" !! "), "");
+    EXPECT_EQ(normaliserTexte(""), "");
+}
+
+TEST(TextNormalizerTest, TurnsWhitespaceAndNbspIntoSpaces) {
+    EXPECT_EQ(normaliserTexte("ligne\nsuivante\ttab"), "ligne suivante tab");
+    EXPECT_EQ(normaliserTexte("10\xC2\xA0km"), "10 km");
+}
+
+TEST(TextNormalizerTest, IgnoresTruncatedOrInvalidUtf8) {
+    EXPECT_EQ(normaliserTexte("caf\xC3"), "caf");
+    EXPECT_EQ(normaliserTexte("a\x80\xBF" "b"), "ab");
+    EXPECT_EQ(normaliserTexte("\xC3" "A"), "a");
+}
+
+TEST(TextNormalizerTest, WritesIntoCallerBufferWithoutGrowing) {
+    std::string entree = "  Données OUVERTES de l'État  ";
+    std::vector<char> tampon(entree.size());
+    size_t n = normaliserTexte(entree, tampon.data());
+    EXPECT_EQ(std::string(tampon.data(), n), "donnees ouvertes de letat");
+    EXPECT_LE(n, entree.size());
+}
+
+TEST(TextNormalizerTest, SimdPathMatchesScalarOnLongAsciiRuns) {
+    std::string texte;
+    for (int i = 0; i < 64; ++i) {
+        texte += "Transport Public-Urbain 2024 ";
+        texte += (i % 7 == 0) ? "Réseau, " : "reseau ";
+    }
+    EXPECT_EQ(normaliser(texte), normaliserTexteReference(texte));
+}
+
+TEST(TextNormalizerTest, MatchesReferenceOnFrenchText) {
+    std::vector<std::string> textes = {
+        "Qualité de l'eau potable en Île-de-France",
+        "Liste des établissements scolaires (écoles, collèges, lycées)",
+        "  Données ESSENTIELLES des marchés publics - DECP  ",
+        "Réseau de pistes cyclables à Besançon",
+    };
+    for (const auto& texte : textes) {
+        EXPECT_EQ(normaliserTexte(texte), normaliserTexteReference(texte)) << texte;
+    }
+}
+
+TEST(TextNormalizerTest, BenchmarkAgainstReference) {
+    std::string corpus;
+    for (int i = 0; i < 200; ++i) {
+        corpus += "Données essentielles des marchés publics de la Région Île-de-France : "
+                  "attributions, montants, fournisseurs et durées des contrats. ";
+    }
+
+    constexpr int iterations = 20;
+    std::vector<char> tampon(corpus.size());
+    size_t total = 0;
+
+    auto debut = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        total += normaliserTexte(corpus, tampon.data());
+    }
+    auto nouveau = std::chrono::steady_clock::now() - debut;
+
+    debut = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        total += normaliserTexteReference(corpus).size();
+    }
+    auto reference = std::chrono::steady_clock::now() - debut;
+
+    auto mbps = [&](std::chrono::steady_clock::duration d) {
+        double secondes = std::chrono::duration<double>(d).count();
+        return secondes > 0 ? corpus.size() * iterations / secondes / (1024 * 1024) : 0.0;
+    };
+    std::cout << "[BENCHMARK] normaliserTexte single-pass: " << mbps(nouveau) << " MiB/s, reference: "
+              << mbps(reference) << " MiB/s" << std::endl;
+
+    EXPECT_GT(total, 0u);
+}
+
+} // namespace test
+} // namespace civic
@@ -1,8 +1,14 @@
 #include <gtest/gtest.h>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <future>
 #include <mutex>
 #include <vector>
+#include <set>
+#include <stdexcept>
+#include <string>
 #include "core/ThreadPool.hpp"
 
 namespace civic {
@@ -34,17 +40,15 @@ TEST(ThreadPoolTest, ConstructorSingleThread) {
 TEST(ThreadPoolTest, TaskExecution) {
     ThreadPool pool(2);
     std::atomic<int> counter{0};
-    std::atomic<bool> shouldRun{true};
     
-    pool.setTask([&counter, &shouldRun]() {
-        if (shouldRun.load()) {
+    pool.startService([&counter](std::stop_token stop) {
+        while (!stop.stop_requested()) {
             counter.fetch_add(1, std::memory_order_relaxed);
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
     });
     
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    shouldRun = false;
     pool.stop();
     
     EXPECT_GT(counter.load(), 0);
@@ -54,24 +58,20 @@ TEST(ThreadPoolTest, MultipleThreadsExecuting) {
     const size_t numThreads = 4;
     ThreadPool pool(numThreads);
     
-    std::atomic<int> counter{0};
     std::set<std::thread::id> threadIds;
     std::mutex idMutex;
-    std::atomic<bool> shouldRun{true};
     
-    pool.setTask([&]() {
-        if (shouldRun.load()) {
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 20; ++i) {
+        futures.push_back(pool.submit([&]() {
             {
                 std::lock_guard<std::mutex> lock(idMutex);
                 threadIds.insert(std::this_thread::get_id());
             }
-            counter.fetch_add(1);
             std::this_thread::sleep_for(std::chrono::milliseconds(20));
-        }
-    });
-    
-    std::this_thread::sleep_for(std::chrono::milliseconds(200));
-    shouldRun = false;
+        }));
+    }
+    for (auto& f : futures) f.get();
     pool.stop();
     
     EXPECT_GT(threadIds.size(), 1);
@@ -95,21 +95,21 @@ TEST(ThreadPoolTest, DoubleStopSafe) {
 }
 
 TEST(ThreadPoolTest, DestructorStops) {
-    std::atomic<bool> taskRunning{true};
+    std::atomic<bool> serviceExited{false};
     
     {
         ThreadPool pool(2);
-        pool.setTask([&taskRunning]() {
-            if (taskRunning) {
+        pool.startService([&serviceExited](std::stop_token stop) {
+            while (!stop.stop_requested()) {
                 std::this_thread::sleep_for(std::chrono::milliseconds(10));
             }
+            serviceExited = true;
         });
         
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        taskRunning = false;
     }
     
-    SUCCEED();
+    EXPECT_TRUE(serviceExited.load());
 }
 
 
@@ -119,58 +119,50 @@ TEST(ThreadPoolTest, ConcurrentTaskExecution) {
     
     std::atomic<int> activeCount{0};
     std::atomic<int> maxConcurrent{0};
-    std::atomic<bool> shouldRun{true};
     
-    pool.setTask([&]() {
-        if (!shouldRun.load()) return;
-        
-        int current = activeCount.fetch_add(1) + 1;
-        
-        int prevMax = maxConcurrent.load();
-        while (current > prevMax && !maxConcurrent.compare_exchange_weak(prevMax, current)) {
-        }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        activeCount.fetch_sub(1);
-    });
+    for (int i = 0; i < 8; ++i) {
+        pool.enqueue([&]() {
+            int current = activeCount.fetch_add(1) + 1;
+            
+            int prevMax = maxConcurrent.load();
+            while (current > prevMax && !maxConcurrent.compare_exchange_weak(prevMax, current)) {
+            }
+            
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            activeCount.fetch_sub(1);
+        });
+    }
     
     std::this_thread::sleep_for(std::chrono::milliseconds(200));
-    shouldRun = false;
     pool.stop();
     
     EXPECT_GE(maxConcurrent.load(), 1);
 }
 
 
-TEST(ThreadPoolTest, TaskCanBeChanged) {
+TEST(ThreadPoolTest, ServicesRunAlongsideTasks) {
     ThreadPool pool(2);
     
-    std::atomic<int> firstTaskCount{0};
-    std::atomic<int> secondTaskCount{0};
-    std::atomic<bool> shouldRun{true};
-    
-    pool.setTask([&]() {
-        if (shouldRun.load()) {
-            firstTaskCount.fetch_add(1);
+    std::atomic<int> serviceCount{0};
+    pool.startService([&](std::stop_token stop) {
+        while (!stop.stop_requested()) {
+            serviceCount.fetch_add(1);
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
     });
     
-    std::this_thread::sleep_for(std::chrono::milliseconds(50));
-    
-    pool.setTask([&]() {
-        if (shouldRun.load()) {
-            secondTaskCount.fetch_add(1);
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
-    });
+    // The long-running service does not hold a worker: short tasks still run
+    auto first = pool.submit([]() { return 1; });
+    auto second = pool.submit([]() { return 2; });
+    EXPECT_EQ(first.get() + second.get(), 3);
     
     std::this_thread::sleep_for(std::chrono::milliseconds(50));
-    shouldRun = false;
-    pool.stop();
+    EXPECT_EQ(pool.serviceCount(), 1u);
+    pool.stopServices();
+    EXPECT_EQ(pool.serviceCount(), 0u);
     
-    EXPECT_GT(firstTaskCount.load(), 0);
-    EXPECT_GT(secondTaskCount.load(), 0);
+    EXPECT_GT(serviceCount.load(), 0);
+    EXPECT_EQ(pool.submit([]() { return 3; }).get(), 3);
 }
 
 TEST(ThreadPoolTest, StressTest) {
@@ -178,20 +170,20 @@ TEST(ThreadPoolTest, StressTest) {
     ThreadPool pool(numThreads);
     
     std::atomic<uint64_t> operationCount{0};
-    std::atomic<bool> shouldRun{true};
-    
-    pool.setTask([&]() {
-        while (shouldRun.load(std::memory_order_relaxed)) {
-            operationCount.fetch_add(1, std::memory_order_relaxed);
-            volatile int x = 0;
-            for (int i = 0; i < 100; ++i) {
-                x += i;
+    
+    for (size_t i = 0; i < numThreads; ++i) {
+        pool.startService([&](std::stop_token stop) {
+            while (!stop.stop_requested()) {
+                operationCount.fetch_add(1, std::memory_order_relaxed);
+                volatile int x = 0;
+                for (int i = 0; i < 100; ++i) {
+                    x += i;
+                }
             }
-        }
-    });
+        });
+    }
     
     std::this_thread::sleep_for(std::chrono::milliseconds(500));
-    shouldRun = false;
     pool.stop();
     
     EXPECT_GT(operationCount.load(), 1000);
@@ -202,7 +194,12 @@ TEST(ThreadPoolTest, RapidStartStop) {
         ThreadPool pool(4);
         std::atomic<int> counter{0};
         
-        pool.setTask([&counter]() {
+        pool.startService([&counter](std::stop_token stop) {
+            while (!stop.stop_requested()) {
+                counter.fetch_add(1);
+            }
+        });
+        pool.enqueue([&counter]() {
             counter.fetch_add(1);
         });
         
@@ -228,21 +225,244 @@ TEST(ThreadPoolTest, LargeNumberOfThreads) {
     ThreadPool pool(numThreads);
     
     std::atomic<int> counter{0};
-    std::atomic<bool> shouldRun{true};
     
-    pool.setTask([&]() {
-        if (shouldRun.load()) {
+    for (int i = 0; i < 64; ++i) {
+        pool.enqueue([&]() {
             counter.fetch_add(1);
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
-    });
+        });
+    }
     
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    shouldRun = false;
     pool.stop();
     
     EXPECT_GT(counter.load(), 0);
 }
 
+TEST(ThreadPoolTest, SubmitReturnsFuture) {
+    ThreadPool pool(2);
+    
+    auto answer = pool.submit([](int a, int b) { return a * b; }, 6, 7);
+    auto text = pool.submit([]() { return std::string("done"); });
+    
+    EXPECT_EQ(answer.get(), 42);
+    EXPECT_EQ(text.get(), "done");
+}
+
+TEST(ThreadPoolTest, SubmitPropagatesException) {
+    ThreadPool pool(2);
+    
+    auto future = pool.submit([]() -> int { throw std::runtime_error("boom"); });
+    
+    EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, SubmitLargeCallable) {
+    ThreadPool pool(2);
+    std::array<char, 256> big{};
+    big[255] = 'x';
+    
+    auto future = pool.submit([big]() { return big[255]; });
+    
+    EXPECT_EQ(future.get(), 'x');
+}
+
+TEST(ThreadPoolTest, ManySmallTasks) {
+    ThreadPool pool(4);
+    std::atomic<int> counter{0};
+    const int numTasks = 100000;
+    
+    std::vector<std::future<void>> futures;
+    futures.reserve(numTasks);
+    for (int i = 0; i < numTasks; ++i) {
+        futures.push_back(pool.submit([&counter]() {
+            counter.fetch_add(1, std::memory_order_relaxed);
+        }));
+    }
+    for (auto& f : futures) f.get();
+    
+    EXPECT_EQ(counter.load(), numTasks);
+}
+
+TEST(ThreadPoolTest, ExternalSubmitterReusesRecycledNodes) {
+    ThreadPool pool(2);
+    
+    for (int wave = 0; wave < 20; ++wave) {
+        std::vector<std::future<void>> futures;
+        for (int i = 0; i < 500; ++i) {
+            futures.push_back(pool.submit([]() {}));
+        }
+        for (auto& f : futures) f.get();
+    }
+    
+    // Nodes recycled on the workers come back to this (non-worker) thread
+    // through the shared freelist instead of staying in the workers' caches
+    EXPECT_GT(detail::taskNodeCache().nodes.size() + detail::sharedTaskNodes().nodes.size(), 0u);
+}
+
+TEST(ThreadPoolTest, TasksSpawnedFromWorkersAreStolen) {
+    ThreadPool pool(4);
+    std::set<std::thread::id> threadIds;
+    std::mutex idMutex;
+    
+    auto root = pool.submit([&]() {
+        std::vector<std::future<void>> children;
+        for (int i = 0; i < 64; ++i) {
+            children.push_back(pool.submit([&]() {
+                {
+                    std::lock_guard<std::mutex> lock(idMutex);
+                    threadIds.insert(std::this_thread::get_id());
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }));
+        }
+        // Children landed on this worker's deque; other workers steal them
+        for (auto& c : children) c.wait();
+    });
+    root.get();
+    
+    EXPECT_GT(threadIds.size(), 1u);
+}
+
+TEST(ThreadPoolTest, ParallelForCoversRange) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> hits(10007);
+    
+    pool.parallel_for(0, hits.size(), [&](size_t i) {
+        hits[i].fetch_add(1, std::memory_order_relaxed);
+    });
+    
+    for (const auto& h : hits) {
+        EXPECT_EQ(h.load(), 1);
+    }
+}
+
+TEST(ThreadPoolTest, ParallelForPropagatesException) {
+    ThreadPool pool(4);
+    
+    EXPECT_THROW(pool.parallel_for(0, 1000, [](size_t i) {
+        if (i == 500) throw std::runtime_error("chunk failed");
+    }), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, ParallelReduceSum) {
+    ThreadPool pool(4);
+    
+    long long sum = pool.parallel_reduce(0, 100000, 0LL,
+        [](size_t i) { return static_cast<long long>(i); },
+        [](long long a, long long b) { return a + b; });
+    
+    EXPECT_EQ(sum, 100000LL * 99999 / 2);
+}
+
+TEST(ThreadPoolTest, ParallelReduceKeepsOrder) {
+    ThreadPool pool(4);
+    
+    std::string joined = pool.parallel_reduce(0, 26, std::string(),
+        [](size_t i) { return std::string(1, static_cast<char>('a' + i)); },
+        [](std::string a, const std::string& b) { return a + b; }, 3);
+    
+    EXPECT_EQ(joined, "abcdefghijklmnopqrstuvwxyz");
+}
+
+TEST(ThreadPoolTest, NestedParallelFor) {
+    ThreadPool pool(4);
+    std::atomic<int> counter{0};
+    
+    pool.parallel_for(0, 8, [&](size_t) {
+        pool.parallel_for(0, 100, [&](size_t) {
+            counter.fetch_add(1, std::memory_order_relaxed);
+        });
+    });
+    
+    EXPECT_EQ(counter.load(), 800);
+}
+
+TEST(ThreadPoolTest, StopDropsPendingTasks) {
+    std::future<int> pending;
+    {
+        ThreadPool pool(1);
+        std::promise<void> release;
+        auto gate = release.get_future().share();
+        pool.enqueue([gate]() { gate.wait(); });
+        pending = pool.submit([]() { return 1; });
+        
+        std::thread releaser([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            release.set_value();
+        });
+        pool.stop();
+        releaser.join();
+    }
+    
+    EXPECT_THROW(pending.get(), std::future_error);
+}
+
+TEST(ThreadPoolTest, StopCallbackUnblocksService) {
+    ThreadPool pool(1);
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool woken = false;
+    
+    pool.startService([&](std::stop_token stop) {
+        std::stop_callback onStop(stop, [&]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            woken = true;
+            cv.notify_all();
+        });
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return woken; });
+    });
+    
+    auto start = std::chrono::steady_clock::now();
+    pool.stop();
+    
+    EXPECT_TRUE(woken);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+TEST(ThreadPoolTest, ServicePinnedToCpu) {
+    ThreadPool pool(1);
+    std::promise<int> cpuSeen;
+    auto seen = cpuSeen.get_future();
+    
+    pool.startService([&](std::stop_token) {
+#if defined(__linux__)
+        cpuSeen.set_value(sched_getcpu());
+#else
+        cpuSeen.set_value(0);
+#endif
+    }, ServiceOptions{0});
+    
+    EXPECT_EQ(seen.get(), 0);
+}
+
+TEST(ThreadPoolTest, CpusBySocketListsEveryAllowedCpuHomeSocketFirst) {
+    auto allowed = allowedCpus();
+    ASSERT_FALSE(allowed.empty());
+    auto cpus = cpusBySocket();
+    ASSERT_EQ(cpus.size(), allowed.size());
+    EXPECT_EQ(cpus.front(), allowed.front());
+    
+    std::set<unsigned> distinct(cpus.begin(), cpus.end());
+    EXPECT_EQ(distinct, std::set<unsigned>(allowed.begin(), allowed.end()));
+    
+    // Every listed CPU accepts a pinned thread
+    for (unsigned cpu : cpus) {
+        bool pinned = false;
+        std::thread([&]() { pinned = pinCurrentThread(cpu); }).join();
+        EXPECT_TRUE(pinned) << "cpu " << cpu;
+    }
+    
+    // Once another socket starts, the home socket does not come back
+    int home = cpuSocket(cpus.front());
+    bool left = false;
+    for (unsigned cpu : cpus) {
+        bool atHome = cpuSocket(cpu) == home;
+        EXPECT_FALSE(left && atHome);
+        left = left || !atHome;
+    }
+}
+
 } 
 } 